@@ -17,6 +17,7 @@ extern SPISettings _fastSPI;
 #define RESP_MSG_RESP_TX_TS_IDX 14
 #define RESP_MSG_TS_LEN 4
 #define POLL_RX_TO_RESP_TX_DLY_UUS 450
+#define REPORT_PERIOD_MS 1000 /* Statistics are printed this often. */
 
 /* Default communication configuration. We use default non-STS DW mode. */
 static dwt_config_t config = {
@@ -60,12 +61,34 @@ static uint8_t rx_poll_msg[] = {0x41, 0x88, 0, 0xCA, 0xDE, 'W', 'A', 'V', 'E', 0
 static uint8_t tx_resp_msg[] = {0x41, 0x88, 0, 0xCA, 0xDE, 'V', 'E', 'W', 'A', 0xE1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 static uint8_t frame_seq_nb = 0;
 static uint8_t rx_buffer[20];
-static uint32_t status_reg = 0;
 static uint64_t poll_rx_ts;
 static uint64_t resp_tx_ts;
 
 extern dwt_txconfig_t txconfig_options;
 
+/* The radio is only serviced by the loop task: dwt_isr() talks SPI, so the GPIO ISR just wakes the task up. */
+static TaskHandle_t loop_task = NULL;
+
+static uint32_t responses = 0;
+static uint32_t late_responses = 0; /* Polls whose reply time had passed when dwt_starttx() was called. */
+static uint32_t rx_errors = 0;
+static uint32_t last_report_ms = 0;
+
+static void IRAM_ATTR dw_irq_isr()
+{
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(loop_task, &woken);
+  if (woken)
+  {
+    portYIELD_FROM_ISR();
+  }
+}
+
+static void tx_done_cb(const dwt_cb_data_t *cb_data);
+static void rx_ok_cb(const dwt_cb_data_t *cb_data);
+static void rx_to_cb(const dwt_cb_data_t *cb_data);
+static void rx_err_cb(const dwt_cb_data_t *cb_data);
+
 void setup()
 {
   // UART_init();
@@ -120,81 +143,108 @@ void setup()
    * Note, in real low power applications the LEDs should not be used. */
   dwt_setlnapamode(DWT_LNA_ENABLE | DWT_PA_ENABLE);
 
+  /* Let dwt_isr() dispatch the events to the handlers below and raise the IRQ line for them.
+   * The enable bits are at the same positions as the status bits, so the SYS_STATUS masks select the RX timeouts and errors. */
+  dwt_setcallbacks(&tx_done_cb, &rx_ok_cb, &rx_to_cb, &rx_err_cb, NULL, NULL);
+  dwt_setinterrupt(SYS_ENABLE_LO_TXFRS_ENABLE_BIT_MASK | SYS_ENABLE_LO_RXFCG_ENABLE_BIT_MASK | SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR, 0, DWT_ENABLE_INT_ONLY);
+
+  /* setup() and loop() run in the same task, the one the ISR wakes up. */
+  loop_task = xTaskGetCurrentTaskHandle();
+  pinMode(PIN_IRQ, INPUT);
+  attachInterrupt(digitalPinToInterrupt(PIN_IRQ), dw_irq_isr, RISING);
+
+  /* Activate reception immediately, the handlers turn the receiver back on after every frame. */
+  dwt_rxenable(DWT_START_RX_IMMEDIATE);
+
   Serial.println("Range TX");
   Serial.println("Setup over........");
 }
 
 void loop()
 {
-  /* Activate reception immediately. */
-  dwt_rxenable(DWT_START_RX_IMMEDIATE);
+  /* Sleep until the DW IC raises its IRQ line or the statistics are due. */
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(REPORT_PERIOD_MS));
+
+  /* The line stays high while an enabled event is set, dwt_isr() clears one event per call and calls its handler. */
+  while (digitalRead(PIN_IRQ) == HIGH)
+  {
+    dwt_isr();
+  }
 
-  /* Poll for reception of a frame or error/timeout. See NOTE 6 below. */
-  while (!((status_reg = dwt_read32bitreg(SYS_STATUS_ID)) & (SYS_STATUS_RXFCG_BIT_MASK | SYS_STATUS_ALL_RX_ERR)))
+  if (millis() - last_report_ms >= REPORT_PERIOD_MS)
+  {
+    last_report_ms = millis();
+    Serial.printf("responses/s: %u late: %u errors: %u\r\n", responses, late_responses, rx_errors);
+    responses = late_responses = rx_errors = 0;
+  }
+}
+
+static void rx_ok_cb(const dwt_cb_data_t *cb_data)
+{
+  /* A frame has been received, read it into the local buffer. */
+  if (cb_data->datalength > sizeof(rx_buffer))
   {
-  };
+    dwt_rxenable(DWT_START_RX_IMMEDIATE);
+    return;
+  }
+  dwt_readrxdata(rx_buffer, cb_data->datalength, 0);
 
-  if (status_reg & SYS_STATUS_RXFCG_BIT_MASK)
+  /* Check that the frame is a poll sent by "SS TWR initiator" example.
+   * As the sequence number field of the frame is not relevant, it is cleared to simplify the validation of the frame. */
+  rx_buffer[ALL_MSG_SN_IDX] = 0;
+  if (memcmp(rx_buffer, rx_poll_msg, ALL_MSG_COMMON_LEN) != 0)
   {
-    uint32_t frame_len;
-
-    /* Clear good RX frame event in the DW IC status register. */
-    dwt_write32bitreg(SYS_STATUS_ID, SYS_STATUS_RXFCG_BIT_MASK);
-
-    /* A frame has been received, read it into the local buffer. */
-    frame_len = dwt_read32bitreg(RX_FINFO_ID) & RXFLEN_MASK;
-    if (frame_len <= sizeof(rx_buffer))
-    {
-      dwt_readrxdata(rx_buffer, frame_len, 0);
-
-      /* Check that the frame is a poll sent by "SS TWR initiator" example.
-       * As the sequence number field of the frame is not relevant, it is cleared to simplify the validation of the frame. */
-      rx_buffer[ALL_MSG_SN_IDX] = 0;
-      if (memcmp(rx_buffer, rx_poll_msg, ALL_MSG_COMMON_LEN) == 0)
-      {
-        uint32_t resp_tx_time;
-        int ret;
-
-        /* Retrieve poll reception timestamp. */
-        poll_rx_ts = get_rx_timestamp_u64();
-
-        /* Compute response message transmission time. See NOTE 7 below. */
-        resp_tx_time = (poll_rx_ts + (POLL_RX_TO_RESP_TX_DLY_UUS * UUS_TO_DWT_TIME)) >> 8;
-        dwt_setdelayedtrxtime(resp_tx_time);
-
-        /* Response TX timestamp is the transmission time we programmed plus the antenna delay. */
-        resp_tx_ts = (((uint64_t)(resp_tx_time & 0xFFFFFFFEUL)) << 8) + TX_ANT_DLY;
-
-        /* Write all timestamps in the final message. See NOTE 8 below. */
-        resp_msg_set_ts(&tx_resp_msg[RESP_MSG_POLL_RX_TS_IDX], poll_rx_ts);
-        resp_msg_set_ts(&tx_resp_msg[RESP_MSG_RESP_TX_TS_IDX], resp_tx_ts);
-
-        /* Write and send the response message. See NOTE 9 below. */
-        tx_resp_msg[ALL_MSG_SN_IDX] = frame_seq_nb;
-        dwt_writetxdata(sizeof(tx_resp_msg), tx_resp_msg, 0); /* Zero offset in TX buffer. */
-        dwt_writetxfctrl(sizeof(tx_resp_msg), 0, 1);          /* Zero offset in TX buffer, ranging. */
-        ret = dwt_starttx(DWT_START_TX_DELAYED);
-
-        /* If dwt_starttx() returns an error, abandon this ranging exchange and proceed to the next one. See NOTE 10 below. */
-        if (ret == DWT_SUCCESS)
-        {
-          /* Poll DW IC until TX frame sent event set. See NOTE 6 below. */
-          while (!(dwt_read32bitreg(SYS_STATUS_ID) & SYS_STATUS_TXFRS_BIT_MASK))
-          {
-          };
-
-          /* Clear TXFRS event. */
-          dwt_write32bitreg(SYS_STATUS_ID, SYS_STATUS_TXFRS_BIT_MASK);
-
-          /* Increment frame sequence number after transmission of the poll message (modulo 256). */
-          frame_seq_nb++;
-        }
-      }
-    }
+    dwt_rxenable(DWT_START_RX_IMMEDIATE);
+    return;
   }
-  else
+
+  uint32_t resp_tx_time;
+
+  /* Retrieve poll reception timestamp. */
+  poll_rx_ts = get_rx_timestamp_u64();
+
+  /* Compute response message transmission time. */
+  resp_tx_time = (poll_rx_ts + (POLL_RX_TO_RESP_TX_DLY_UUS * UUS_TO_DWT_TIME)) >> 8;
+  dwt_setdelayedtrxtime(resp_tx_time);
+
+  /* Response TX timestamp is the transmission time we programmed plus the antenna delay. */
+  resp_tx_ts = (((uint64_t)(resp_tx_time & 0xFFFFFFFEUL)) << 8) + TX_ANT_DLY;
+
+  /* Write all timestamps in the final message. */
+  resp_msg_set_ts(&tx_resp_msg[RESP_MSG_POLL_RX_TS_IDX], poll_rx_ts);
+  resp_msg_set_ts(&tx_resp_msg[RESP_MSG_RESP_TX_TS_IDX], resp_tx_ts);
+
+  /* Write and send the response message. */
+  tx_resp_msg[ALL_MSG_SN_IDX] = frame_seq_nb;
+  dwt_writetxdata(sizeof(tx_resp_msg), tx_resp_msg, 0); /* Zero offset in TX buffer. */
+  dwt_writetxfctrl(sizeof(tx_resp_msg), 0, 1);          /* Zero offset in TX buffer, ranging. */
+
+  /* If dwt_starttx() returns an error the reply time has passed, abandon this ranging exchange and wait for the next poll.
+   * Otherwise tx_done_cb() turns the receiver back on once the response is out. */
+  if (dwt_starttx(DWT_START_TX_DELAYED) != DWT_SUCCESS)
   {
-    /* Clear RX error events in the DW IC status register. */
-    dwt_write32bitreg(SYS_STATUS_ID, SYS_STATUS_ALL_RX_ERR);
+    late_responses++;
+    dwt_rxenable(DWT_START_RX_IMMEDIATE);
   }
-}
\ No newline at end of file
+}
+
+static void tx_done_cb(const dwt_cb_data_t *cb_data)
+{
+  /* Increment frame sequence number after transmission of the response message (modulo 256). */
+  frame_seq_nb++;
+  responses++;
+  dwt_rxenable(DWT_START_RX_IMMEDIATE);
+}
+
+/* No RX timeout is set, but a preamble timeout would end up here as well. */
+static void rx_to_cb(const dwt_cb_data_t *cb_data)
+{
+  dwt_rxenable(DWT_START_RX_IMMEDIATE);
+}
+
+/* PHR, CRC, SFD or Reed-Solomon error, the receiver is off. */
+static void rx_err_cb(const dwt_cb_data_t *cb_data)
+{
+  rx_errors++;
+  dwt_rxenable(DWT_START_RX_IMMEDIATE);
+}
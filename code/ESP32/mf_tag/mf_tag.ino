@@ -1,11 +1,13 @@
 #include "dw3000.h"
 #include "SPI.h"
+#include "esp_timer.h"
 
 #define PIN_RST 17
 #define PIN_IRQ 2
 #define PIN_SS 5
 
-#define RNG_DELAY_MS 200
+#define RNG_PERIOD_US 1500    /* Time between two polls. An exchange takes about 1.1 ms: poll, 450 us reply delay, response. */
+#define REPORT_PERIOD_MS 1000 /* Ranging statistics are printed this often instead of every distance, the UART is slower than the radio. */
 #define TX_ANT_DLY 16385
 #define RX_ANT_DLY 16385
 #define ALL_MSG_COMMON_LEN 10
@@ -68,11 +70,44 @@ static uint8_t tx_poll_msg[] = {0x41, 0x88, 0, 0xCA, 0xDE, 'W', 'A', 'V', 'E', 0
 static uint8_t rx_resp_msg[] = {0x41, 0x88, 0, 0xCA, 0xDE, 'V', 'E', 'W', 'A', 0xE1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 static uint8_t frame_seq_nb = 0;
 static uint8_t rx_buffer[20];
-static uint32_t status_reg = 0;
 static double tof;
 static double distance;
 extern dwt_txconfig_t txconfig_options;
 
+/* The radio is only serviced by the loop task: dwt_isr() talks SPI, so the GPIO ISR and the timer just wake the task up. */
+static TaskHandle_t loop_task = NULL;
+static esp_timer_handle_t poll_timer = NULL;
+static volatile bool poll_due = false;
+static bool exchange_pending = false; /* Poll sent, waiting for the response or its timeout. */
+
+static uint32_t ranges = 0;
+static uint32_t rx_timeouts = 0;
+static uint32_t rx_errors = 0;
+static uint32_t overruns = 0; /* Polls the schedule skipped because the previous exchange had not ended yet. */
+static uint32_t last_report_ms = 0;
+
+static void IRAM_ATTR dw_irq_isr()
+{
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(loop_task, &woken);
+  if (woken)
+  {
+    portYIELD_FROM_ISR();
+  }
+}
+
+static void poll_timer_cb(void *arg)
+{
+  poll_due = true;
+  xTaskNotifyGive(loop_task);
+}
+
+static void tx_done_cb(const dwt_cb_data_t *cb_data);
+static void rx_ok_cb(const dwt_cb_data_t *cb_data);
+static void rx_to_cb(const dwt_cb_data_t *cb_data);
+static void rx_err_cb(const dwt_cb_data_t *cb_data);
+static void send_poll();
+
 void setup()
 {
   // UART_init();
@@ -128,83 +163,138 @@ void setup()
    * Note, in real low power applications the LEDs should not be used. */
   dwt_setlnapamode(DWT_LNA_ENABLE | DWT_PA_ENABLE);
 
+  /* Let dwt_isr() dispatch the events to the handlers below and raise the IRQ line for them.
+   * The enable bits are at the same positions as the status bits, so the SYS_STATUS masks select the RX timeouts and errors. */
+  dwt_setcallbacks(&tx_done_cb, &rx_ok_cb, &rx_to_cb, &rx_err_cb, NULL, NULL);
+  dwt_setinterrupt(SYS_ENABLE_LO_TXFRS_ENABLE_BIT_MASK | SYS_ENABLE_LO_RXFCG_ENABLE_BIT_MASK | SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR, 0, DWT_ENABLE_INT_ONLY);
+
+  /* setup() and loop() run in the same task, the one the ISR and the timer wake up. */
+  loop_task = xTaskGetCurrentTaskHandle();
+  pinMode(PIN_IRQ, INPUT);
+  attachInterrupt(digitalPinToInterrupt(PIN_IRQ), dw_irq_isr, RISING);
+
+  /* Polls go out on a fixed schedule, independent of how long the loop takes for the rest. */
+  const esp_timer_create_args_t poll_timer_args = {
+      .callback = &poll_timer_cb,
+      .arg = NULL,
+      .dispatch_method = ESP_TIMER_TASK,
+      .name = "poll"};
+  esp_timer_create(&poll_timer_args, &poll_timer);
+  esp_timer_start_periodic(poll_timer, RNG_PERIOD_US);
+
   Serial.println("Range RX");
   Serial.println("Setup over........");
 }
 
 void loop()
 {
-  /* Write frame data to DW IC and prepare transmission. See NOTE 7 below. */
+  /* Sleep until the DW IC raises its IRQ line, the next poll is due or the statistics are. */
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(REPORT_PERIOD_MS));
+
+  /* The line stays high while an enabled event is set, dwt_isr() clears one event per call and calls its handler. */
+  while (digitalRead(PIN_IRQ) == HIGH)
+  {
+    dwt_isr();
+  }
+
+  if (poll_due)
+  {
+    poll_due = false;
+    if (exchange_pending)
+    {
+      overruns++;
+    }
+    else
+    {
+      send_poll();
+    }
+  }
+
+  if (millis() - last_report_ms >= REPORT_PERIOD_MS)
+  {
+    last_report_ms = millis();
+    snprintf(dist_str, sizeof(dist_str), "DIST: %3.2f m", distance);
+    Serial.printf("%s ranges/s: %u timeouts: %u errors: %u overruns: %u\r\n", dist_str, ranges, rx_timeouts, rx_errors, overruns);
+    ranges = rx_timeouts = rx_errors = overruns = 0;
+  }
+}
+
+static void send_poll()
+{
+  /* Write frame data to DW IC and prepare transmission. */
   tx_poll_msg[ALL_MSG_SN_IDX] = frame_seq_nb;
-  dwt_write32bitreg(SYS_STATUS_ID, SYS_STATUS_TXFRS_BIT_MASK);
   dwt_writetxdata(sizeof(tx_poll_msg), tx_poll_msg, 0); /* Zero offset in TX buffer. */
   dwt_writetxfctrl(sizeof(tx_poll_msg), 0, 1);          /* Zero offset in TX buffer, ranging. */
 
   /* Start transmission, indicating that a response is expected so that reception is enabled automatically after the frame is sent and the delay
-   * set by dwt_setrxaftertxdelay() has elapsed. */
-  dwt_starttx(DWT_START_TX_IMMEDIATE | DWT_RESPONSE_EXPECTED);
-
-  /* We assume that the transmission is achieved correctly, poll for reception of a frame or error/timeout. See NOTE 8 below. */
-  while (!((status_reg = dwt_read32bitreg(SYS_STATUS_ID)) & (SYS_STATUS_RXFCG_BIT_MASK | SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR)))
+   * set by dwt_setrxaftertxdelay() has elapsed. The exchange ends in rx_ok_cb(), rx_to_cb() or rx_err_cb(). */
+  if (dwt_starttx(DWT_START_TX_IMMEDIATE | DWT_RESPONSE_EXPECTED) == DWT_SUCCESS)
   {
-  };
+    exchange_pending = true;
+  }
+}
 
+/* The poll is on air. The receiver turns on by itself, the TX timestamp is read with the response. */
+static void tx_done_cb(const dwt_cb_data_t *cb_data)
+{
   /* Increment frame sequence number after transmission of the poll message (modulo 256). */
   frame_seq_nb++;
+}
 
-  if (status_reg & SYS_STATUS_RXFCG_BIT_MASK)
-  {
-    uint32_t frame_len;
-
-    /* Clear good RX frame event in the DW IC status register. */
-    dwt_write32bitreg(SYS_STATUS_ID, SYS_STATUS_RXFCG_BIT_MASK);
+static void rx_ok_cb(const dwt_cb_data_t *cb_data)
+{
+  exchange_pending = false;
 
-    /* A frame has been received, read it into the local buffer. */
-    frame_len = dwt_read32bitreg(RX_FINFO_ID) & RXFLEN_MASK;
-    if (frame_len <= sizeof(rx_buffer))
-    {
-      dwt_readrxdata(rx_buffer, frame_len, 0);
-
-      /* Check that the frame is the expected response from the companion "SS TWR responder" example.
-       * As the sequence number field of the frame is not relevant, it is cleared to simplify the validation of the frame. */
-      rx_buffer[ALL_MSG_SN_IDX] = 0;
-      if (memcmp(rx_buffer, rx_resp_msg, ALL_MSG_COMMON_LEN) == 0)
-      {
-        uint32_t poll_tx_ts, resp_rx_ts, poll_rx_ts, resp_tx_ts;
-        int32_t rtd_init, rtd_resp;
-        float clockOffsetRatio;
-
-        /* Retrieve poll transmission and response reception timestamps. See NOTE 9 below. */
-        poll_tx_ts = dwt_readtxtimestamplo32();
-        resp_rx_ts = dwt_readrxtimestamplo32();
-
-        /* Read carrier integrator value and calculate clock offset ratio. See NOTE 11 below. */
-        clockOffsetRatio = ((float)dwt_readclockoffset()) / (uint32_t)(1 << 26);
-
-        /* Get timestamps embedded in response message. */
-        resp_msg_get_ts(&rx_buffer[RESP_MSG_POLL_RX_TS_IDX], &poll_rx_ts);
-        resp_msg_get_ts(&rx_buffer[RESP_MSG_RESP_TX_TS_IDX], &resp_tx_ts);
-
-        /* Compute time of flight and distance, using clock offset ratio to correct for differing local and remote clock rates */
-        rtd_init = resp_rx_ts - poll_tx_ts;
-        rtd_resp = resp_tx_ts - poll_rx_ts;
-
-        tof = ((rtd_init - rtd_resp * (1 - clockOffsetRatio)) / 2.0) * DWT_TIME_UNITS;
-        distance = tof * SPEED_OF_LIGHT;
-
-        /* Display computed distance on LCD. */
-        snprintf(dist_str, sizeof(dist_str), "DIST: %3.2f m", distance);
-        Serial.printf(dist_str, sizeof(dist_str), "DIST: %3.2f m", distance);
-        test_run_info((unsigned char *)dist_str);
-      }
-    }
+  /* A frame has been received, read it into the local buffer. */
+  if (cb_data->datalength > sizeof(rx_buffer))
+  {
+    rx_errors++;
+    return;
   }
-  else
+  dwt_readrxdata(rx_buffer, cb_data->datalength, 0);
+
+  /* Check that the frame is the expected response from the companion "SS TWR responder" example.
+   * As the sequence number field of the frame is not relevant, it is cleared to simplify the validation of the frame. */
+  rx_buffer[ALL_MSG_SN_IDX] = 0;
+  if (memcmp(rx_buffer, rx_resp_msg, ALL_MSG_COMMON_LEN) != 0)
   {
-    /* Clear RX error/timeout events in the DW IC status register. */
-    dwt_write32bitreg(SYS_STATUS_ID, SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR);
+    return;
   }
 
-  /* Execute a delay between ranging exchanges. */
-  Sleep(RNG_DELAY_MS);
-}
\ No newline at end of file
+  uint32_t poll_tx_ts, resp_rx_ts, poll_rx_ts, resp_tx_ts;
+  int32_t rtd_init, rtd_resp;
+  float clockOffsetRatio;
+
+  /* Retrieve poll transmission and response reception timestamps. */
+  poll_tx_ts = dwt_readtxtimestamplo32();
+  resp_rx_ts = dwt_readrxtimestamplo32();
+
+  /* Read carrier integrator value and calculate clock offset ratio. */
+  clockOffsetRatio = ((float)dwt_readclockoffset()) / (uint32_t)(1 << 26);
+
+  /* Get timestamps embedded in response message. */
+  resp_msg_get_ts(&rx_buffer[RESP_MSG_POLL_RX_TS_IDX], &poll_rx_ts);
+  resp_msg_get_ts(&rx_buffer[RESP_MSG_RESP_TX_TS_IDX], &resp_tx_ts);
+
+  /* Compute time of flight and distance, using clock offset ratio to correct for differing local and remote clock rates */
+  rtd_init = resp_rx_ts - poll_tx_ts;
+  rtd_resp = resp_tx_ts - poll_rx_ts;
+
+  tof = ((rtd_init - rtd_resp * (1 - clockOffsetRatio)) / 2.0) * DWT_TIME_UNITS;
+  distance = tof * SPEED_OF_LIGHT;
+  ranges++;
+}
+
+/* No response within RESP_RX_TIMEOUT_UUS (or no preamble), the receiver is off again. */
+static void rx_to_cb(const dwt_cb_data_t *cb_data)
+{
+  exchange_pending = false;
+  rx_timeouts++;
+}
+
+/* PHR, CRC, SFD or Reed-Solomon error, the receiver is off again. */
+static void rx_err_cb(const dwt_cb_data_t *cb_data)
+{
+  exchange_pending = false;
+  rx_errors++;
+}
@@ -0,0 +1,146 @@
+# generates src/dw3000_regs.h: constexpr register descriptors (address, width, SPI headers) and field masks
+# usage: bash generate_register_descriptors.sh
+# source is src/dw3000_registers.h (the same register list registers_base_sub.csv was made from)
+#
+# width of a register: its _LEN, but never more than the distance to the next register in the same base,
+# unless listed in WIDTHS below (the SDK header gives 4 for a lot of registers that are shorter in the user manual)
+
+SCRIPT_DIR=$( cd -- "$( dirname -- "${BASH_SOURCE[0]}" )" &> /dev/null && pwd )
+
+IN="$SCRIPT_DIR/src/dw3000_registers.h"
+OUT="$SCRIPT_DIR/src/dw3000_regs.h"
+
+# widths in bytes from the DW3000 user manual
+WIDTHS="TX_ANTD=2 SOFT_RST=2 AON_DIG_CFG=3 AON_CTRL=1 AON_CFG=1 BIAS_CTRL=2 RF_TX_CTRL=1 \
+PLL_CFG=2 SAR_CTRL=1 SAR_STATUS=1 SAR_TEST=1 OTP_ADDR=2 OTP_CFG=2 PRE_TOC=2 RX_SFD_TOC=2 DRX_CAR_INT=3 DRX_DIAG3=3 \
+IP_TS=5 BUF0_IP_TS=5 BUF1_IP_TS=5 TX_TIME_HI=1 RX_BUFFER_0=1024 RX_BUFFER_1=1024 TX_BUFFER=1024 \
+ACC_MEM=6096"
+
+awk -v widths="$WIDTHS" '
+function hex(s,    v, i, c)
+{
+    s = tolower(s)
+    sub(/^0x/, "", s)
+    v = 0
+    for (i = 1; i <= length(s); i++)
+    {
+        c = index("0123456789abcdef", substr(s, i, 1))
+        if (c == 0)
+        {
+            break
+        }
+        v = v * 16 + c - 1
+    }
+    return v
+}
+BEGIN {
+    n = split(widths, w, " ")
+    for (i = 1; i <= n; i++)
+    {
+        split(w[i], kv, "=")
+        width[kv[1]] = kv[2]
+    }
+}
+$1 == "#define" && $2 ~ /_ID$/ && $3 ~ /^0x/ {
+    name = substr($2, 1, length($2) - 3)
+    if (!(name in id))
+    {
+        order[++count] = name
+    }
+    id[name] = hex($3)
+    next
+}
+$1 == "#define" && $2 ~ /_LEN$/ && $2 !~ /_BIT_LEN$/ {
+    len[substr($2, 1, length($2) - 4)] = $3
+    next
+}
+$1 == "#define" && $2 ~ /_BIT_MASK$/ {
+    fmask[substr($2, 1, length($2) - 9)] = hex($3)
+    next
+}
+$1 == "#define" && $2 ~ /_BIT_OFFSET$/ {
+    foffset[substr($2, 1, length($2) - 11)] = $3
+    next
+}
+END {
+    print "// generated by generate_register_descriptors.sh from dw3000_registers.h, do not edit"
+    print ""
+    print "#pragma once"
+    print ""
+    print "#include \"dw3000_register.h\""
+    print ""
+    print "namespace regs"
+    print "{"
+
+    for (i = 1; i <= count; i++)
+    {
+        name = order[i]
+        base = int(id[name] / 65536)
+        addr = id[name] % 65536
+
+        l = (name in len) ? len[name] : "4"
+        gsub(/[^0-9]/, "", l)
+        l = l + 0
+        for (j = 1; j <= count; j++)
+        {
+            other = id[order[j]]
+            if (int(other / 65536) == base && other % 65536 > addr && other % 65536 - addr < l)
+            {
+                l = other % 65536 - addr
+            }
+        }
+        if (name in width)
+        {
+            l = width[name]
+        }
+
+        printf "    constexpr DW3000Register %s(0x%02X, 0x%02X, %d);\n", name, base, addr, l
+        reglen[name] = l
+    }
+
+    print ""
+    print "    // fields"
+
+    for (f in fmask)
+    {
+        fields[++nfields] = f
+    }
+    # stable output: sort field names
+    for (i = 1; i <= nfields; i++)
+    {
+        for (j = i + 1; j <= nfields; j++)
+        {
+            if (fields[j] < fields[i])
+            {
+                t = fields[i]; fields[i] = fields[j]; fields[j] = t
+            }
+        }
+    }
+
+    for (i = 1; i <= nfields; i++)
+    {
+        f = fields[i]
+        # the register is the longest register name the field name starts with
+        owner = ""
+        for (j = 1; j <= count; j++)
+        {
+            r = order[j]
+            if (index(f, r "_") == 1 && length(r) > length(owner))
+            {
+                owner = r
+            }
+        }
+        if (owner == "" || f == owner || (reglen[owner] < 4 && fmask[f] >= 256 ^ reglen[owner]))
+        {
+            continue # not a field of a register we know, or outside of its exact width
+        }
+        off = foffset[f]
+        gsub(/[^0-9]/, "", off)
+        printf "    constexpr DW3000Field %s(%s, 0x%XUL, %d);\n", f, owner, fmask[f], off + 0
+    }
+
+    print "}"
+}
+' "$IN" > "$OUT"
+
+echo "Wrote $OUT"
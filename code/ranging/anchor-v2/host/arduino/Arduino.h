@@ -0,0 +1,190 @@
+#pragma once
+
+/*
+ Minimal Arduino core for the host build. Time comes from the simulation clock,
+ so millis()/delay() follow simulated time instead of wall clock time.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+
+#include "sim_clock.h"
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+
+inline void pinMode(uint8_t pin, uint8_t mode) {}
+inline void digitalWrite(uint8_t pin, uint8_t val) {}
+inline int digitalRead(uint8_t pin) { return sim::current->readPin ? sim::current->readPin(pin) : LOW; }
+
+inline unsigned long millis() { return (unsigned long)(sim::now() / 1000000000ULL); }
+inline unsigned long micros() { return (unsigned long)(sim::now() / 1000000ULL); }
+inline void delay(unsigned long ms) { sim::advance((uint64_t)ms * 1000000000ULL); }
+inline void delayMicroseconds(unsigned int us) { sim::advance((uint64_t)us * 1000000ULL); }
+
+/*
+ ESP of the host build: the cycle counter runs at 240 MHz of simulated time
+*/
+class EspClass
+{
+public:
+    uint32_t getCycleCount() { return (uint32_t)(sim::now() * 6 / 25000); }
+    uint32_t getCpuFreqMHz() { return 240; }
+};
+
+inline EspClass ESP;
+
+class String
+{
+public:
+    String() {}
+    String(const char *s) : str(s) {}
+    String(const std::string &s) : str(s) {}
+    String(char c) : str(1, c) {}
+    String(int val) : str(std::to_string(val)) {}
+    String(unsigned int val) : str(std::to_string(val)) {}
+    String(long val) : str(std::to_string(val)) {}
+    String(unsigned long val) : str(std::to_string(val)) {}
+    String(double val, unsigned int decimals = 2)
+    {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", decimals, val);
+        str = buf;
+    }
+
+    unsigned int length() const { return str.length(); }
+    const char *c_str() const { return str.c_str(); }
+
+    int indexOf(char c, unsigned int from = 0) const
+    {
+        size_t pos = str.find(c, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    String substring(unsigned int from) const { return from >= str.length() ? String() : String(str.substr(from)); }
+    String substring(unsigned int from, unsigned int to) const
+    {
+        if (from >= str.length())
+            return String();
+        return String(str.substr(from, to > from ? to - from : 0));
+    }
+    long toInt() const { return strtol(str.c_str(), NULL, 10); }
+    void trim()
+    {
+        size_t start = str.find_first_not_of(" \t\r\n");
+        size_t end = str.find_last_not_of(" \t\r\n");
+        str = start == std::string::npos ? "" : str.substr(start, end - start + 1);
+    }
+
+    String &operator+=(const String &other)
+    {
+        str += other.str;
+        return *this;
+    }
+    bool operator==(const char *other) const { return str == other; }
+    bool operator==(const String &other) const { return str == other.str; }
+    friend String operator+(const String &a, const String &b) { return String(a.str + b.str); }
+    friend String operator+(const char *a, const String &b) { return String(a + b.str); }
+
+private:
+    std::string str;
+};
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(const uint8_t *buf, size_t len) = 0;
+
+    size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+
+    size_t print(const char *s) { return write(s); }
+    size_t print(const String &s) { return write(s.c_str()); }
+    size_t print(char c) { return write((const uint8_t *)&c, 1); }
+    size_t print(int val, int base = DEC) { return print((long)val, base); }
+    size_t print(unsigned int val, int base = DEC) { return print((unsigned long)val, base); }
+    size_t print(long val, int base = DEC) { return base == DEC ? printf("%ld", val) : print((unsigned long)val, base); }
+    size_t print(unsigned long val, int base = DEC)
+    {
+        if (base == HEX)
+            return printf("%lX", val);
+        if (base == BIN)
+        {
+            char buf[65];
+            int i = 64;
+            buf[i] = 0;
+            do
+            {
+                buf[--i] = '0' + (val & 1);
+                val >>= 1;
+            } while (val);
+            return write(buf + i);
+        }
+        return printf("%lu", val);
+    }
+    size_t print(long long val) { return printf("%lld", val); }
+    size_t print(unsigned long long val) { return printf("%llu", val); }
+    size_t print(double val, int decimals = 2) { return printf("%.*f", decimals, val); }
+
+    template <typename T>
+    size_t println(T val)
+    {
+        size_t n = print(val);
+        return n + write("\n");
+    }
+    template <typename T>
+    size_t println(T val, int format)
+    {
+        size_t n = print(val, format);
+        return n + write("\n");
+    }
+    size_t println() { return write("\n"); }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        char buf[256];
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        if (len < 0)
+            return 0;
+        return write((const uint8_t *)buf, len < (int)sizeof(buf) ? len : sizeof(buf) - 1);
+    }
+};
+
+/*
+ Serial goes to stdout, but only while enabled (the simulation is quiet by default)
+*/
+class HostSerial : public Print
+{
+public:
+    bool enabled = false;
+
+    void begin(unsigned long baud) {}
+    void flush() { fflush(stdout); }
+
+    using Print::write;
+    size_t write(const uint8_t *buf, size_t len) override
+    {
+        if (this->enabled)
+            fwrite(buf, 1, len, stdout);
+        return len;
+    }
+};
+
+inline HostSerial Serial;
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Arduino.h"
+
+#include <map>
+#include <vector>
+
+/*
+ Preferences (NVS) of the host build: kept in memory for the lifetime of the process. All nodes share it, the sketches use different keys.
+*/
+class Preferences
+{
+public:
+    bool begin(const char *name, bool readOnly = false)
+    {
+        this->name = name;
+        return true;
+    }
+
+    void end() {}
+
+    size_t getBytes(const char *key, void *buf, size_t maxLen)
+    {
+        auto it = store().find(this->name + "/" + key);
+        if (it == store().end() || it->second.size() > maxLen)
+        {
+            return 0;
+        }
+        memcpy(buf, it->second.data(), it->second.size());
+        return it->second.size();
+    }
+
+    size_t putBytes(const char *key, const void *value, size_t len)
+    {
+        const uint8_t *bytes = (const uint8_t *)value;
+        store()[this->name + "/" + key] = std::vector<uint8_t>(bytes, bytes + len);
+        return len;
+    }
+
+private:
+    std::string name;
+
+    static std::map<std::string, std::vector<uint8_t>> &store()
+    {
+        static std::map<std::string, std::vector<uint8_t>> values;
+        return values;
+    }
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Arduino.h"
+
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+class SPISettings
+{
+public:
+    SPISettings() {}
+    SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) : clock(clock) {}
+
+    uint32_t clock = 1000000;
+};
+
+/*
+ SPIClass of the host build. There is no bus behind it: the simulation replaces the transport of the driver.
+*/
+class SPIClass
+{
+public:
+    SPIClass(uint8_t spi_bus = 0) {}
+
+    void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {}
+    void end() {}
+    void beginTransaction(SPISettings settings) {}
+    void endTransaction() {}
+    void setFrequency(uint32_t freq) {}
+
+    uint8_t transfer(uint8_t data) { return 0; }
+    void transferBytes(const uint8_t *data, uint8_t *out, uint32_t size)
+    {
+        if (out != NULL)
+            memset(out, 0, size);
+    }
+    void writeBytes(const uint8_t *data, uint32_t size) {}
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Arduino.h"
+
+#define WL_CONNECTED 3
+#define WL_DISCONNECTED 6
+
+/*
+ WiFi of the host build: never connects, the sketches run with USEWIFI false.
+*/
+class HostWiFi
+{
+public:
+    void begin(const char *ssid, const char *password) {}
+    int status() { return WL_DISCONNECTED; }
+    String localIP() { return String("0.0.0.0"); }
+};
+
+inline HostWiFi WiFi;
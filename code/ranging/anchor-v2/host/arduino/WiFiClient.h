@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Arduino.h"
+
+/*
+ WiFiClient of the host build: a command channel that is never connected and swallows everything written to it.
+*/
+class WiFiClient : public Print
+{
+public:
+    int connect(const char *host, uint16_t port) { return 0; }
+    uint8_t connected() { return 0; }
+    int available() { return 0; }
+    String readStringUntil(char terminator) { return String(); }
+
+    using Print::write;
+    size_t write(const uint8_t *buf, size_t len) override { return len; }
+};
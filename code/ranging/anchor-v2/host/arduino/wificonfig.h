@@ -0,0 +1,6 @@
+#pragma once
+
+// The host build never connects, these only have to exist
+const char *ssid = "sim";
+const char *password = "sim";
+const char *host = "127.0.0.1";
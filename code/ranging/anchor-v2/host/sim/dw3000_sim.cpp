@@ -0,0 +1,927 @@
+#include "dw3000_sim.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+namespace
+{
+    constexpr int NUM_BASES = 0x20;
+    constexpr int BASE_SIZE = 0x2000; // ACC_MEM (0x15) is the largest, 6096 bytes
+
+    constexpr uint32_t DEV_ID = 0xDECA0302;
+    constexpr uint64_t MASK_40 = 0xFFFFFFFFFFULL;
+
+    constexpr uint32_t SYS_CFG_SPI_CRC = 0x40;
+    constexpr uint32_t SYS_CFG_RXWTOE = 0x200;
+    constexpr uint32_t SYS_CFG_DIS_DRXB = 0x8;
+    constexpr uint32_t SYS_CFG_RXAUTR = 0x400;
+    constexpr uint32_t CLK_CTRL_ACC_CLKS = 0x8040; // ACC_CLK_EN, ACC_MCLK_EN
+
+    constexpr int CIR_SAMPLES = 1016;  // accumulator length at 64 MHz PRF
+    constexpr int CIR_FIRST_PATH = 743; // sample the first path of every frame lands on
+
+    constexpr uint32_t STATUS_CP_LOCK = 0x2;
+    constexpr uint32_t STATUS_SPICRCE = 0x4;
+    constexpr uint32_t STATUS_SPIRDY = 0x800000;
+    constexpr uint32_t STATUS_RCINIT = 0x1000000;
+    constexpr uint32_t STATUS_TX_DONE = 0xF0;  // TXFRB, TXPRS, TXPHS, TXFRS
+    constexpr uint32_t STATUS_RX_DONE = 0x6F00; // RXPRD, RXSFDD, CIADONE, RXPHD, RXFR, RXFCG
+    constexpr uint32_t STATUS_HPDWARN = 0x8000000;
+    constexpr uint32_t STATUS_RXSTO = 0x4000000;
+    constexpr uint32_t STATUS_RXFTO = 0x20000;
+    constexpr uint32_t STATUS_RXPTO = 0x200000;
+    constexpr uint32_t RDB_STATUS_DONE = 0x7; // RXFCG0, RXFR0, CIADONE0, shifted by 4 for buffer 1
+
+    constexpr double SYMBOL_PS = 1017630;                 // preamble symbol at 64 MHz PRF
+    constexpr uint64_t UUS_PS = 1025641;                  // unit of RX_FWTO and W4R_TIM: 512 / 499.2 MHz
+    constexpr uint64_t TX_STARTUP_PS = 5 * sim::US;       // fast command to first preamble symbol
+    constexpr uint64_t RESET_TO_IDLE_PS = 1 * sim::MS;    // reset to IDLE_RC, an assumption on the safe side
+    constexpr uint64_t WAKE_CS_PS = 500 * sim::US;        // CS low time that wakes the chip up
+    constexpr uint64_t WAKE_TO_IDLE_PS = 1 * sim::MS;     // DEEPSLEEP to IDLE_RC: the crystal starts up, as long as after a reset
+    constexpr double SPEED_OF_LIGHT_CM_PER_PS = 0.0299792458;
+
+    // OTP words the driver reads during init()
+    uint32_t otpWord(int addr)
+    {
+        switch (addr)
+        {
+        case 0x04: // LDO tune low
+            return 0x88888888;
+        case 0x05: // LDO tune high
+            return 0x00000888;
+        case 0x09: // SAR temperature at 22 degrees
+            return 0x0000008A;
+        case 0x0A: // bias tune
+            return 0x00130000;
+        case 0x1E: // crystal trim
+            return 0x0000002E;
+        default:
+            return 0;
+        }
+    }
+
+    int preambleSymbols(int txpsr)
+    {
+        switch (txpsr)
+        {
+        case 0x1:
+        case 0x8:
+            return 64;
+        case 0x2:
+            return 1024;
+        case 0x3:
+            return 4096;
+        case 0x4:
+            return 32;
+        case 0x5:
+            return 128;
+        case 0x6:
+            return 1536;
+        case 0x9:
+            return 256;
+        case 0xA:
+            return 2048;
+        case 0xB:
+        case 0xD:
+            return 512;
+        default:
+            return 64;
+        }
+    }
+}
+
+/*
+ #####  SimChip  #####
+*/
+
+SimChip::SimChip(sim::Clock &clock, SimAir &air) : clock(clock), air(air)
+{
+    reset();
+}
+
+void SimChip::reset()
+{
+    this->regs.assign(NUM_BASES, std::vector<uint8_t>(BASE_SIZE, 0));
+
+    set(0x00, 0x00, DEV_ID);
+    set(0x00, 0x10, 0x188);                         // SYS_CFG
+    set(0x00, 0x24, 0x140C);                        // TX_FCTRL: 12 bytes, 6.8 Mbps, 64 symbols
+    set(0x00, 0x44, 0);                             // SYS_STATUS: SPIRDY and RCINIT come with IDLE_RC (see update())
+    set(0x01, 0x04, 0);                             // TX_ANTD
+    set(0x0E, 0x00, PHYSICAL_ANTENNA_DELAY, 2);     // CIA_CONF: RX antenna delay, matches the simulated boards
+    set(0x0F, 0x30, 0x1 << 16);                     // SYS_STATE: INIT_RC
+    set(0x11, 0x00, 0xFFFF);                        // SOFT_RST
+
+    this->windows.clear();
+    this->rxBuffer = 0;
+    this->hostBuffer = 0;
+    this->bufferFull[0] = this->bufferFull[1] = false;
+    this->txPending = false;
+    this->pllLocked = false;
+    this->readyAt = this->clock.ps + RESET_TO_IDLE_PS;
+}
+
+void SimChip::poke(int base, int sub, const uint8_t *data, int len)
+{
+    int n = std::min<int>(len, BASE_SIZE - sub);
+    memcpy(reg(base, sub), data, n);
+}
+
+void SimChip::peek(int base, int sub, uint8_t *data, int len)
+{
+    int n = std::min<int>(len, BASE_SIZE - sub);
+    memcpy(data, reg(base, sub), n);
+}
+
+uint32_t SimChip::get(int base, int sub, int len)
+{
+    uint32_t val = 0;
+    for (int i = len - 1; i >= 0; i--)
+    {
+        val = (val << 8) | this->regs[base][sub + i];
+    }
+    return val;
+}
+
+void SimChip::set(int base, int sub, uint32_t val, int len)
+{
+    for (int i = 0; i < len; i++)
+    {
+        this->regs[base][sub + i] = (val >> i * 8) & 0xFF;
+    }
+}
+
+uint64_t SimChip::chipTicks(uint64_t globalPs)
+{
+    double local = (double)globalPs * (1.0 + crystalPpm() * 1e-6) + this->epochPs;
+    return (uint64_t)(local / TICK_PS) & MASK_40;
+}
+
+uint64_t SimChip::globalPs(uint64_t ticks)
+{
+    // the tick count is only 40 bits, pick the wrap closest to now
+    uint64_t nowTicks = chipTicks(this->clock.ps);
+    int64_t diff = (int64_t)((ticks - nowTicks) & MASK_40);
+    if (diff >= (int64_t)(1ULL << 39))
+    {
+        diff -= (int64_t)(1ULL << 40);
+    }
+    return this->clock.ps + (int64_t)(diff * TICK_PS / (1.0 + crystalPpm() * 1e-6));
+}
+
+void SimChip::transaction(const uint8_t *header, uint8_t headerLen, const uint8_t *tx, uint8_t *rx, uint16_t len, uint64_t csLowPs)
+{
+    update();
+
+    if (this->asleep)
+    {
+        // MISO stays low and nothing gets written, only a long enough CS assertion does something
+        if (rx != NULL)
+        {
+            memset(rx, 0, len);
+        }
+        if (csLowPs >= WAKE_CS_PS && (this->aon[0x0A][0x14] & 0x08)) // AON_CFG WAKE_CSN
+        {
+            wake();
+        }
+        return;
+    }
+
+    bool write = header[0] & 0x80;
+    bool fullAddress = header[0] & 0x40;
+
+    if (!fullAddress && (header[0] & 0x01))
+    {
+        fastCommand((header[0] >> 1) & 0x1F);
+        return;
+    }
+
+    int base = (header[0] >> 1) & 0x1F;
+    int sub = 0;
+    if (fullAddress && headerLen > 1)
+    {
+        sub = ((header[0] & 0x01) << 6) | (header[1] >> 2);
+    }
+
+    if (base == 0x1D || base == 0x1E)
+    {
+        // INDIRECT_PTR_A / INDIRECT_PTR_B: the access goes to INDIRECT_ADDR_x, starting at ADDR_OFFSET_x
+        int cfg = base == 0x1D ? 0x04 : 0x0C;
+        sub += get(0x1F, cfg + 4, 2) & 0x7FFF;
+        base = this->regs[0x1F][cfg] & 0x1F;
+        if (sub >= BASE_SIZE)
+        {
+            sub = BASE_SIZE - 1;
+        }
+    }
+
+    if (base == 0x00)
+    {
+        set(0x00, 0x1C, chipTicks(this->clock.ps) >> 8); // SYS_TIME
+    }
+
+    if (!write)
+    {
+        // the chip answers a read even if the host ignores MISO (a write whose header lost its write bit)
+        std::vector<uint8_t> out(len, 0);
+        if (base == 0x15)
+        {
+            // ACC_MEM: reads zeros unless the accumulator clocks are on, the first byte is a dummy
+            if ((get(0x11, 0x04) & CLK_CTRL_ACC_CLKS) == CLK_CTRL_ACC_CLKS && len > 1)
+            {
+                memcpy(out.data() + 1, reg(base, sub), std::min<int>(len - 1, BASE_SIZE - sub));
+            }
+        }
+        else
+        {
+            memcpy(out.data(), reg(base, sub), std::min<int>(len, BASE_SIZE - sub));
+        }
+        if (len > 0 && (base != 0x00 || sub != 0x18))
+        {
+            // SPI_RD_CRC: CRC of the last read, as it went out on the bus
+            this->regs[0x00][0x18] = DW3000Transport::crc8(out.data(), len, DW3000Transport::crc8(header, headerLen));
+        }
+        if (rx != NULL)
+        {
+            memcpy(rx, out.data(), len);
+        }
+        return;
+    }
+
+    if (this->regs[0x00][0x10] & SYS_CFG_SPI_CRC)
+    {
+        // the last byte of a write is its CRC, a write with a wrong one is dropped
+        if (len == 0 || tx[len - 1] != DW3000Transport::crc8(tx, len - 1, DW3000Transport::crc8(header, headerLen)))
+        {
+            this->regs[0x00][0x44] |= STATUS_SPICRCE;
+            return;
+        }
+        len--;
+    }
+
+    int n = std::min<int>(len, BASE_SIZE - sub);
+
+    for (int i = 0; i < n; i++)
+    {
+        int addr = sub + i;
+        if (base == 0x00 && addr < 0x04)
+        {
+            continue; // DEV_ID is read only
+        }
+        if ((base == 0x00 && addr >= 0x44 && addr < 0x4C) || (base == 0x01 && addr == 0x24))
+        {
+            this->regs[base][addr] &= ~tx[i]; // SYS_STATUS and RDB_STATUS: write 1 to clear
+        }
+        else
+        {
+            this->regs[base][addr] = tx[i];
+        }
+    }
+    afterWrite(base, sub, n);
+}
+
+bool SimChip::irq()
+{
+    if (this->asleep)
+    {
+        return false;
+    }
+    update();
+    return (get(0x00, 0x44) & get(0x00, 0x3C)) != 0;
+}
+
+/*
+ Applies everything that happened on the chip up to now: finished transmissions and frames that arrived
+*/
+void SimChip::update()
+{
+    uint64_t now = this->clock.ps;
+
+    if (this->readyAt && now >= this->readyAt)
+    {
+        this->readyAt = 0;
+        set(0x00, 0x44, get(0x00, 0x44) | STATUS_SPIRDY | STATUS_RCINIT);
+        set(0x0F, 0x30, 0x3 << 16); // SYS_STATE: IDLE_RC
+        if (this->lockOnReady)
+        {
+            this->lockOnReady = false;
+            this->pllLocked = true;
+            set(0x00, 0x44, get(0x00, 0x44) | STATUS_CP_LOCK);
+        }
+    }
+
+    if (this->txPending && now >= this->txEnd)
+    {
+        this->txPending = false;
+        set(0x00, 0x44, get(0x00, 0x44) | STATUS_TX_DONE);
+    }
+
+    // the receiver takes PRE_TOC and RX_FWTO when it turns on (after W4R_TIM), both count from then
+    if (!this->windows.empty() && !this->windows.back().timed && now >= this->windows.back().on)
+    {
+        Window &w = this->windows.back();
+        uint32_t preToc = get(0x06, 0x04, 2);
+        w.preambleBy = preToc != 0 ? w.on + preToc * pacPs() : UINT64_MAX;
+        w.frameBy = get(0x00, 0x10) & SYS_CFG_RXWTOE ? w.on + (get(0x00, 0x34) & 0xFFFFF) * UUS_PS : UINT64_MAX;
+        w.timed = true;
+    }
+
+    std::sort(this->incoming.begin(), this->incoming.end(), [](const Frame &a, const Frame &b)
+              { return a.end < b.end; });
+
+    while (!this->incoming.empty() && this->incoming.front().end <= now)
+    {
+        Frame frame = this->incoming.front();
+        this->incoming.erase(this->incoming.begin());
+
+        uint32_t chan = get(0x01, 0x14);
+        bool matching = tuned() && frame.channel == (chan & 0x1) && frame.sfd == ((chan >> 1) & 0x3) && frame.code == ((chan >> 8) & 0x1F);
+
+        bool heard = false;
+        for (Window &w : this->windows)
+        {
+            if (w.on <= frame.start && frame.end <= w.off && frame.start + pacPs() <= w.preambleBy && frame.end <= w.frameBy)
+            {
+                heard = true;
+                w.off = frame.end; // the receiver switches off after a frame
+                break;
+            }
+        }
+
+        // RX_SFD_TOC: the receiver gives up on a preamble that goes on for longer than it expects
+        uint32_t sfdTimeout = get(0x06, 0x02, 2);
+        bool sfdTimedOut = sfdTimeout != 0 && (int)sfdTimeout + pacSymbols() <= frame.preambleSymbols;
+
+        // too weak for the preamble length and data rate: shorter preambles and 6.8 Mb/s need more signal
+        double sensitivity = -94 - 5 * log10(frame.preambleSymbols / 128.0) - (frame.fastData ? 0 : 6);
+        bool detected = rxLevel(frame) >= sensitivity;
+
+        if (heard && matching && !detected)
+        {
+            this->framesMissed++;
+        }
+        else if (heard && matching && sfdTimedOut)
+        {
+            set(0x00, 0x44, get(0x00, 0x44) | STATUS_RXSTO);
+            this->framesMissed++;
+        }
+        else if (heard && matching && doubleBuffered() && this->bufferFull[this->rxBuffer])
+        {
+            this->framesMissed++; // both buffers still held by the host: overrun
+        }
+        else if (heard && matching)
+        {
+            deliver(frame);
+        }
+        else
+        {
+            this->framesMissed++;
+        }
+    }
+
+    // PRE_TOC and RX_FWTO: a receiver that is still waiting gives up at its deadline. A preamble that started
+    // early enough keeps the preamble timeout off, its frame still has to end before the frame wait timeout.
+    if (!this->windows.empty() && this->windows.back().off == UINT64_MAX)
+    {
+        Window &w = this->windows.back();
+        bool preamble = std::any_of(this->incoming.begin(), this->incoming.end(), [&](const Frame &frame)
+                                    { return w.on <= frame.start && frame.start + pacPs() <= w.preambleBy; });
+        if (!preamble && w.preambleBy <= std::min(now, w.frameBy))
+        {
+            w.off = w.preambleBy;
+            set(0x00, 0x44, get(0x00, 0x44) | STATUS_RXPTO);
+        }
+        else if (w.frameBy <= now)
+        {
+            w.off = w.frameBy;
+            set(0x00, 0x44, get(0x00, 0x44) | STATUS_RXFTO);
+        }
+    }
+
+    // only the last windows can still matter
+    while (this->windows.size() > 8)
+    {
+        this->windows.erase(this->windows.begin());
+    }
+}
+
+void SimChip::afterWrite(int base, int sub, int len)
+{
+    auto covers = [&](int b, int s)
+    { return base == b && sub <= s && s < sub + len; };
+
+    if (covers(0x11, 0x00) && this->regs[0x11][0] == 0x00) // SOFT_RST
+    {
+        reset();
+        return;
+    }
+
+    if (covers(0x0A, 0x04) && (this->regs[0x0A][0x04] & 0x02) && (this->regs[0x0A][0x14] & 0x01)) // AON_CTRL ARRAY_SAVE with AON_CFG SLEEP_EN
+    {
+        sleep();
+        return;
+    }
+
+    if (covers(0x11, 0x04) && (this->regs[0x11][0x04] & 0x03)) // CLK_CTRL: system clock forced off the PLL
+    {
+        this->pllLocked = false;
+    }
+
+    if (covers(0x11, 0x09) && (this->regs[0x11][0x09] & 0x01) && !(this->regs[0x11][0x04] & 0x03)) // SEQ_CTRL: AINIT2IDLE
+    {
+        this->pllLocked = true;
+        set(0x00, 0x44, get(0x00, 0x44) | STATUS_CP_LOCK);
+    }
+
+    if (covers(0x0B, 0x08) && (this->regs[0x0B][0x08] & 0x02)) // OTP_CFG: manual read
+    {
+        set(0x0B, 0x10, otpWord(get(0x0B, 0x04, 2) & 0x7FF));
+        this->regs[0x0B][0x08] &= ~0x02;
+    }
+
+    if (covers(0x04, 0x0C) && (this->regs[0x04][0x0C] & 0x10)) // RX_CAL: start calibration
+    {
+        set(0x04, 0x14, 0x00012345); // RX_CAL_RESI
+        set(0x04, 0x1C, 0x00012345); // RX_CAL_RESQ
+        set(0x04, 0x20, 0x1);        // RX_CAL_STS
+    }
+    else if (covers(0x04, 0x20)) // RX_CAL_STS: write 1 to clear
+    {
+        set(0x04, 0x20, 0x0);
+    }
+
+    if (covers(0x09, 0x14)) // XTAL: the crystal gets pulled, the local time stays continuous
+    {
+        double trimPpm = -((this->regs[0x09][0x14] & 0x3F) - 0x2E) * 0.8;
+        this->epochPs += (int64_t)llround((double)this->clock.ps * (this->trimPpm - trimPpm) * 1e-6);
+        this->trimPpm = trimPpm;
+    }
+
+    if (covers(0x08, 0x00)) // SAR_CTRL
+    {
+        if (this->regs[0x08][0x00] & 0x01)
+        {
+            int otpTemp = otpWord(0x09) & 0xFF;
+            int temp = otpTemp + (int)lround((this->temperature - 22.0) / 1.05);
+            set(0x08, 0x08, (temp & 0xFF) << 8 | 0xA0); // SAR_READING: temperature and battery voltage
+            set(0x08, 0x04, 0x1);                       // SAR_STATUS
+        }
+        else
+        {
+            set(0x08, 0x04, 0x0);
+        }
+    }
+}
+
+/*
+ Saves the configuration to the AON memory and goes to DEEPSLEEP (AON_CFG without WAKE_CNT): the radio stops, the clocks stop
+*/
+void SimChip::sleep()
+{
+    closeRX(this->clock.ps);
+    this->txPending = false;
+    this->pllLocked = false;
+    this->aon = this->regs;
+    this->asleep = true;
+    this->asleepAt = this->clock.ps;
+}
+
+/*
+ Wakes up from DEEPSLEEP like from a reset, with ONWAKE_AON_DLD the saved configuration comes back. What the AON memory does not keep
+ (LDO_RLOAD, BIAS_CTRL, RF_TX_CTRL_1, PLL_CAL, the DGC lookup table) stays at its reset value, the driver has to write it again.
+*/
+void SimChip::wake()
+{
+    this->asleep = false;
+    this->wakeups++;
+    this->sleptPs += this->clock.ps - this->asleepAt;
+
+    std::vector<std::vector<uint8_t>> saved = this->aon;
+    reset();
+
+    uint32_t onWake = saved[0x0A][0x00] | saved[0x0A][0x01] << 8; // AON_DIG_CFG
+    if (onWake & 0x001) // ONWAKE_AON_DLD
+    {
+        for (int base = 0; base < NUM_BASES; base++)
+        {
+            if (base == 0x12 || base == 0x13 || base == 0x15) // RX buffers and accumulator
+            {
+                continue;
+            }
+            this->regs[base] = saved[base];
+        }
+        set(0x00, 0x44, 0);                            // SYS_STATUS
+        set(0x00, 0x48, 0);
+        set(0x0F, 0x30, 0x1 << 16);                    // SYS_STATE: INIT_RC
+        set(0x0A, 0x04, 0, 1);                         // AON_CTRL
+        set(0x0A, 0x14, saved[0x0A][0x14] & ~0x01, 1); // AON_CFG: SLEEP_EN clears itself
+        set(0x07, 0x50, 0);                            // LDO_RLOAD
+        set(0x11, 0x1F, 0, 2);                         // BIAS_CTRL
+        set(0x07, 0x1A, 0, 1);                         // RF_TX_CTRL_1
+        set(0x09, 0x08, 0, 1);                         // PLL_CAL
+        memset(reg(0x03, 0x38), 0, 7 * 4);             // DGC_LUT_0 to DGC_LUT_6
+    }
+    this->lockOnReady = onWake & 0x100; // ONWAKE_GO2IDLE
+    this->readyAt = this->clock.ps + WAKE_TO_IDLE_PS;
+}
+
+void SimChip::fastCommand(int cmd)
+{
+    switch (cmd)
+    {
+    case 0x00: // TXRXOFF
+        closeRX(this->clock.ps);
+        break;
+    case 0x01: // TX
+        transmit(false, false);
+        break;
+    case 0x02: // RX
+        openRX(this->txPending ? this->txEnd : this->clock.ps);
+        break;
+    case 0x03: // DTX
+        transmit(true, false);
+        break;
+    case 0x0C: // TX_W4R
+        transmit(false, true);
+        break;
+    case 0x0D: // DTX_W4R
+        transmit(true, true);
+        break;
+    case 0x0F: // DTX_RS_W4R: delay relative to the last RX timestamp
+        transmit(true, true, get(0x00, 0x64) | (uint64_t)this->regs[0x00][0x68] << 32);
+        break;
+    case 0x12: // CLR_IRQS
+        set(0x00, 0x44, 0);
+        set(0x00, 0x48, 0, 2);
+        break;
+    case 0x13: // DB_TOGGLE: the host is done with its buffer
+        this->bufferFull[this->hostBuffer] = false;
+        this->hostBuffer ^= 1;
+        break;
+    default:
+        break;
+    }
+}
+
+/*
+ Preamble acquisition chunk of DTUNE0 PRE_PAC_SYM
+*/
+int SimChip::pacSymbols()
+{
+    const int pacs[4] = {8, 16, 32, 4};
+    return pacs[get(0x06, 0x00, 1) & 0x3];
+}
+
+uint64_t SimChip::pacPs()
+{
+    return (uint64_t)(pacSymbols() * SYMBOL_PS);
+}
+
+/*
+ Airtime of the preamble and SFD, from the start of the frame up to the RMARKER
+*/
+uint64_t SimChip::preamblePs()
+{
+    int symbols = preambleSymbols((get(0x00, 0x24) >> 12) & 0xF);
+    int sfdType = (get(0x01, 0x14) >> 1) & 0x3;
+    int sfdSymbols = sfdType == 2 ? 16 : 8;
+
+    return (uint64_t)((symbols + sfdSymbols) * SYMBOL_PS);
+}
+
+/*
+ Airtime of the PHR and the payload (including FCS), from the RMARKER up to the end of the frame
+*/
+uint64_t SimChip::payloadPs(int len)
+{
+    bool fastData = get(0x00, 0x24) & (1 << 10);
+    bool fastPhr = get(0x00, 0x10) & (1 << 5); // SYS_CFG PHR_6M8
+
+    double phrPs = 21 * 1e12 / (fastPhr ? 6.8e6 : 0.85e6);
+    double bits = len * 8 * (1.0 + 48.0 / 330.0); // Reed-Solomon parity
+    double dataPs = bits * 1e12 / (fastData ? 6.8e6 : 0.85e6);
+
+    return (uint64_t)(phrPs + dataPs);
+}
+
+void SimChip::transmit(bool delayed, bool thenRX, uint64_t reference)
+{
+    uint64_t now = this->clock.ps;
+    if (this->txPending)
+    {
+        return;
+    }
+
+    uint32_t fctrl = get(0x00, 0x24);
+    int len = fctrl & 0x3FF; // including FCS
+    int antd = get(0x01, 0x04, 2);
+
+    uint64_t start, rmarker;
+    uint64_t rmarkerTicks;
+    if (delayed)
+    {
+        uint64_t dx = (uint64_t)get(0x00, 0x2C) << 8;
+        rmarkerTicks = (reference + dx) & ~0x1FFULL & MASK_40;
+        rmarker = globalPs(rmarkerTicks);
+        start = rmarker - preamblePs();
+        if ((int64_t)(start - now) < (int64_t)TX_STARTUP_PS) // signed: a time in the past can lie before the start of the simulation
+        {
+            set(0x00, 0x44, get(0x00, 0x44) | STATUS_HPDWARN); // too late, the chip would wait for the next wrap
+            return;
+        }
+    }
+    else
+    {
+        start = now + TX_STARTUP_PS;
+        rmarker = start + preamblePs();
+        rmarkerTicks = chipTicks(rmarker);
+    }
+    uint64_t end = rmarker + payloadPs(len);
+
+    uint8_t ts[5];
+    uint64_t txStamp = (rmarkerTicks + antd) & MASK_40;
+    for (int i = 0; i < 5; i++)
+    {
+        ts[i] = (txStamp >> i * 8) & 0xFF;
+    }
+    memcpy(reg(0x00, 0x74), ts, 5); // TX_TIME
+
+    closeRX(now);
+    this->txPending = true;
+    this->txEnd = end;
+    this->framesSent++;
+
+    if (thenRX)
+    {
+        uint64_t w4r = (uint64_t)(get(0x01, 0x08) & 0xFFFFF) * UUS_PS;
+        openRX(end + w4r);
+    }
+
+    std::vector<uint8_t> data(reg(0x14, 0), reg(0x14, 0) + std::max(len - 2, 0));
+    uint64_t antenna = antennaDelayPs();
+    this->air.broadcast(this, data, start + antenna, rmarker + antenna, end + antenna);
+}
+
+void SimChip::openRX(uint64_t at)
+{
+    if (!this->windows.empty() && this->windows.back().off == UINT64_MAX)
+    {
+        return;
+    }
+    this->windows.push_back({at, UINT64_MAX, UINT64_MAX, UINT64_MAX, false});
+}
+
+void SimChip::closeRX(uint64_t at)
+{
+    if (this->windows.empty() || this->windows.back().off != UINT64_MAX)
+    {
+        return;
+    }
+    if (at <= this->windows.back().on)
+    {
+        this->windows.pop_back();
+        return;
+    }
+    this->windows.back().off = at;
+}
+
+/*
+ True unless SYS_CFG DIS_DRXB keeps the chip on RX_BUFFER_0
+*/
+bool SimChip::doubleBuffered()
+{
+    return !(get(0x00, 0x10) & SYS_CFG_DIS_DRXB);
+}
+
+/*
+ Fills RX buffer, RX frame info, timestamps, diagnostics and SYS_STATUS for a received frame.
+ Double buffered, the frame goes to the next buffer with its own RX_FINFO, IP_TS and RDB_STATUS, and RXAUTR turns the receiver on
+ again while the other buffer is free.
+*/
+void SimChip::deliver(const Frame &frame)
+{
+    int len = frame.data.size() + 2;
+    bool twoBuffers = doubleBuffered();
+    int buffer = twoBuffers ? this->rxBuffer : 0;
+
+    memset(reg(0x12 + buffer, 0), 0, 1024);
+    memcpy(reg(0x12 + buffer, 0), frame.data.data(), frame.data.size());
+    set(0x00, 0x4C, len & 0x3FF); // RX_FINFO
+
+    uint64_t antenna = antennaDelayPs();
+    int rxAntd = get(0x0E, 0x00, 2);
+    uint64_t rxStamp = (chipTicks(frame.rmarker + antenna) - rxAntd) & MASK_40;
+    uint8_t ts[5];
+    for (int i = 0; i < 5; i++)
+    {
+        ts[i] = (rxStamp >> i * 8) & 0xFF;
+    }
+    memcpy(reg(0x00, 0x64), ts, 5); // RX_TIME
+    memcpy(reg(0x0C, 0x00), ts, 5); // IP_TS
+    if (twoBuffers)
+    {
+        int diag = buffer ? 0xE8 : 0x00;       // DB_DIAG of the buffer
+        set(0x18, diag, len & 0x3FF);          // BUFn_RX_FINFO
+        memcpy(reg(0x18, diag + 0x20), ts, 5); // BUFn_IP_TS
+    }
+
+    set(0x06, 0x29, frame.carrierOffset & 0x1FFFFF, 3); // DRX_CAR_INT
+
+    double level = rxLevel(frame);
+    double accumulated = 250;
+    double cirPower = pow(10, (level + 121.7) / 10) * accumulated * accumulated / (1 << 21);
+    double firstPath = sqrt(pow(10, (level - 3 + 121.7) / 10) * accumulated * accumulated / 3);
+
+    set(0x0C, 0x2C, std::min<uint32_t>((uint32_t)cirPower, 0x1FFFF)); // IP_DIAG_1
+    set(0x0C, 0x30, (uint32_t)firstPath << 2);                       // IP_DIAG_2
+    set(0x0C, 0x34, (uint32_t)firstPath << 2);                       // IP_DIAG_3
+    set(0x0C, 0x38, (uint32_t)firstPath << 2);                       // IP_DIAG_4
+    set(0x0C, 0x48, CIR_FIRST_PATH << 6);                              // IP_DIAG_8: first path index (10.6 bits)
+    set(0x0C, 0x58, (uint32_t)accumulated);                          // IP_DIAG_12
+
+    // accumulator: the first path and one weaker reflection 3 ns later, no noise. Samples saturate at the largest positive 18 bit value.
+    uint32_t amplitude = std::min<uint32_t>((uint32_t)firstPath, 0x1FFFF);
+    memset(reg(0x15, 0), 0, CIR_SAMPLES * 6);
+    set(0x15, CIR_FIRST_PATH * 6, amplitude, 3);
+    set(0x15, (CIR_FIRST_PATH + 3) * 6, amplitude / 2, 3);
+    set(0x03, 0x60, 0);                                              // DGC_DBG
+
+    set(0x00, 0x44, get(0x00, 0x44) | STATUS_RX_DONE);
+    this->framesReceived++;
+
+    if (twoBuffers)
+    {
+        set(0x01, 0x24, get(0x01, 0x24) | RDB_STATUS_DONE << 4 * buffer);
+        this->bufferFull[buffer] = true;
+        this->rxBuffer ^= 1;
+        if ((get(0x00, 0x10) & SYS_CFG_RXAUTR) && !this->bufferFull[this->rxBuffer])
+        {
+            openRX(frame.end);
+        }
+    }
+}
+
+/*
+ Received level in dBm: free space path loss at 6.5 GHz (channel 5) or 8 GHz (channel 9), 0 dBm EIRP at the maximum TX power
+*/
+double SimChip::rxLevel(const Frame &frame)
+{
+    double meters = std::max(frame.distance / 100.0, 0.1);
+    return -48.0 - 20 * log10(meters) - (frame.channel ? 20 * log10(7.9872 / 6.4896) : 0) + frame.txGainDb;
+}
+
+/*
+ Output power relative to the maximum, from the SHR gain of TX_POWER (the preamble decides whether a frame gets detected):
+ 0.25 dB per fine step, 3 dB per coarse step
+*/
+double SimChip::txGainDb()
+{
+    uint8_t shr = get(0x01, 0x0E, 1);
+    return -(63 - (shr >> 2)) * 0.25 - (3 - (shr & 0x3)) * 3.0;
+}
+
+bool SimChip::tuned()
+{
+    bool ch9 = get(0x01, 0x14) & 0x1;
+    return (get(0x07, 0x1C) & ~0x3Fu) == (ch9 ? 0x1C010000u : 0x1C071100u) && get(0x09, 0x00, 2) == (ch9 ? 0x0F3Cu : 0x1F3Cu) &&
+           get(0x03, 0x38) == (ch9 ? 0x0002A8FEu : 0x0001C0FDu);
+}
+
+/*
+ #####  SimAir  #####
+*/
+
+void SimAir::add(SimChip *chip, double positionCm)
+{
+    this->nodes.push_back({chip, positionCm});
+}
+
+void SimAir::setPosition(SimChip *chip, double positionCm)
+{
+    for (Node &node : this->nodes)
+    {
+        if (node.chip == chip)
+        {
+            node.position = positionCm;
+        }
+    }
+}
+
+void SimAir::broadcast(SimChip *sender, const std::vector<uint8_t> &data, uint64_t start, uint64_t rmarker, uint64_t end)
+{
+    double senderPos = 0;
+    for (Node &node : this->nodes)
+    {
+        if (node.chip == sender)
+        {
+            senderPos = node.position;
+        }
+    }
+
+    uint32_t chan = sender->get(0x01, 0x14);
+
+    for (Node &node : this->nodes)
+    {
+        if (node.chip == sender)
+        {
+            continue;
+        }
+
+        double distance = fabs(node.position - senderPos);
+        uint64_t tof = (uint64_t)llround(distance / SPEED_OF_LIGHT_CM_PER_PS);
+
+        // DRX_CAR_INT: clock offset of the sender relative to the receiver, in units of -0.5731 ppb (channel 5) or -0.1252 ppb (channel 9)
+        double offset = (sender->crystalPpm() - node.chip->crystalPpm()) * 1e-6;
+        int32_t carrier = (int32_t)lround(offset / ((chan & 0x1) ? -0.1252e-9 : -0.5731e-9));
+
+        SimChip::Frame frame;
+        frame.data = data;
+        frame.start = start + tof;
+        frame.rmarker = rmarker + tof;
+        frame.end = end + tof;
+        frame.channel = sender->tuned() ? chan & 0x1 : 0xFF; // off channel, nobody matches
+        frame.sfd = (chan >> 1) & 0x3;
+        frame.preambleSymbols = (int)(sender->preamblePs() / SYMBOL_PS + 0.5);
+        frame.fastData = sender->get(0x00, 0x24) & (1 << 10);
+        frame.txGainDb = sender->txGainDb();
+        frame.code = (chan >> 3) & 0x1F;
+        frame.carrierOffset = carrier;
+        frame.distance = distance;
+        node.chip->incoming.push_back(frame);
+    }
+}
+
+/*
+ #####  SimTransport  #####
+*/
+
+/*
+ Rounds the clock down the way the ESP32 does: its SPI clock is the 80MHz APB clock divided by a whole number
+*/
+void SimTransport::setClock(uint32_t hz)
+{
+    uint32_t divider = (80000000 + hz - 1) / hz;
+    this->clockHz = 80000000 / divider;
+}
+
+void SimTransport::doTransfer(const uint8_t *header, uint8_t headerLen, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    uint32_t hz = this->maxClockHz && this->maxClockHz < this->clockHz ? this->maxClockHz : this->clockHz;
+    uint64_t csLowPs = (uint64_t)(headerLen + len) * 8 * 1000000000000ULL / hz;
+    sim::advance(this->overheadPs + csLowPs);
+
+    if (hz > this->chip.maxSpiHz())
+    {
+        this->chip.spiErrors++;
+        if (rx != NULL)
+        {
+            memset(rx, 0xFF, len);
+        }
+        return;
+    }
+
+    if (this->bitErrorRate <= 0)
+    {
+        this->chip.transaction(header, headerLen, tx, rx, len, csLowPs);
+        return;
+    }
+
+    // what the chip sees and what comes back, with bit errors. A read clocks out zeros, which matters if its header turns into a write.
+    std::vector<uint8_t> wireHeader(header, header + headerLen);
+    std::vector<uint8_t> wireTx(len, 0);
+    if (tx != NULL)
+    {
+        memcpy(wireTx.data(), tx, len);
+    }
+    corrupt(wireHeader.data(), headerLen);
+    corrupt(wireTx.data(), len);
+    this->chip.transaction(wireHeader.data(), headerLen, wireTx.data(), rx, len, csLowPs);
+    if (rx != NULL)
+    {
+        corrupt(rx, len);
+    }
+}
+
+/*
+ Flips every bit with a probability of bitErrorRate
+*/
+void SimTransport::corrupt(uint8_t *bytes, size_t len)
+{
+    for (uint64_t bits = (uint64_t)len * 8; bits > 0;)
+    {
+        if (this->bitsToError == 0)
+        {
+            this->bitsToError = std::geometric_distribution<uint64_t>(this->bitErrorRate)(this->rng) + 1;
+        }
+        if (this->bitsToError > bits)
+        {
+            this->bitsToError -= bits;
+            return;
+        }
+        bits -= this->bitsToError;
+        bytes[bits / 8] ^= 1 << (bits % 8);
+        this->bitErrors++;
+        this->bitsToError = 0;
+    }
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <stdint.h>
+#include <random>
+#include <vector>
+
+#include "sim_clock.h"
+#include "dw3000_transport.h"
+
+/*
+ Register level model of a DW3000, good enough to run the unmodified tag and anchor sketches on a host.
+
+ Modelled:
+    * SPI headers: short, full address and fast commands; little endian register file per base address
+    * SPI CRC: writes with a wrong CRC set SPICRCE and are dropped, SPI_RD_CRC holds the CRC of the last read
+    * SYS_STATUS (write 1 to clear), SYS_STATE (always IDLE), SOFT_RST, OTP reads, RX calibration, SAR temperature
+    * IRQ line: high while SYS_STATUS holds an event SYS_ENABLE lets through
+    * PLL lock (CLK_CTRL in auto mode + SEQ_CTRL AINIT2IDLE) and the SPI clock limit before and after it
+    * DEEPSLEEP (AON_CTRL ARRAY_SAVE with AON_CFG SLEEP_EN) and the wakeup on CS held low: the AON download restores the configuration
+      except for the LDO and bias tuning, RF_TX_CTRL_1, PLL_CAL and the DGC lookup table, ONWAKE_GO2IDLE locks the PLL
+    * Fast commands TX, RX, delayed TX, TX then RX (W4R_TIM), TRXOFF
+    * Receive timeouts: SFD (RX_SFD_TOC), preamble (PRE_TOC, raises RXPTO) and frame wait (RX_FWTO with SYS_CFG RXWTOE, raises RXFTO)
+    * Double buffered RX (SYS_CFG DIS_DRXB clear): RX_BUFFER_0/1 with RX_FINFO and IP_TS in DB_DIAG, RDB_STATUS (write 1 to clear),
+      DB_TOGGLE, RXAUTR turns the receiver on again after a frame while the other buffer is free, a frame for a held buffer is lost
+    * Frame airtime from TX_FCTRL/SYS_CFG (preamble length, data rate, PHR rate)
+    * TX/RX timestamps including antenna delays, in 15.65ps ticks of the chip's own (drifting) clock
+    * CIA diagnostics and DRX_CAR_INT, so signal strength and clock offset can be read back
+
+ Everything else just stores what gets written.
+*/
+
+class SimAir;
+
+class SimChip
+{
+public:
+    static constexpr double TICK_PS = 15.65004006410256; // 1 / (128 * 499.2 MHz)
+    static constexpr int PHYSICAL_ANTENNA_DELAY = 16350;   // true TX and RX antenna delay of the simulated boards in ticks at 25 degrees
+    static constexpr double ANTENNA_DELAY_TICKS_PER_C = 0.46; // growth of both antenna delays per degree
+
+    SimChip(sim::Clock &clock, SimAir &air);
+
+    double ppm = 0;          // crystal error of this chip at the default XTAL_TRIM (0x2E)
+    int64_t epochPs = 0;     // offset of this chip's clock to the global time
+    double temperature = 25; // degrees Celsius reported by the SAR
+
+    /*
+     Performs one SPI transaction (one CS assertion)
+     @param csLowPs How long CS was low, only a sleeping chip cares
+    */
+    void transaction(const uint8_t *header, uint8_t headerLen, const uint8_t *tx, uint8_t *rx, uint16_t len, uint64_t csLowPs = 0);
+
+    /*
+     Resets the register file to its reset values (hard reset, soft reset)
+    */
+    void reset();
+
+    /*
+     Overwrites register bytes without the side effects of a SPI write.
+     The trace replay uses it to take over the state of the recorded chip where the model differs.
+    */
+    void poke(int base, int sub, const uint8_t *data, int len);
+    void peek(int base, int sub, uint8_t *data, int len);
+
+    /*
+     Fastest SPI clock the chip accepts in its current state: 7MHz on the RC oscillator, 38MHz once the PLL is locked
+    */
+    uint32_t maxSpiHz() { return this->pllLocked ? 38000000 : 7000000; }
+
+    /*
+     Crystal error with the XTAL_TRIM written by the driver, ~0.8 ppm slower per step above 0x2E
+    */
+    double crystalPpm() const { return this->ppm + this->trimPpm; }
+
+    /*
+     True antenna delay at the current temperature
+    */
+    uint64_t antennaDelayPs() const { return (uint64_t)((PHYSICAL_ANTENNA_DELAY + (this->temperature - 25) * ANTENNA_DELAY_TICKS_PER_C) * TICK_PS); }
+
+    /*
+     Puts the chip on its PLL (or back on the RC oscillator) without going through the lock sequence
+    */
+    void setPllLocked(bool locked) { this->pllLocked = locked; }
+
+    /*
+     True if RF_TX_CTRL_2 (apart from the PG delay), PLL_CFG and the first DGC lookup table entry hold the values of the channel in CHAN_CTRL.
+     Frames a mistuned chip sends reach nobody, and it hears nothing itself.
+    */
+    bool tuned();
+
+    /*
+     True while the chip is in DEEPSLEEP
+    */
+    bool sleeping() const { return this->asleep; }
+
+    /*
+     Level of the IRQ pin at the time of the clock: high while SYS_STATUS and SYS_ENABLE (low word) share a bit
+    */
+    bool irq();
+
+    // statistics
+    uint32_t framesSent = 0;
+    uint32_t framesReceived = 0;
+    uint32_t framesMissed = 0;
+    uint32_t spiErrors = 0; // transactions clocked faster than maxSpiHz(), they read 0xFF and write nothing
+    uint32_t wakeups = 0;   // wakeups from DEEPSLEEP
+    uint64_t sleptPs = 0;   // time spent in DEEPSLEEP up to the last wakeup
+
+private:
+    friend class SimAir;
+
+    struct Window
+    {
+        uint64_t on, off; // global ps the receiver was listening in, off is UINT64_MAX while open
+        uint64_t preambleBy, frameBy; // PRE_TOC and RX_FWTO deadlines, UINT64_MAX without
+        bool timed;                   // the deadlines are set: update() takes them from the registers once the receiver is on
+    };
+
+    struct Frame
+    {
+        std::vector<uint8_t> data; // without FCS
+        uint64_t start, rmarker, end; // global ps at the receiving antenna
+        uint32_t channel, code, sfd;
+        int preambleSymbols; // preamble and SFD
+        bool fastData;       // 6.8 Mb/s payload
+        double txGainDb;     // TX_POWER of the sender, relative to the maximum
+        int32_t carrierOffset; // DRX_CAR_INT value the receiver reports
+        double distance;
+    };
+
+    sim::Clock &clock;
+    SimAir &air;
+    std::vector<std::vector<uint8_t>> regs;
+    std::vector<Frame> incoming;
+    std::vector<Window> windows;
+    int rxBuffer = 0;        // buffer the next frame goes to, double buffered
+    int hostBuffer = 0;      // buffer the host holds, DB_TOGGLE frees it
+    bool bufferFull[2] = {}; // a frame landed in the buffer and the host did not free it yet
+    uint64_t txEnd = 0;    // end of the frame currently being sent
+    bool txPending = false; // TXFRS still has to be raised at txEnd
+    bool pllLocked = false;
+    double trimPpm = 0;     // crystal pull of the XTAL_TRIM written against 0x2E
+    uint64_t readyAt = 0;   // the chip leaves INIT_RC after a reset (SPIRDY, RCINIT, IDLE_RC) at this global ps, 0 once it did
+    bool lockOnReady = false; // ONWAKE_GO2IDLE: the PLL locks as soon as the chip is ready
+    bool asleep = false;
+    uint64_t asleepAt = 0;    // global ps the chip went to sleep
+    std::vector<std::vector<uint8_t>> aon; // the configuration AON_CTRL ARRAY_SAVE kept
+
+    uint8_t *reg(int base, int sub) { return &this->regs[base][sub]; }
+    uint32_t get(int base, int sub, int len = 4);
+    void set(int base, int sub, uint32_t val, int len = 4);
+
+    uint64_t chipTicks(uint64_t globalPs);
+    uint64_t globalPs(uint64_t chipTicks);
+
+    void update();
+    void afterWrite(int base, int sub, int len);
+    void fastCommand(int cmd);
+    void sleep();
+    void wake();
+    void transmit(bool delayed, bool thenRX, uint64_t reference = 0);
+    void openRX(uint64_t at);
+    void closeRX(uint64_t at);
+    void deliver(const Frame &frame);
+    bool doubleBuffered();
+    static double rxLevel(const Frame &frame);
+    double txGainDb();
+
+    int pacSymbols();
+    uint64_t pacPs();
+    uint64_t preamblePs();
+    uint64_t payloadPs(int len);
+};
+
+/*
+ Connects the chips: every frame a chip sends is offered to all other chips with the time of flight of their distance
+*/
+class SimAir
+{
+public:
+    void add(SimChip *chip, double positionCm);
+    void setPosition(SimChip *chip, double positionCm);
+
+    void broadcast(SimChip *sender, const std::vector<uint8_t> &data, uint64_t start, uint64_t rmarker, uint64_t end);
+
+private:
+    struct Node
+    {
+        SimChip *chip;
+        double position;
+    };
+    std::vector<Node> nodes;
+};
+
+/*
+ DW3000Transport that talks to a SimChip. Every transaction moves the clock of the node forward by
+ a fixed overhead plus the time the bytes take on the bus.
+*/
+class SimTransport : public DW3000Transport
+{
+public:
+    SimTransport(SimChip &chip) : chip(chip) {}
+
+    uint32_t clockHz = 1000000;        // SPIClass default until the driver sets a clock
+    uint32_t maxClockHz = 0;           // if not 0, the bus never runs faster than this, whatever the driver asks for
+    uint64_t overheadPs = 3 * sim::US; // CS handling and driver overhead per transaction
+    double bitErrorRate = 0;           // probability of a bit on the bus to flip, in both directions
+    uint32_t bitErrors = 0;            // bits that were flipped
+
+    void setClock(uint32_t hz) override;
+
+protected:
+    void doTransfer(const uint8_t *header, uint8_t headerLen, const uint8_t *tx, uint8_t *rx, uint16_t len) override;
+
+private:
+    SimChip &chip;
+    std::mt19937_64 rng;      // default seed, so runs repeat
+    uint64_t bitsToError = 0; // bits until the next flip, 0 before the first one is drawn
+
+    void corrupt(uint8_t *bytes, size_t len);
+};
@@ -0,0 +1,123 @@
+#include <Arduino.h>
+#include <Preferences.h>
+#include <SPI.h>
+#include <WiFi.h>
+#include <WiFiClient.h>
+#include <algorithm>
+
+#include "sim_nodes.h"
+
+namespace anchor_node
+{
+#include "anchor.h"
+}
+
+void anchor_sim::attach(DW3000Transport *transport)
+{
+    anchor_node::dwm.config.transport = transport;
+}
+
+#if ANCHOR_SECOND_RADIO
+void anchor_sim::attachSecondRadio(DW3000Transport *transport)
+{
+    anchor_node::dwm2.config.transport = transport;
+}
+#endif
+
+void anchor_sim::setup()
+{
+    anchor_node::setup();
+}
+
+void anchor_sim::loop()
+{
+    anchor_node::loop();
+}
+
+void anchor_sim::setIrq(bool on)
+{
+    anchor_node::irq_events = on;
+}
+
+void anchor_sim::setDoubleBuffer(bool on)
+{
+    anchor_node::rx_double_buffer = on;
+}
+
+uint32_t anchor_sim::rxBufferSwaps()
+{
+    return anchor_node::dwm.rxBufferSwaps;
+}
+
+uint32_t anchor_sim::rxBufferBacklog()
+{
+    return anchor_node::dwm.rxBufferBacklog;
+}
+
+uint8_t anchor_sim::irqPin(int radio)
+{
+#if ANCHOR_SECOND_RADIO
+    if (radio == 1)
+        return anchor_node::AnchorBoard2::irqPin;
+#endif
+    return anchor_node::AnchorBoard::irqPin;
+}
+
+uint32_t anchor_sim::shadowHits()
+{
+    return anchor_node::dwm.shadowHits;
+}
+
+uint32_t anchor_sim::rxReceives()
+{
+    uint32_t receives = 0;
+    for (const anchor_node::DW3000RxStats &stats : anchor_node::anchorEngine.rx_stats)
+    {
+        receives += stats.receives;
+    }
+    return receives;
+}
+
+uint32_t anchor_sim::rxFailures(int error)
+{
+    uint32_t failures = 0;
+    for (const anchor_node::DW3000RxStats &stats : anchor_node::anchorEngine.rx_stats)
+    {
+        failures += stats.errors[error];
+    }
+    return failures;
+}
+
+void anchor_sim::dumpTrace(Print &out)
+{
+    anchor_node::dwm.trace.dump(out);
+}
+
+int anchor_sim::cirPeak(int firstSample, int samples)
+{
+    uint8_t cir[1 + CIR_COMMAND_MAX_SAMPLES * DW3000_CIR_SAMPLE_LEN];
+    samples = std::min(samples, CIR_COMMAND_MAX_SAMPLES);
+    anchor_node::dwm.readAccumulator(firstSample, samples, cir);
+
+    int peak = -1;
+    int64_t peakPower = 0;
+    for (int i = 0; i < samples; i++)
+    {
+        const uint8_t *sample = cir + 1 + i * DW3000_CIR_SAMPLE_LEN;
+        // 18 bit two's complement, sign extended to 32
+        int32_t re = (int32_t)((sample[0] | sample[1] << 8 | sample[2] << 16) << 14) >> 14;
+        int32_t im = (int32_t)((sample[3] | sample[4] << 8 | sample[5] << 16) << 14) >> 14;
+        int64_t power = (int64_t)re * re + (int64_t)im * im;
+        if (power > peakPower)
+        {
+            peak = firstSample + i;
+            peakPower = power;
+        }
+    }
+    return peak;
+}
+
+int anchor_sim::firstPathIndex()
+{
+    return anchor_node::dwm.read(regs::IP_DIAG_8) >> 6;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+
+/*
+ Simulated time in picoseconds.
+ Every node has its own clock: millis()/delay() and the SPI transport of a node only move that node's clock forward.
+ The clock also carries the input pins of its node, the harness wires them to the simulated chips (digitalRead()).
+ The harness always runs the node that is furthest behind, so the clocks of all nodes stay close together.
+*/
+namespace sim
+{
+    struct Clock
+    {
+        uint64_t ps = 0;
+        std::function<int(uint8_t pin)> readPin; // level of an input pin of the node, unset pins read LOW
+    };
+
+    inline Clock defaultClock;
+    inline Clock *current = &defaultClock; // clock of the node that is running right now
+
+    inline uint64_t now() { return current->ps; }
+    inline void advance(uint64_t ps) { current->ps += ps; }
+
+    constexpr uint64_t US = 1000000ULL;
+    constexpr uint64_t MS = 1000000000ULL;
+    constexpr uint64_t S = 1000000000000ULL;
+}
@@ -0,0 +1,328 @@
+/*
+ Runs the tag and anchor sketches against two simulated DW3000s and reports how well ranging works.
+
+ Usage: dw3000_sim [--distance cm] [--seconds s] [--spi-hz hz] [--ppm-tag ppm] [--ppm-anchor ppm]
+                   [--temp-tag degrees] [--switch-channel 5|9] [--duty-cycle ms] [--irq] [--double-buffer]
+                   [--spi-ber rate] [--trace-tag file] [--trace-anchor file] [--verbose]
+
+ Exits with 1 if no range was measured, the mean error is above 5 cm or the SPI clock was too fast for the chip,
+ so it can be used as a regression check.
+
+ Built with ANCHOR_SECOND_RADIO (dw3000_sim_dual), the anchor drives a second chip on its own SPI bus
+ and the tag ranges with both of its anchor IDs in turn.
+*/
+
+#include <Arduino.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dw3000_sim.h"
+#include "sim_nodes.h"
+#include "dw3000_rxerr.h"
+
+#ifndef NUM_ANCHORS
+#define NUM_ANCHORS 1 // same default as the tag
+#endif
+
+/*
+ Print into a file, for the SPI trace dumps
+*/
+class FilePrint : public Print
+{
+public:
+    FilePrint(FILE *file) : file(file) {}
+
+    using Print::write;
+    size_t write(const uint8_t *buf, size_t len) override { return fwrite(buf, 1, len, this->file); }
+
+private:
+    FILE *file;
+};
+
+/*
+ Writes the SPI trace of a node (see trace_replay.cpp)
+ @return False if the file could not be written
+*/
+bool writeTrace(const char *path, void (*dump)(Print &out))
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+    {
+        fprintf(stderr, "could not write %s\n", path);
+        return false;
+    }
+    FilePrint out(file);
+    dump(out);
+    fclose(file);
+    return true;
+}
+
+/*
+ Prints the failed receives of a node by reason, nothing if none failed
+*/
+void printRxFailures(uint32_t (*failures)(int error))
+{
+    const char *separator = ", failed:";
+    for (int i = 0; i < DW3000_RX_ERR_COUNT; i++)
+    {
+        if (failures(i))
+        {
+            printf("%s %s %u", separator, dw3000RxErrorName(i), failures(i));
+            separator = "";
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    double distance = 500;
+    double seconds = 10;
+    uint32_t spiHz = 0; // upper limit for the SPI clock, 0: the clocks the driver sets
+    double ppmTag = 0;
+    double ppmAnchor = 0;
+    double tempTag = 25;
+    int switchChannel = 0;
+    unsigned long dutyCycle = 0;
+    bool irq = false;
+    bool doubleBuffer = false;
+    double spiBer = 0;
+    const char *traceTag = NULL;
+    const char *traceAnchor = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--distance") && hasValue)
+            distance = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--seconds") && hasValue)
+            seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--spi-hz") && hasValue)
+            spiHz = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--ppm-tag") && hasValue)
+            ppmTag = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--ppm-anchor") && hasValue)
+            ppmAnchor = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--temp-tag") && hasValue)
+            tempTag = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--switch-channel") && hasValue)
+            switchChannel = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--duty-cycle") && hasValue)
+            dutyCycle = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--irq"))
+            irq = true;
+        else if (!strcmp(argv[i], "--double-buffer"))
+            doubleBuffer = true;
+        else if (!strcmp(argv[i], "--spi-ber") && hasValue)
+            spiBer = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--trace-tag") && hasValue)
+            traceTag = argv[++i];
+        else if (!strcmp(argv[i], "--trace-anchor") && hasValue)
+            traceAnchor = argv[++i];
+        else if (!strcmp(argv[i], "--verbose"))
+            Serial.enabled = true;
+        else
+        {
+            fprintf(stderr, "usage: %s [--distance cm] [--seconds s] [--spi-hz hz] [--ppm-tag ppm] [--ppm-anchor ppm] "
+                            "[--temp-tag degrees] [--switch-channel 5|9] [--duty-cycle ms] [--irq] [--double-buffer] [--spi-ber rate] [--trace-tag file] [--trace-anchor file] [--verbose]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    sim::Clock tagClock, anchorClock;
+    SimAir air;
+
+    SimChip tagChip(tagClock, air);
+    SimChip anchorChip(anchorClock, air);
+    tagChip.ppm = ppmTag;
+    anchorChip.ppm = ppmAnchor;
+    tagChip.epochPs = 123456789012LL; // the chips were not switched on at the same time
+    air.add(&anchorChip, 0);
+    air.add(&tagChip, distance);
+#if ANCHOR_SECOND_RADIO
+    SimChip anchorChip2(anchorClock, air); // same board, so same clock, next to the first radio
+    anchorChip2.ppm = ppmAnchor;
+    air.add(&anchorChip2, 0);
+#endif
+
+    SimTransport tagSpi(tagChip), anchorSpi(anchorChip);
+    tagSpi.maxClockHz = spiHz;
+    anchorSpi.maxClockHz = spiHz;
+    tagSpi.bitErrorRate = spiBer;
+    anchorSpi.bitErrorRate = spiBer;
+    tag_sim::attach(&tagSpi);
+    anchor_sim::attach(&anchorSpi);
+#if ANCHOR_SECOND_RADIO
+    SimTransport anchorSpi2(anchorChip2);
+    anchorSpi2.maxClockHz = spiHz;
+    anchorSpi2.bitErrorRate = spiBer;
+    anchor_sim::attachSecondRadio(&anchorSpi2);
+#endif
+
+    // the IRQ lines, only sketches waiting for them (--irq or RANGING_IRQ) read them
+    tagClock.readPin = [&](uint8_t pin)
+    { return pin == tag_sim::irqPin() && tagChip.irq(); };
+    anchorClock.readPin = [&](uint8_t pin)
+    {
+#if ANCHOR_SECOND_RADIO
+        if (pin == anchor_sim::irqPin(1))
+            return (int)anchorChip2.irq();
+#endif
+        return (int)(pin == anchor_sim::irqPin(0) && anchorChip.irq());
+    };
+    if (irq)
+    {
+        tag_sim::setIrq(true);
+        anchor_sim::setIrq(true);
+    }
+    anchor_sim::setDoubleBuffer(doubleBuffer);
+
+    sim::current = &anchorClock;
+    anchor_sim::setup();
+    sim::current = &tagClock;
+    tag_sim::setup();
+    tag_sim::setDutyCycle(dutyCycle);
+    uint64_t tagSetupPs = tagClock.ps;
+    uint64_t anchorSetupPs = anchorClock.ps;
+    uint64_t firstRangePs = 0;
+
+    uint64_t setupEnd = tagClock.ps > anchorClock.ps ? tagClock.ps : anchorClock.ps;
+    uint64_t end = setupEnd + (uint64_t)(seconds * sim::S);
+
+    int ranges = 0;
+    uint64_t lastRangePs = 0, longestGapPs = 0; // longest time without a range, the downtime of a cell wide switch
+    bool switchScheduled = false;
+    int rangesPerAnchor[2] = {0, 0};
+    double errorSum = 0, errorSquares = 0;
+    tagSpi.resetCounters();
+    anchorSpi.resetCounters();
+    tagSpi.bitErrors = 0;
+    anchorSpi.bitErrors = 0;
+#if ANCHOR_SECOND_RADIO
+    anchorSpi2.resetCounters();
+    anchorSpi2.bitErrors = 0;
+#endif
+    uint32_t tagShadowHits = tag_sim::shadowHits();
+    uint32_t anchorShadowHits = anchor_sim::shadowHits();
+
+    // always run the node that is furthest behind
+    while (tagClock.ps < end || anchorClock.ps < end)
+    {
+        if (tagClock.ps >= (setupEnd + end) / 2)
+        {
+            tagChip.temperature = tempTag; // the tag warms up (or cools down) halfway through
+        }
+        if (switchChannel && !switchScheduled && tagClock.ps >= setupEnd + (end - setupEnd) / 3)
+        {
+            sim::current = &tagClock;
+            switchScheduled = tag_sim::scheduleCell(switchChannel, 5); // a third into the run, at 5 epochs from then
+        }
+        if (tagClock.ps <= anchorClock.ps)
+        {
+            sim::current = &tagClock;
+            int stage = tag_sim::stage();
+            int anchor = tag_sim::anchor();
+            tag_sim::loop();
+            if (stage == 4 && tag_sim::stage() != 4) // on to the next anchor, or first negotiating a PHY switch
+            {
+                double error = tag_sim::distance(anchor) - distance;
+                errorSum += error;
+                errorSquares += error * error;
+                ranges++;
+                rangesPerAnchor[anchor & 1]++;
+                if (firstRangePs == 0)
+                {
+                    firstRangePs = tagClock.ps;
+                }
+                if (lastRangePs && tagClock.ps - lastRangePs > longestGapPs)
+                {
+                    longestGapPs = tagClock.ps - lastRangePs;
+                }
+                lastRangePs = tagClock.ps;
+            }
+        }
+        else
+        {
+            sim::current = &anchorClock;
+            anchor_sim::loop();
+        }
+    }
+
+    double mean = ranges ? errorSum / ranges : 0;
+    double std = ranges ? sqrt(errorSquares / ranges - mean * mean) : 0;
+    double perRange = ranges ? 1.0 / ranges : 0;
+    tagShadowHits = tag_sim::shadowHits() - tagShadowHits;
+    anchorShadowHits = anchor_sim::shadowHits() - anchorShadowHits;
+
+    printf("simulated %.1f s at %.1f cm, SPI %u Hz\n", seconds, distance, spiHz && spiHz < tagSpi.clockHz ? spiHz : tagSpi.clockHz);
+    printf("ranges:  %d (%.1f/s)\n", ranges, ranges / seconds);
+    printf("error:   mean %.2f cm, std %.2f cm\n", mean, std);
+    printf("tag:     %.1f SPI transactions, %.1f bytes per range, %.1f saved by the register shadow\n",
+           tagSpi.transactions * perRange, tagSpi.bytes * perRange, tagShadowHits * perRange);
+    printf("anchor:  %.1f SPI transactions, %.1f bytes per range, %.1f saved by the register shadow\n",
+           anchorSpi.transactions * perRange, anchorSpi.bytes * perRange, anchorShadowHits * perRange);
+    printf("phy:     %s %.2f dB", tag_sim::phy(0), tag_sim::txPower(0));
+    for (int i = 1; i < NUM_ANCHORS; i++)
+        printf("/%s %.2f dB", tag_sim::phy(i), tag_sim::txPower(i));
+    printf(" (%d switches), first path %.1f dBm\n", tag_sim::phySwitches(), tag_sim::firstPathLevel(0));
+    printf("xtal:    tag trim 0x%02X%s, crystal %+.2f ppm against the anchor (%+.2f ppm untrimmed)\n", tag_sim::xtalTrim(),
+           tag_sim::xtalConverged() ? " converged" : "", tagChip.crystalPpm() - anchorChip.crystalPpm(), tagChip.ppm - anchorChip.ppm);
+    printf("temp:    tag %.1f C, %d recalibrations\n", tag_sim::temperature(), tag_sim::recalibrations());
+    if (switchChannel)
+    {
+        printf("switch:  cell on channel %d, %d/%d anchors confirmed, longest gap between ranges %.1f ms\n", tag_sim::cellChannel(),
+               tag_sim::cellConfirmed(), NUM_ANCHORS, longestGapPs / (double)sim::MS);
+    }
+    if (dutyCycle)
+    {
+        printf("sleep:   tag radio asleep %.1f%% of the time, %u wakeups, wake to first frame %.2f ms (max %.2f ms)\n",
+               100.0 * tagChip.sleptPs / (end - setupEnd), tagChip.wakeups, tag_sim::wakeLatencyUs() / 1000.0, tag_sim::wakeLatencyMaxUs() / 1000.0);
+    }
+    printf("boot:    setup tag %.1f ms, anchor %.1f ms, first range %.1f ms after power on\n",
+           tagSetupPs / (double)sim::MS, anchorSetupPs / (double)sim::MS, firstRangePs / (double)sim::MS);
+    printf("frames:  tag %u sent/%u received/%u missed, anchor %u sent/%u received/%u missed\n",
+           tagChip.framesSent, tagChip.framesReceived, tagChip.framesMissed,
+           anchorChip.framesSent, anchorChip.framesReceived, anchorChip.framesMissed);
+    printf("rxerr:   tag %u receives", tag_sim::rxReceives());
+    printRxFailures(tag_sim::rxFailures);
+    printf(", anchor %u receives", anchor_sim::rxReceives());
+    printRxFailures(anchor_sim::rxFailures);
+    printf("\n");
+    if (doubleBuffer)
+    {
+        printf("rxbuf:   anchor %u buffers handed back, %u frames already waiting in the other buffer\n",
+               anchor_sim::rxBufferSwaps(), anchor_sim::rxBufferBacklog());
+    }
+#if ANCHOR_SECOND_RADIO
+    printf("radio 2: %d ranges (%d with radio 1), %.1f SPI transactions per range, %u frames sent/%u received/%u missed\n",
+           rangesPerAnchor[1], rangesPerAnchor[0], rangesPerAnchor[1] ? anchorSpi2.transactions / (double)rangesPerAnchor[1] : 0,
+           anchorChip2.framesSent, anchorChip2.framesReceived, anchorChip2.framesMissed);
+    anchorChip.spiErrors += anchorChip2.spiErrors;
+    if (rangesPerAnchor[1] == 0)
+        ranges = 0; // the second radio has to range as well
+#endif
+
+    if (tagChip.spiErrors || anchorChip.spiErrors)
+        printf("spi:     tag %u, anchor %u transactions faster than the chip accepts\n", tagChip.spiErrors, anchorChip.spiErrors);
+
+    if (spiBer > 0 || tagSpi.crcErrors || anchorSpi.crcErrors)
+        printf("crc:     tag %u bits flipped/%u CRC errors/%u failures, anchor %u bits flipped/%u CRC errors/%u failures\n",
+               tagSpi.bitErrors, tagSpi.crcErrors, tagSpi.crcFailures, anchorSpi.bitErrors, anchorSpi.crcErrors, anchorSpi.crcFailures);
+
+    int firstPath = anchor_sim::firstPathIndex();
+    int cirPeak = anchor_sim::cirPeak(firstPath - 16, 32);
+    printf("cir:     anchor first path at sample %d, accumulator peak at sample %d\n", firstPath, cirPeak);
+
+    if ((traceTag && !writeTrace(traceTag, tag_sim::dumpTrace)) || (traceAnchor && !writeTrace(traceAnchor, anchor_sim::dumpTrace)))
+        return 2;
+
+    if (ranges == 0 || fabs(mean) > 5.0 || tagChip.spiErrors || anchorChip.spiErrors || cirPeak != firstPath)
+    {
+        printf("FAILED\n");
+        return 1;
+    }
+    return 0;
+}
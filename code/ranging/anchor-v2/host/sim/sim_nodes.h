@@ -0,0 +1,59 @@
+#pragma once
+
+#include "dw3000_transport.h"
+
+class Print;
+
+/*
+ The sketches (src/tag.h, src/anchor.h) are compiled unmodified, each into its own namespace, so both can live in one binary.
+ These are the hooks the harness needs to drive them.
+*/
+
+namespace tag_sim
+{
+    void attach(DW3000Transport *transport); // replaces the SPI transport of the sketch
+    void setup();
+    void loop();
+    int stage();
+    int anchor();               // index of the anchor the tag ranges with
+    float distance(int anchor); // last raw distance to an anchor in cm
+    float firstPathLevel(int anchor); // first path level of the last range with an anchor in dBm
+    const char *phy(int anchor);      // PHY profile of the link to an anchor
+    int phySwitches();                // PHY switches the anchors confirmed
+    float txPower(int anchor);        // TX power of the link to an anchor in dB below the maximum
+    int xtalTrim();                   // XTAL_TRIM the tag runs with
+    bool xtalConverged();             // the crystal trim loop settled
+    float temperature();              // chip temperature of the last sample in degrees
+    int recalibrations();             // recalibrations the temperature drift caused
+    bool scheduleCell(int channel, int epochs); // cell wide switch to a channel (5 or 9), epochs from now
+    int cellChannel();                // channel of the cell, 5 or 9
+    int cellConfirmed();              // anchors that confirmed the last cell wide switch
+    void setDutyCycle(unsigned long ms); // duty cycling period, 0 keeps the tag awake
+    unsigned long wakeLatencyUs();    // radio wakeup to first frame of the last slot
+    unsigned long wakeLatencyMaxUs(); // the longest of them
+    void setIrq(bool on);             // wait for frames on the IRQ line instead of polling SYS_STATUS, before setup()
+    uint8_t irqPin();                 // the pin the harness has to drive with the IRQ line of the chip
+    uint32_t shadowHits();      // register reads the driver answered from its shadow
+    uint32_t rxReceives();          // receives of all anchors and stages that ended (DW3000RxStats)
+    uint32_t rxFailures(int error); // of them, the ones that failed for a DW3000RxError
+    void dumpTrace(Print &out); // the SPI transactions the driver traced (DW3000_TRACE_DEPTH)
+}
+
+namespace anchor_sim
+{
+    void attach(DW3000Transport *transport);
+    void attachSecondRadio(DW3000Transport *transport); // only built with ANCHOR_SECOND_RADIO
+    void setup();
+    void loop();
+    void setIrq(bool on);       // wait for frames on the IRQ lines instead of polling SYS_STATUS, before setup()
+    uint8_t irqPin(int radio);  // the pin of the IRQ line of radio 0 or 1
+    void setDoubleBuffer(bool on); // both RX buffers of the radios, before setup()
+    uint32_t rxBufferSwaps();      // RX buffers radio 1 handed back to its chip
+    uint32_t rxBufferBacklog();    // frames that were already waiting in the other buffer of radio 1
+    uint32_t shadowHits();
+    uint32_t rxReceives();          // receives of radio 1 in all stages
+    uint32_t rxFailures(int error);
+    void dumpTrace(Print &out);
+    int cirPeak(int firstSample, int samples); // strongest accumulator sample of the last frame, read through the indirect pointer
+    int firstPathIndex();                      // first path sample the chip reported for the last frame (IP_DIAG_8)
+}
@@ -0,0 +1,163 @@
+#include <Arduino.h>
+#include <Preferences.h>
+#include <SPI.h>
+#include <WiFi.h>
+#include <WiFiClient.h>
+
+#include "sim_nodes.h"
+
+namespace tag_node
+{
+#include "tag.h"
+}
+
+void tag_sim::attach(DW3000Transport *transport)
+{
+    tag_node::dwm.config.transport = transport;
+}
+
+void tag_sim::setup()
+{
+    tag_node::setup();
+}
+
+void tag_sim::loop()
+{
+    tag_node::loop();
+}
+
+int tag_sim::stage()
+{
+    return tag_node::curr_stage;
+}
+
+int tag_sim::anchor()
+{
+    return tag_node::current_anchor_index;
+}
+
+float tag_sim::distance(int anchor)
+{
+    return tag_node::anchors[anchor].distance;
+}
+
+float tag_sim::firstPathLevel(int anchor)
+{
+    return tag_node::anchors[anchor].fp_signal_strength;
+}
+
+const char *tag_sim::phy(int anchor)
+{
+    return tag_node::phyName(tag_node::anchors[anchor]);
+}
+
+int tag_sim::phySwitches()
+{
+    return tag_node::phy_switches;
+}
+
+float tag_sim::txPower(int anchor)
+{
+    return -tag_node::anchors[anchor].tx_backoff * DW3000_TX_POWER_FINE_STEP_DB;
+}
+
+int tag_sim::xtalTrim()
+{
+    return tag_node::dwm.xtalTrim;
+}
+
+bool tag_sim::xtalConverged()
+{
+    return tag_node::xtal.converged();
+}
+
+float tag_sim::temperature()
+{
+    return tag_node::dwm.temperature;
+}
+
+int tag_sim::recalibrations()
+{
+    return tag_node::temperature.recalibrations;
+}
+
+bool tag_sim::scheduleCell(int channel, int epochs)
+{
+    return tag_node::scheduleCellProfile(channel, tag_node::cell.profile, tag_node::currentEpoch() + epochs);
+}
+
+int tag_sim::cellChannel()
+{
+    return tag_node::cell.channel == CHANNEL_9 ? 9 : 5;
+}
+
+int tag_sim::cellConfirmed()
+{
+    int confirmed = 0;
+    for (int i = 0; i < NUM_ANCHORS; i++)
+    {
+        confirmed += tag_node::anchors[i].cell_confirmed;
+    }
+    return confirmed;
+}
+
+void tag_sim::setDutyCycle(unsigned long ms)
+{
+    tag_node::duty_cycle_ms = ms;
+}
+
+unsigned long tag_sim::wakeLatencyUs()
+{
+    return tag_node::wake_latency_us;
+}
+
+unsigned long tag_sim::wakeLatencyMaxUs()
+{
+    return tag_node::wake_latency_max_us;
+}
+
+void tag_sim::setIrq(bool on)
+{
+    tag_node::irq_events = on;
+}
+
+uint8_t tag_sim::irqPin()
+{
+    return tag_node::TagBoard::irqPin;
+}
+
+uint32_t tag_sim::shadowHits()
+{
+    return tag_node::dwm.shadowHits;
+}
+
+uint32_t tag_sim::rxReceives()
+{
+    uint32_t receives = 0;
+    for (const tag_node::AnchorData &anchor : tag_node::anchors)
+    {
+        for (const tag_node::DW3000RxStats &stats : anchor.rx_stats)
+        {
+            receives += stats.receives;
+        }
+    }
+    return receives;
+}
+
+uint32_t tag_sim::rxFailures(int error)
+{
+    uint32_t failures = 0;
+    for (const tag_node::AnchorData &anchor : tag_node::anchors)
+    {
+        for (const tag_node::DW3000RxStats &stats : anchor.rx_stats)
+        {
+            failures += stats.errors[error];
+        }
+    }
+    return failures;
+}
+
+void tag_sim::dumpTrace(Print &out)
+{
+    tag_node::dwm.trace.dump(out);
+}
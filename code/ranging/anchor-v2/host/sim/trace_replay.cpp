@@ -0,0 +1,373 @@
+/*
+ Replays a SPI trace of the driver (DW3000Trace::dump(), the "trace" command, dw3000_sim --trace-tag)
+ against a simulated DW3000 and profiles it.
+
+ Usage: dw3000_replay [--spi-hz hz] [--registers dw3000_registers.h] [--verbose] trace
+
+ The transactions are sent at the times they were recorded. Reads are compared with the recorded data:
+ where the model returns something else, the recorded bytes are written into the model, so the chip follows the recording.
+ Such a read counts as seeded if the replay never wrote the register (the trace started after it was set up),
+ otherwise as diverged (the model and the recorded chip disagree, e.g. frames that arrived from another node).
+
+ Prints the time the recording spent per register next to the bus time of the simulated transport.
+*/
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "dw3000_sim.h"
+
+#ifndef DW3000_REGISTERS_H
+#define DW3000_REGISTERS_H "dw3000_registers.h" // register names
+#endif
+
+namespace
+{
+    struct Record
+    {
+        uint32_t start, cycles;
+        char kind; // r, w or q, upper case if the transport checked it with the SPI CRC
+        uint8_t header[2];
+        uint8_t headerLen;
+        uint16_t len;
+        std::vector<uint8_t> data; // the first bytes of the transaction
+    };
+
+    struct Stats
+    {
+        uint32_t count = 0;
+        uint64_t bytes = 0;
+        uint64_t cycles = 0; // recorded
+        uint64_t simPs = 0;  // simulated bus time
+        uint32_t seeded = 0;
+        uint32_t diverged = 0;
+    };
+
+    const char *FAST_COMMANDS[] = {"TXRXOFF", "TX", "RX", "DTX", "DRX", "DTX_TS", "DRX_TS", "DTX_RS", "DRX_RS", "DTX_REF",
+                                   "DRX_REF", "CCA_TX", "TX_W4R", "DTX_W4R", "DTX_TS_W4R", "DTX_RS_W4R", "DTX_REF_W4R",
+                                   "CCA_TX_W4R", "CLR_IRQS", "DB_TOGGLE"};
+
+    int hexNibble(char c)
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        return -1;
+    }
+
+    bool parseHex(const char *s, std::vector<uint8_t> &out)
+    {
+        out.clear();
+        for (; s[0] && s[1]; s += 2)
+        {
+            int hi = hexNibble(s[0]), lo = hexNibble(s[1]);
+            if (hi < 0 || lo < 0)
+                return false;
+            out.push_back(hi << 4 | lo);
+        }
+        return true;
+    }
+
+    /*
+     Reads a dump. Lines before "dw3000 trace" (serial output around it) are skipped.
+    */
+    bool readTrace(const char *path, std::vector<Record> &records, unsigned int &mhz)
+    {
+        FILE *file = fopen(path, "r");
+        if (file == NULL)
+        {
+            fprintf(stderr, "could not open %s\n", path);
+            return false;
+        }
+
+        char line[512];
+        bool inTrace = false;
+        unsigned int expected = 0;
+        while (fgets(line, sizeof(line), file))
+        {
+            if (!inTrace)
+            {
+                inTrace = sscanf(line, "dw3000 trace %u %u", &expected, &mhz) == 2;
+                continue;
+            }
+            if (!strncmp(line, "end", 3))
+                break;
+
+            Record rec;
+            char header[8], data[256] = "";
+            unsigned int len;
+            if (sscanf(line, "%u %u %c %7s %u %255s", &rec.start, &rec.cycles, &rec.kind, header, &len, data) < 5)
+            {
+                fprintf(stderr, "bad trace line: %s", line);
+                fclose(file);
+                return false;
+            }
+            std::vector<uint8_t> headerBytes;
+            if (!parseHex(header, headerBytes) || headerBytes.empty() || headerBytes.size() > 2 || !parseHex(data, rec.data))
+            {
+                fprintf(stderr, "bad trace line: %s", line);
+                fclose(file);
+                return false;
+            }
+            rec.headerLen = headerBytes.size();
+            rec.header[0] = headerBytes[0];
+            rec.header[1] = rec.headerLen > 1 ? headerBytes[1] : 0;
+            rec.len = len;
+            records.push_back(rec);
+        }
+        fclose(file);
+
+        if (!inTrace || mhz == 0)
+        {
+            fprintf(stderr, "%s holds no trace\n", path);
+            return false;
+        }
+        if (records.size() != expected)
+            fprintf(stderr, "warning: trace announced %u transactions, found %zu\n", expected, records.size());
+        return true;
+    }
+
+    /*
+     Register names from the #define NAME_ID 0xBBSSSS lines of dw3000_registers.h
+    */
+    std::map<uint32_t, std::string> readRegisterNames(const char *path)
+    {
+        std::map<uint32_t, std::string> names;
+        FILE *file = fopen(path, "r");
+        if (file == NULL)
+            return names;
+
+        char line[256];
+        while (fgets(line, sizeof(line), file))
+        {
+            char name[64];
+            unsigned int id;
+            if (sscanf(line, "#define %63s %x", name, &id) != 2)
+                continue;
+            std::string n = name;
+            if (n.size() <= 3 || n.compare(n.size() - 3, 3, "_ID") != 0)
+                continue;
+            n.resize(n.size() - 3);
+            names.emplace(id, n); // the first name of an address wins
+        }
+        fclose(file);
+        return names;
+    }
+
+    // fast commands get keys above any register address
+    constexpr uint32_t FAST_COMMAND_KEY = 0x1000000;
+    constexpr uint32_t CLK_CTRL_KEY = 0x110004;
+    constexpr uint8_t SYS_CFG_SPI_CRC = 0x40;
+
+    uint32_t keyOf(const Record &rec)
+    {
+        if (!(rec.header[0] & 0x40) && (rec.header[0] & 0x01))
+            return FAST_COMMAND_KEY | ((rec.header[0] >> 1) & 0x1F);
+
+        int base = (rec.header[0] >> 1) & 0x1F;
+        int sub = rec.headerLen > 1 ? ((rec.header[0] & 0x01) << 6) | (rec.header[1] >> 2) : 0;
+        return base << 16 | sub;
+    }
+
+    std::string nameOf(uint32_t key, const std::map<uint32_t, std::string> &names)
+    {
+        char buf[64];
+        if (key & FAST_COMMAND_KEY)
+        {
+            uint32_t cmd = key & 0x1F;
+            snprintf(buf, sizeof(buf), "fast %s", cmd < sizeof(FAST_COMMANDS) / sizeof(FAST_COMMANDS[0]) ? FAST_COMMANDS[cmd] : "?");
+            return buf;
+        }
+
+        // the register at or below the address, accesses into a register show their offset
+        auto it = names.upper_bound(key);
+        if (it != names.begin() && (--it)->first >> 16 == key >> 16)
+        {
+            if (it->first == key)
+                snprintf(buf, sizeof(buf), "%s (%02X:%02X)", it->second.c_str(), key >> 16, key & 0xFFFF);
+            else
+                snprintf(buf, sizeof(buf), "%s+%u (%02X:%02X)", it->second.c_str(), key - it->first, key >> 16, key & 0xFFFF);
+        }
+        else
+        {
+            snprintf(buf, sizeof(buf), "? (%02X:%02X)", key >> 16, key & 0xFFFF);
+        }
+        return buf;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t spiHz = 0; // 0: the clocks the driver uses, depending on the PLL
+    const char *registers = DW3000_REGISTERS_H;
+    const char *path = NULL;
+    bool verbose = false;
+    bool usage = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--spi-hz") && hasValue)
+            spiHz = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--registers") && hasValue)
+            registers = argv[++i];
+        else if (!strcmp(argv[i], "--verbose"))
+            verbose = true;
+        else if (argv[i][0] != '-' && path == NULL)
+            path = argv[i];
+        else
+            usage = true;
+    }
+    if (usage || path == NULL)
+    {
+        fprintf(stderr, "usage: %s [--spi-hz hz] [--registers dw3000_registers.h] [--verbose] trace\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<Record> records;
+    unsigned int mhz = 0;
+    if (!readTrace(path, records, mhz))
+        return 1;
+    if (records.empty())
+    {
+        printf("empty trace\n");
+        return 0;
+    }
+    std::map<uint32_t, std::string> names = readRegisterNames(registers);
+
+    sim::Clock clock;
+    sim::current = &clock;
+    SimAir air;
+    SimChip chip(clock, air);
+    air.add(&chip, 0);
+    SimTransport spi(chip);
+
+    // without the boot in the trace (no CLK_CTRL write), the recorded chip was already running on its PLL
+    bool boot = false;
+    for (const Record &rec : records)
+        boot = boot || (tolower(rec.kind) != 'r' && keyOf(rec) == CLK_CTRL_KEY);
+    chip.setPllLocked(!boot);
+
+    std::vector<std::vector<bool>> written(0x20, std::vector<bool>(0x1000, false));
+    std::map<uint32_t, Stats> stats;
+    Stats total;
+    uint64_t recordedCycles = 0; // since the first transaction, unwrapped
+    uint32_t last = records[0].start;
+
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const Record &rec = records[i];
+        recordedCycles += (uint32_t)(rec.start - last);
+        last = rec.start;
+
+        // the CPU was busy in between, let the chip run for as long as it did
+        uint64_t at = recordedCycles * 1000000ULL / mhz;
+        if (clock.ps < at)
+            clock.ps = at;
+
+        spi.setClock(spiHz ? spiHz : (chip.maxSpiHz() > DW3000_SPI_SLOW_HZ ? DW3000_SPI_FAST_HZ : DW3000_SPI_SLOW_HZ));
+
+        std::vector<uint8_t> buf(rec.len, 0);
+        std::copy(rec.data.begin(), rec.data.begin() + std::min<size_t>(rec.data.size(), rec.len), buf.begin());
+
+        // the same CRC checks as the recorded transport. A CRC checked write means the recorded chip had SYS_CFG SPI_CRC on.
+        bool read = tolower(rec.kind) == 'r';
+        if (isupper(rec.kind))
+            spi.crcMode = read ? DW3000_SPI_CRC_READ_WRITE : DW3000_SPI_CRC_WRITE;
+        else
+            spi.crcMode = DW3000_SPI_CRC_OFF;
+
+        if (!read && keyOf(rec) < FAST_COMMAND_KEY && rec.len > 0)
+        {
+            uint8_t sysCfg;
+            chip.peek(0x00, 0x10, &sysCfg, 1);
+            if (!(sysCfg & SYS_CFG_SPI_CRC) != !isupper(rec.kind))
+            {
+                sysCfg ^= SYS_CFG_SPI_CRC;
+                chip.poke(0x00, 0x10, &sysCfg, 1);
+                total.seeded++;
+            }
+        }
+
+        uint64_t before = clock.ps;
+        spi.transfer(rec.header, rec.headerLen, read ? NULL : buf.data(), read ? buf.data() : NULL, rec.len);
+
+        uint32_t key = keyOf(rec);
+        Stats &s = stats[key];
+        s.count++;
+        s.bytes += rec.headerLen + rec.len;
+        s.cycles += rec.cycles;
+        s.simPs += clock.ps - before;
+
+        if (key & FAST_COMMAND_KEY)
+            continue;
+
+        int base = key >> 16, sub = key & 0xFFFF;
+        size_t n = std::min<size_t>(rec.data.size(), rec.len);
+        if (!read)
+        {
+            for (size_t j = 0; j < rec.len && sub + j < 0x1000; j++)
+                written[base][sub + j] = true;
+            continue;
+        }
+        if (n == 0 || memcmp(buf.data(), rec.data.data(), n) == 0)
+            continue;
+
+        bool ownWrite = false;
+        for (size_t j = 0; j < n && sub + j < 0x1000; j++)
+            ownWrite = ownWrite || written[base][sub + j];
+        if (ownWrite)
+            s.diverged++;
+        else
+            s.seeded++;
+
+        if (verbose)
+        {
+            printf("#%zu %s %s: model", i, ownWrite ? "diverged" : "seeded", nameOf(key, names).c_str());
+            for (size_t j = 0; j < n; j++)
+                printf(" %02x", buf[j]);
+            printf(", recorded");
+            for (size_t j = 0; j < n; j++)
+                printf(" %02x", rec.data[j]);
+            printf("\n");
+        }
+        chip.poke(base, sub, rec.data.data(), n);
+    }
+
+    std::vector<std::pair<uint32_t, Stats>> sorted(stats.begin(), stats.end());
+    std::sort(sorted.begin(), sorted.end(), [](const std::pair<uint32_t, Stats> &a, const std::pair<uint32_t, Stats> &b)
+              { return a.second.cycles > b.second.cycles; });
+    for (auto &entry : sorted)
+    {
+        total.count += entry.second.count;
+        total.bytes += entry.second.bytes;
+        total.cycles += entry.second.cycles;
+        total.simPs += entry.second.simPs;
+        total.seeded += entry.second.seeded;
+        total.diverged += entry.second.diverged;
+    }
+
+    double spanUs = (double)(recordedCycles + records.back().cycles) / mhz;
+    printf("trace:   %u transactions in %.1f us, %.1f us (%.0f%%) of it on the bus, CPU at %u MHz\n",
+           total.count, spanUs, (double)total.cycles / mhz, spanUs > 0 ? 100.0 * total.cycles / mhz / spanUs : 0.0, mhz);
+    printf("replay:  %.1f us on the simulated bus, %u values seeded from the trace, %u reads diverged from the model\n",
+           total.simPs / 1e6, total.seeded, total.diverged);
+    printf("\n%-28s %8s %9s %13s %13s %9s\n", "register", "count", "bytes", "recorded us", "simulated us", "diverged");
+    for (auto &entry : sorted)
+    {
+        const Stats &s = entry.second;
+        printf("%-28s %8u %9llu %13.1f %13.1f %9u\n", nameOf(entry.first, names).c_str(), s.count, (unsigned long long)s.bytes,
+               (double)s.cycles / mhz, s.simPs / 1e6, s.diverged);
+    }
+    return 0;
+}
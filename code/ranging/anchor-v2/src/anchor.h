@@ -3,22 +3,59 @@
 #include <WiFi.h>
 #include <WiFiClient.h>
 
+#define DW3000_SHADOW_REGISTERS 1
+#ifndef DW3000_FAST_BOOT
+#define DW3000_FAST_BOOT 1 // poll the chip out of its resets and keep the OTP calibration in NVS
+#endif
+#ifndef DW3000_SPI_CRC
+#define DW3000_SPI_CRC DW3000_SPI_CRC_OFF // DW3000_SPI_CRC_READ_WRITE repeats corrupted and lost transactions, at 3 extra reads per write
+#endif
+#ifndef DW3000_TRACE_DEPTH
+#define DW3000_TRACE_DEPTH 256 // SPI transactions kept for the "trace" command
+#endif
+
 #include "dw3000_registers.h"
 #include "dw3000_api.h"
-
-// SPI Setup
-#define RST_PIN 27
-#define CHIP_SELECT_PIN 4
+#include "dw3000_config.h"
+#include "dw3000_nvs.h"
+#include "dw3000_temp.h"
 
 #define HSPI 2  // 2 for S2 and S3, 1 for S1
 #define VSPI 3
 
+#ifndef RANGING_CHANNEL
+#define RANGING_CHANNEL 5 // 5 or 9, the same on the tag and all anchors
+#endif
+#ifndef RANGING_PROFILE
+#define RANGING_PROFILE DW3000PhyLongRange // PHY profile (dw3000_config.h), the same on the tag and all anchors: DW3000PhyLongRange or DW3000PhyFast
+#endif
+#ifndef RANGING_ADAPTIVE_PHY
+#define RANGING_ADAPTIVE_PHY 1 // the tag switches each anchor link between the DW3000PhyProfiles, links start on the long range profile
+#endif
+#ifndef RANGING_TEMP_MONITOR
+#define RANGING_TEMP_MONITOR 1 // sample the chip temperature while idle and recalibrate the radio when it drifted
+#endif
+#ifndef RANGING_IRQ
+#define RANGING_IRQ 0 // Set to 1 when the IRQ pins of the DWM3000s are wired to AnchorBoard::irqPin (and AnchorBoard2::irqPin): the loop sleeps until a radio has news instead of polling SYS_STATUS
+#endif
+#ifndef ANCHOR_RX_DOUBLE_BUFFER
+#define ANCHOR_RX_DOUBLE_BUFFER 0 // Set to 1 for both RX buffers of the DWM3000: a poll that arrives while the radio still holds the last frame is kept instead of lost, every frame on the air costs the loop a look though
+#endif
+#define ANCHOR_PHY_FALLBACK_MS 1000 // back to the profile of the cell and full TX power when no frame arrived for this long, so a lost tag finds the anchor again
+
+#define CIR_COMMAND_MAX_SAMPLES 64 // accumulator samples one "cir" command sends at most (stack buffer of 6 bytes each)
+
 // Set to 1 for Anchor 1, 2 for Anchor 2
 #define ANCHOR_ID 1
-#define RESPONSE_TIMEOUT_MS 10 // Maximum time to wait for a response
-unsigned long last_ranging_time = 0;
+#ifndef ANCHOR_SECOND_RADIO
+#define ANCHOR_SECOND_RADIO 0 // Set to 1 when a second DWM3000 is wired to HSPI (AnchorBoard2), it ranges as ANCHOR_ID_2 with its own state machine
+#endif
+#define ANCHOR_ID_2 (ANCHOR_ID + 1)
+#define RESPONSE_TURNAROUND_MIN_US 20   // the tag answers no sooner than this after the end of a frame, the receiver turns on then (setResponseWindow())
+#define RESPONSE_TURNAROUND_MAX_US 5000 // nor later, the radio gives up on an answer that did not start by then
+#define RESPONSE_MAX_LEN 4              // the tag answers with a ds_sendFrame()
+#define RESPONSE_BACKSTOP_MS 20         // gives up in software if the radio does not (window plus airtime of a long range answer: ~10 ms)
 #define MAX_RETRIES 3
-int retry_count = 0;
 
 // WiFi Configuration
 #include "wificonfig.h"
@@ -31,59 +68,42 @@ bool wifiConnected = false;
 #define BOARD_ESP32_WROOM_DEVBOARD
 // #define BOARD_ESP32_WT32_ETH01
 
-#ifdef BOARD_ESP32_WROOM_DEVBOARD
-//ESP32 WROOM
-const int HSPI_MISO = 19;
-const int HSPI_MOSI = 23;
-const int HSPI_SCLK = 18;
-const int HSPI_SS = 4;
-
-const int VSPI_MISO = 19;
-const int VSPI_MOSI = 23;
-const int VSPI_SCLK = 18;
-const int VSPI_SS = 4;
-#define CHIP_SELECT_PIN 4 // ESP32 WROOM
-#endif
-
 #ifdef BOARD_ESP32_WT32_ETH01
-//WT32-ETH01
-const int HSPI_MISO = 15;
-const int HSPI_MOSI = 12;
-const int HSPI_SCLK = 14;
-const int HSPI_SS = 5;
-
-const int VSPI_MISO = 15;
-const int VSPI_MOSI = 12;
-const int VSPI_SCLK = 14;
-const int VSPI_SS = 5;
-#define CHIP_SELECT_PIN 5 // WT32-ETH01
+typedef DW3000BoardWt32Eth01 AnchorBoard;
+#if ANCHOR_SECOND_RADIO
+#error "The WT32-ETH01 has no pins left for a second DWM3000"
+#endif
+#else
+typedef DW3000BoardEsp32Wroom AnchorBoard;
+typedef DW3000BoardEsp32WroomHspi AnchorBoard2;
 #endif
 
-
-
-static int rx_status;
-static int tx_status;
-
-static int curr_stage = 0;
-
-static int t_roundB = 0;
-static int t_replyB = 0;
-
-static long long rx = 0;
-static long long tx = 0;
-
-
-
+#if RANGING_ADAPTIVE_PHY
+typedef DW3000PhyLongRange<RANGING_CHANNEL == 9 ? CHANNEL_9 : CHANNEL_5> AnchorPhy;
+#else
+typedef RANGING_PROFILE<RANGING_CHANNEL == 9 ? CHANNEL_9 : CHANNEL_5> AnchorPhy;
+#endif
 
 #define DEBUG_OUTPUT 0 // Turn to 1 to get all reads, writes, etc. as info in the console
 static int ANTENNA_DELAY = 16350;
 
 int led_status = 0;
 
-int destination = 0x0; // Default Values for Destination and Sender IDs
-int sender = 0x0;
-
 SPIClass vspi = SPIClass(VSPI);
+#if DW3000_USE_IDF_SPI
+DW3000IdfSpi vspiTransport(SPI3_HOST);
+#else
+DW3000ArduinoSpi vspiTransport(vspi);
+#endif
+
+#if ANCHOR_SECOND_RADIO
+SPIClass hspi = SPIClass(HSPI);
+#if DW3000_USE_IDF_SPI
+DW3000IdfSpi hspiTransport(SPI2_HOST);
+#else
+DW3000ArduinoSpi hspiTransport(hspi);
+#endif
+#endif
 
 // WiFi Functions
 void connectToWiFi()
@@ -113,24 +133,21 @@ void connectToWiFi()
 }
 
 // extern DWM3000Class DWM3000;
-DWM3000Class::Config config = {
-    vspi,               // Use VSPI
-    CHIP_SELECT_PIN,   // CS Pin
-    RST_PIN,           // RST Pin
-    VSPI_MOSI,         // MOSI Pin
-    VSPI_MISO,         // MISO Pin
-    VSPI_SCLK,         // SCK Pin
-    ANTENNA_DELAY,     // Antenna Delay
-    CHANNEL_5,         // Channel
-    PREAMBLE_4096,     // Preamble Length
-    9,                 // Preamble Code (Same for RX and TX!)
-    PAC8,              // PAC
-    DATARATE_850KB,    // Datarate
-    PHR_MODE_STANDARD, // PHR Mode
-    PHR_RATE_850KB     // PHR Rate
+DWM3000Switchable<AnchorBoard, AnchorPhy>::Config config = {
+    &vspiTransport, // Use VSPI
+    ANTENNA_DELAY   // Antenna Delay
 };
 
-DWM3000Class dwm(config);
+DWM3000Switchable<AnchorBoard, AnchorPhy> dwm(config);
+
+#if ANCHOR_SECOND_RADIO
+DWM3000Switchable<AnchorBoard2, AnchorPhy>::Config config2 = {
+    &hspiTransport, // Use HSPI
+    ANTENNA_DELAY   // Antenna Delay, calibrate it per radio
+};
+
+DWM3000Switchable<AnchorBoard2, AnchorPhy> dwm2(config2);
+#endif
 
 // Initial Radio Configuration
 // int DWM3000Class::config = {
@@ -143,69 +160,507 @@ DWM3000Class dwm(config);
 //     PHR_RATE_850KB     // PHR Rate
 // };
 
+static bool irq_events = RANGING_IRQ; // wait for frames on the IRQ lines, set before setup()
+static bool rx_double_buffer = ANCHOR_RX_DOUBLE_BUFFER; // both RX buffers of the radios, set before setup()
 
+/*
+ Responder side of the double-sided ranging for one radio: answers the ranging requests addressed to its anchor ID.
+ Every DWM3000 of the board gets its own instance, the state of an exchange lives in it,
+ so two radios range with two tags at the same time without waiting for each other.
+*/
+template <class Radio>
+class AnchorEngine
+{
+public:
+  AnchorEngine(Radio &dwm, int anchor_id, const char *nvs_key, uint8_t irq_pin)
+      : dwm(dwm), calibrationStore(nvs_key), irq_pin(irq_pin), sender(anchor_id)
+  {
+  }
 
+  DW3000Irq irq; // IRQ line of the radio, only with irq_events
+  DW3000RxStats rx_stats[3]; // receives in stage 0 (requests) and 2 (responses), the "rxerr" command
 
-void resetRadio()
-{
-  Serial.println("[INFO] Performing radio reset...");
-  dwm.softReset();
-  delay(100);
-  dwm.clearSystemStatus();
-  dwm.configureAsTX();
-  dwm.standardRX();
-}
+  void resetRadio()
+  {
+    Serial.println("[INFO] Performing radio reset...");
+    unsigned long start = millis();
+    dwm.softReset();
+    dwm.waitForIDLE(100);
+    if (irq_events)
+      dwm.enableInterrupts(&irq); // the reset cleared SYS_ENABLE
+    dwm.clearSystemStatus();
+    dwm.configureAsTX();
+    if (rx_double_buffer)
+      dwm.setDoubleBuffer(true); // the reset turned it off
+    listen();
+    Serial.print("[INFO] Radio reset took ");
+    Serial.print(millis() - start);
+    Serial.println(" ms");
+  }
 
-void setup()
-{
-  Serial.begin(115200);
-  dwm.begin();
-  dwm.hardReset();
-  delay(200);
+  void setup()
+  {
+    dwm.begin();
+    dwm.hardReset();
+    dwm.waitForIDLE(200);
+
+    if (!dwm.checkSPI())
+    {
+      Serial.println("[ERROR] Could not establish SPI Connection to DWM3000!");
+      while (1)
+        ;
+    }
+
+    while (!dwm.checkForIDLE())
+    {
+      Serial.println("[ERROR] IDLE1 FAILED\r");
+      delay(1000);
+    }
 
-  if (!dwm.checkSPI())
+    dwm.softReset();
+
+    if (!dwm.waitForIDLE(200))
+    {
+      Serial.println("[ERROR] IDLE2 FAILED\r");
+      while (1)
+        ;
+    }
+
+    calibrationStore.load(dwm.calibration);
+    dwm.init();
+    calibrationStore.store(dwm.calibration, dwm.calibrationFromCache);
+    dwm.setupGPIO();
+    if (irq_events)
+    {
+      irq.begin(irq_pin);
+      dwm.enableInterrupts(&irq);
+    }
+
+    // Set antenna delay - calibrate this for your hardware!
+    dwm.setTXAntennaDelay(16350);
+    dwm.setResponseWindow(RESPONSE_TURNAROUND_MIN_US, RESPONSE_TURNAROUND_MAX_US, RESPONSE_MAX_LEN);
+    if (rx_double_buffer)
+      dwm.setDoubleBuffer(true);
+
+    Serial.print("> ANCHOR ");
+    Serial.print(sender);
+    Serial.println(" - Ready for ranging <");
+    Serial.print("Antenna delay set to: ");
+    Serial.println(dwm.getTXAntennaDelay());
+    Serial.print("PHY profile: ");
+    Serial.print(RANGING_ADAPTIVE_PHY ? "adaptive" : AnchorPhy::name);
+    Serial.print(", channel ");
+    Serial.println(RANGING_CHANNEL);
+    Serial.println("[INFO] Setup finished.");
+  }
+
+  /*
+   Starts listening for ranging requests. Only once every radio of the board is set up:
+   a request that arrives while the loop is still busy with the setup of another radio would be answered late
+  */
+  void start()
   {
-    Serial.println("[ERROR] Could not establish SPI Connection to DWM3000!");
-    while (1)
-      ;
+    dwm.configureAsTX();
+    dwm.clearSystemStatus();
+    listen();
   }
 
-  while (!dwm.checkForIDLE())
+  /*
+   True while the state machine waits for the radio: its next step has nothing to do until the IRQ line rises or a timer runs out
+  */
+  bool waiting() const
   {
-    Serial.println("[ERROR] IDLE1 FAILED\r");
-    delay(1000);
+    return (curr_stage == 0 || curr_stage == 2) && !dwm.rxFrameWaiting();
   }
 
-  dwm.softReset();
-  delay(200);
+  /*
+   Sends the outcome of the receives per stage (0: requests, 2: responses) and why they failed, one line each
+  */
+  void printRxStats(Print &out)
+  {
+    for (int stage = 0; stage < 3; stage += 2)
+    {
+      out.print("A" + String(sender) + " stage " + String(stage) + " ");
+      rx_stats[stage].print(out);
+    }
+  }
 
-  if (!dwm.checkForIDLE())
+  void clearRxStats()
   {
-    Serial.println("[ERROR] IDLE2 FAILED\r");
-    while (1)
-      ;
+    for (DW3000RxStats &stats : rx_stats)
+      stats.clear();
   }
 
-  dwm.init();
-  dwm.setupGPIO();
+  /*
+   One step of the state machine, returns without waiting for the radio
+  */
+  void loop()
+  {
+    step_status = -1;
+    if (frameStatus() == 1 && dwm.ds_getStage() == 1 && dwm.getDestinationID() == sender)
+    {
+      // Reset session if new ranging request arrives
+      if (curr_stage != 0)
+      {
+        Serial.println("[INFO] New request - resetting session");
+        curr_stage = 0;
+        t_roundB = 0;
+        t_replyB = 0;
+      }
+    }
+    switch (curr_stage)
+    {
+    case 0: // Await ranging
+      t_roundB = 0;
+      t_replyB = 0;
+
+      if (rx_status = frameStatus())
+      {
+        rx_stats[0].add(rx_status, dwm.rxErrors);
+        dwm.clearSystemStatus();
+        if (rx_status == 1)
+        { // If frame reception was successful
+          // Only respond if frame is addressed to us
+          if (dwm.getDestinationID() == sender)
+          {
+            last_frame_ms = millis();
+            if (dwm.ds_isErrorFrame())
+            {
+              Serial.println("[WARNING] Received error frame!");
+              curr_stage = 0;
+              listen();
+            }
+            else if (dwm.ds_getStage() != 1)
+            {
+              if (dwm.ds_getStage() == 5)
+              {
+                // PHY or TX power switch request, checked only here so a ranging request costs no extra read
+                int profile, backoff;
+                dwm.ds_readPhyFrame(&profile, &backoff);
+                switchPhy(profile, backoff, dwm.getSenderID());
+              }
+              else if (dwm.ds_getStage() == 7)
+              {
+                // cell wide switch announced by the tag
+                int channel, profile, delayMs;
+                dwm.ds_readProfileFrame(&channel, &profile, &delayMs);
+                scheduleCell(channel, profile, delayMs, dwm.getSenderID());
+              }
+              else
+              {
+                Serial.print("[WARNING] Unexpected stage: ");
+                Serial.println(dwm.ds_getStage());
+                // DWM3000.ds_sendErrorFrame(); // turned this off experimentally
+                dwm.clearSystemStatus();
+                curr_stage = 0;
+                listen();
+              }
+            }
+            else
+            {
+              curr_stage = 1;
+            }
+          }
+          else
+          {
+            // Not for us, go back to RX
+            listen();
+          }
+        }
+        else
+        {
+          Serial.println("[ERROR] Receiver Error occurred!");
+          dwm.clearSystemStatus();
+          listen();
+          curr_stage = 0;
+        }
+      }
+      else if (cell_switch_pending && (long)(millis() - cell_switch_ms) >= 0)
+      {
+        switchCell();
+      }
+      else if ((phy_level != cell_profile || tx_backoff != 0) && millis() - last_frame_ms > ANCHOR_PHY_FALLBACK_MS)
+      {
+        Serial.println("[WARNING] Link idle, back to the PHY profile of the cell at full TX power");
+        phy_level = cell_profile;
+        tx_backoff = 0;
+        dwm.setPhy(dw3000PhyProfile(cell_channel, cell_profile));
+        dwm.setTXPower(DW3000_TX_POWER_MAX);
+        dwm.clearSystemStatus();
+        listen();
+      }
+      else if (RANGING_TEMP_MONITOR && temperature.service(dwm))
+      {
+        Serial.print("[INFO] Recalibrated at ");
+        Serial.print(dwm.temperature);
+        Serial.println(" C");
+        dwm.clearSystemStatus();
+        listen();
+      }
+      break;
+
+    case 1: // Ranging received. Sending response
+      dwm.ds_sendFrame(2, sender, destination);
+
+      rx = dwm.readRXTimestamp();
+      tx = dwm.readTXTimestamp();
+      dwm.releaseRxBuffer(); // done with the request, the answer lands in the other buffer
+
+      t_replyB = tx - rx;
+      curr_stage = 2;
+      last_ranging_time = millis(); // Reset timeout timer
+      break;
+
+    case 2: // Awaiting response
+      rx_status = frameStatus();
+      if (rx_status == 3 || (rx_status == 0 && millis() - last_ranging_time > RESPONSE_BACKSTOP_MS))
+      {
+        rx_stats[2].add(3, rx_status ? dwm.rxErrors : 0); // 0: the radio never ended the wait
+        Serial.println("[WARNING] Timeout waiting for second response");
+        if (++retry_count > MAX_RETRIES)
+        {
+          Serial.println("[ERROR] Max retries reached, resetting radio");
+          resetRadio();
+          retry_count = 0;
+        }
+        dwm.clearSystemStatus();
+        curr_stage = 0;
+        listen();
+      }
+      else if (rx_status)
+      {
+        rx_stats[2].add(rx_status, dwm.rxErrors);
+        retry_count = 0; // Reset on successful response
+        dwm.clearSystemStatus();
+        if (rx_status == 1)
+        { // If frame reception was successful
+          if (dwm.ds_isErrorFrame())
+          {
+            Serial.println("[WARNING] Received error frame!");
+            curr_stage = 0;
+            listen();
+          }
+          else if (dwm.ds_getStage() != 3)
+          {
+            Serial.print("[WARNING] Unexpected stage: ");
+            Serial.println(dwm.ds_getStage());
+            // DWM3000.ds_sendErrorFrame(); // turned this off experimentally
+            dwm.clearSystemStatus();
+            curr_stage = 0;
+            listen();
+          }
+          else
+          {
+            curr_stage = 3;
+          }
+        }
+        else
+        {
+          Serial.println("[ERROR] Receiver Error occurred!");
+          dwm.clearSystemStatus();
+          curr_stage = 0;
+          listen();
+        }
+      }
+      break;
 
-  // Set antenna delay - calibrate this for your hardware!
-  dwm.setTXAntennaDelay(16350);
+    case 3: // Second response received. Sending information frame
+      rx = dwm.readRXTimestamp();
+      t_roundB = rx - tx;
+      dwm.ds_sendRTInfo(t_roundB, t_replyB, sender, destination);
+
+      if (first_range_ms == 0)
+      {
+        first_range_ms = millis();
+        Serial.print("[INFO] Boot to first range: ");
+        Serial.print(first_range_ms);
+        Serial.println(" ms");
+      }
 
-  // Set anchor ID
-  // DWM3000.setSenderID(ANCHOR_ID);
-  sender = ANCHOR_ID;
+      curr_stage = 0;
+      listen();
+      break;
 
-  Serial.print("> ANCHOR ");
-  Serial.print(ANCHOR_ID);
-  Serial.println(" - Ready for ranging <");
-  Serial.print("Antenna delay set to: ");
-  Serial.println(dwm.getTXAntennaDelay());
-  Serial.println("[INFO] Setup finished.");
+    default:
+      Serial.print("[ERROR] Entered unknown stage (");
+      Serial.print(curr_stage);
+      Serial.println("). Reverting back to stage 0");
 
-  dwm.configureAsTX();
-  dwm.clearSystemStatus();
-  dwm.standardRX();
+      curr_stage = 0;
+      listen();
+      break;
+    }
+  }
+
+private:
+  /*
+   Hands the frame the radio holds back to it and listens for the next one
+  */
+  void listen()
+  {
+    dwm.releaseRxBuffer();
+    dwm.standardRX();
+  }
+
+  /*
+   Checks the radio for a frame. With irq_events a low IRQ line means nothing happened, and SYS_STATUS gets read at most once per step.
+   @return Like receivedFrameSucc(): 1 if a frame was received; 2 on a receiver error; 3 on a receive timeout; 0 if nothing happened
+  */
+  int frameStatus()
+  {
+    if (!irq_events)
+    {
+      return dwm.receivedFrameSucc();
+    }
+    if (step_status < 0)
+    {
+      step_status = irq.pending() || dwm.rxFrameWaiting() ? dw3000FrameStatus(dwm.readEvents()) : 0;
+    }
+    return step_status;
+  }
+
+  /*
+   Confirms a PHY or TX power switch the tag asked for with the current settings, then changes to the new ones
+   @param profile Index into DW3000PhyProfiles of the cell channel
+   @param backoff TX power in fine steps below the maximum
+   @param tag ID of the tag that asked
+  */
+  void switchPhy(int profile, int backoff, int tag)
+  {
+    if (profile < 0 || profile >= DW3000_PHY_PROFILE_COUNT)
+    {
+      Serial.print("[WARNING] Unknown PHY profile: ");
+      Serial.println(profile);
+      listen();
+      return;
+    }
+
+    dwm.ds_sendPhyFrame(6, profile, backoff, sender, tag);
+    if (profile != phy_level)
+    {
+      phy_level = profile;
+      dwm.setPhy(dw3000PhyProfile(cell_channel, profile));
+    }
+    if (backoff != tx_backoff)
+    {
+      tx_backoff = backoff;
+      dwm.setTXPower(dw3000TxPowerBackoff(backoff));
+    }
+    dwm.clearSystemStatus();
+    listen();
+
+    Serial.print("[INFO] Switched to PHY profile ");
+    Serial.print(dw3000PhyProfile(cell_channel, profile).name);
+    Serial.print(", TX power ");
+    Serial.print(-backoff * DW3000_TX_POWER_FINE_STEP_DB);
+    Serial.println(" dB");
+  }
+
+  /*
+   Confirms a cell wide switch to the tag and schedules it, a delay of 0 switches right away (the anchor missed the switch)
+   @param channel CHANNEL_5 or CHANNEL_9
+   @param profile Index into DW3000PhyProfiles
+   @param delayMs Time until the switch
+   @param tag ID of the tag that announced it
+  */
+  void scheduleCell(int channel, int profile, int delayMs, int tag)
+  {
+    if ((channel != CHANNEL_5 && channel != CHANNEL_9) || profile < 0 || profile >= DW3000_PHY_PROFILE_COUNT)
+    {
+      Serial.print("[WARNING] Unknown cell settings: channel ");
+      Serial.print(channel);
+      Serial.print(", profile ");
+      Serial.println(profile);
+      listen();
+      return;
+    }
+
+    dwm.ds_sendProfileFrame(7, channel, profile, delayMs, sender, tag);
+    cell_next_channel = channel;
+    cell_next_profile = profile;
+    cell_switch_ms = millis() + delayMs;
+    cell_switch_pending = true;
+    if (delayMs == 0)
+    {
+      switchCell();
+      return;
+    }
+    dwm.clearSystemStatus();
+    listen();
+  }
+
+  /*
+   Moves the radio to the scheduled cell settings: the profile of the cell at full TX power, like the tag does with every link
+  */
+  void switchCell()
+  {
+    cell_switch_pending = false;
+    cell_channel = cell_next_channel;
+    cell_profile = cell_next_profile;
+    phy_level = cell_profile;
+    tx_backoff = 0;
+    dwm.setPhy(dw3000PhyProfile(cell_channel, cell_profile));
+    dwm.setTXPower(DW3000_TX_POWER_MAX);
+    dwm.clearSystemStatus();
+    listen();
+
+    Serial.print("[INFO] Cell switched to channel ");
+    Serial.print(cell_channel == CHANNEL_9 ? 9 : 5);
+    Serial.print(", PHY profile ");
+    Serial.println(dw3000PhyProfile(cell_channel, cell_profile).name);
+  }
+
+  Radio &dwm;
+  DW3000CalibrationStore calibrationStore;
+  uint8_t irq_pin;
+  DW3000TempMonitor temperature;
+
+  int rx_status = 0;
+  int step_status = -1; // frameStatus() of the current step with irq_events, -1 before the first look
+  int curr_stage = 0;
+
+  int t_roundB = 0;
+  int t_replyB = 0;
+
+  long long rx = 0;
+  long long tx = 0;
+
+  unsigned long last_ranging_time = 0;
+  int retry_count = 0;
+  unsigned long first_range_ms = 0; // millis() (= time since boot) when this radio answered its first exchange
+  unsigned long last_frame_ms = 0;  // millis() of the last frame addressed to this radio
+  int phy_level = dw3000PhyProfileIndex<AnchorPhy>(); // profile index (DW3000PhyProfiles of the cell channel) the radio is set to
+  int tx_backoff = 0;               // fine TX power steps below the maximum the radio is set to
+
+  uint8_t cell_channel = AnchorPhy::channel;             // channel of the cell
+  int cell_profile = dw3000PhyProfileIndex<AnchorPhy>(); // profile index every link starts on and falls back to
+  uint8_t cell_next_channel = 0;                         // settings of a scheduled cell wide switch
+  int cell_next_profile = 0;
+  unsigned long cell_switch_ms = 0;                      // millis() of the scheduled switch
+  bool cell_switch_pending = false;
+
+  int destination = 0x0; // Default Values for Destination and Sender IDs
+  int sender;            // the anchor ID of this radio
+};
+
+AnchorEngine<decltype(dwm)> anchorEngine(dwm, ANCHOR_ID, "anchor", AnchorBoard::irqPin);
+#if ANCHOR_SECOND_RADIO
+AnchorEngine<decltype(dwm2)> anchorEngine2(dwm2, ANCHOR_ID_2, "anchor2", AnchorBoard2::irqPin);
+#endif
+
+void setup()
+{
+  Serial.begin(115200);
+
+  anchorEngine.setup();
+#if ANCHOR_SECOND_RADIO
+  anchorEngine2.setup();
+#endif
+
+  anchorEngine.start();
+#if ANCHOR_SECOND_RADIO
+  anchorEngine2.start();
+#endif
 }
 
 void handleCommand(const String& cmd) {
@@ -257,6 +712,52 @@ void handleCommand(const String& cmd) {
         // Send bytes back
         client.write((uint8_t*)&value, sizeof(value));
     }
+    else if(action == "temp"){
+        // chip temperature of the last sample, the radio uses it for the recalibration
+        client.println(String(dwm.temperature, 1) + "C");
+    }
+    else if(action == "rxerr"){
+        // "rxerr" sends the outcome of the receives per radio and stage, why they failed (dw3000_rxerr.h), "rxerr clear" starts over
+        if (firstSpace >= 0 && cmd.substring(firstSpace + 1) == "clear") {
+            anchorEngine.clearRxStats();
+#if ANCHOR_SECOND_RADIO
+            anchorEngine2.clearRxStats();
+#endif
+            client.println("rxerr OK");
+        } else {
+            anchorEngine.printRxStats(client);
+#if ANCHOR_SECOND_RADIO
+            anchorEngine2.printRxStats(client);
+#endif
+        }
+    }
+    else if(action == "trace"){
+        // "trace" sends the last SPI transactions (replay them with host/sim/trace_replay.cpp), "trace clear" starts over
+        if (firstSpace >= 0 && cmd.substring(firstSpace + 1) == "clear") {
+            dwm.trace.clear();
+            client.println("trace OK");
+        } else {
+            dwm.trace.dump(client);
+        }
+    }
+    else if(action == "cir"){
+        // "cir <first sample> <samples>" sends the raw accumulator samples of the last frame, 6 bytes each (18 bit real, 18 bit imaginary)
+        if (firstSpace < 0 || secondSpace < 0) {
+            client.println("ERR Invalid format. Use: cir <first sample> <samples>");
+            return;
+        }
+
+        int first   = cmd.substring(firstSpace + 1, secondSpace).toInt();
+        int samples = cmd.substring(secondSpace + 1).toInt();
+        if (first < 0 || samples <= 0 || samples > CIR_COMMAND_MAX_SAMPLES) {
+            client.println("ERR samples must be 1 to " + String(CIR_COMMAND_MAX_SAMPLES));
+            return;
+        }
+
+        uint8_t cir[1 + CIR_COMMAND_MAX_SAMPLES * DW3000_CIR_SAMPLE_LEN];
+        dwm.readAccumulator(first, samples, cir);
+        client.write(cir + 1, samples * DW3000_CIR_SAMPLE_LEN); // cir[0] is the dummy byte of the accumulator
+    }
     else {
         client.println("ERR Unknown command");
     }
@@ -289,157 +790,25 @@ void loop()
       }
   }
 
+  // the radios take turns, a step of one never waits for the other
+  anchorEngine.loop();
+#if ANCHOR_SECOND_RADIO
+  anchorEngine2.loop();
+#endif
 
-
-  if (dwm.receivedFrameSucc() == 1 && dwm.ds_getStage() == 1 && dwm.getDestinationID() == ANCHOR_ID)
-  {
-    // Reset session if new ranging request arrives
-    if (curr_stage != 0)
-    {
-      Serial.println("[INFO] New request - resetting session");
-      curr_stage = 0;
-      t_roundB = 0;
-      t_replyB = 0;
-    }
-  }
-  switch (curr_stage)
+  // with interrupts the loop sleeps until a radio has news, the timers of the engines count milliseconds anyway
+  if (irq_events && anchorEngine.waiting()
+#if ANCHOR_SECOND_RADIO
+      && anchorEngine2.waiting()
+#endif
+  )
   {
-  case 0: // Await ranging
-    t_roundB = 0;
-    t_replyB = 0;
-    last_ranging_time = millis(); // Reset timeout timer
-
-    if (rx_status = dwm.receivedFrameSucc())
-    {
-      dwm.clearSystemStatus();
-      if (rx_status == 1)
-      { // If frame reception was successful
-        // Only respond if frame is addressed to us
-        if (dwm.getDestinationID() == ANCHOR_ID)
-        {
-          if (dwm.ds_isErrorFrame())
-          {
-            Serial.println("[WARNING] Received error frame!");
-            curr_stage = 0;
-            dwm.standardRX();
-          }
-          else if (dwm.ds_getStage() != 1)
-          {
-            Serial.print("[WARNING] Unexpected stage: ");
-            Serial.println(dwm.ds_getStage());
-            // DWM3000.ds_sendErrorFrame(); // turned this off experimentally
-            dwm.clearSystemStatus();
-            curr_stage = 0;
-            dwm.standardRX();
-          }
-          else
-          {
-            curr_stage = 1;
-          }
-        }
-        else
-        {
-          // Not for us, go back to RX
-          dwm.standardRX();
-        }
-      }
-      else
-      {
-        Serial.println("[ERROR] Receiver Error occurred!");
-        dwm.clearSystemStatus();
-        dwm.standardRX();
-        curr_stage = 0;
-      }
-    }
-    else if (millis() - last_ranging_time > RESPONSE_TIMEOUT_MS)
-    {
-      Serial.println("[WARNING] Timeout waiting for ranging request");
-      if (++retry_count > MAX_RETRIES)
-      {
-        Serial.println("[ERROR] Max retries reached, resetting radio");
-        resetRadio();
-        retry_count = 0;
-      }
-      dwm.standardRX(); // Reset to listening mode
-    }
-    break;
-
-  case 1: // Ranging received. Sending response
-    dwm.ds_sendFrame(2, sender, destination);
-
-    rx = dwm.readRXTimestamp();
-    tx = dwm.readTXTimestamp();
-
-    t_replyB = tx - rx;
-    curr_stage = 2;
-    last_ranging_time = millis(); // Reset timeout timer
-    break;
-
-  case 2: // Awaiting response
-    if (rx_status = dwm.receivedFrameSucc())
-    {
-      retry_count = 0; // Reset on successful response
-      dwm.clearSystemStatus();
-      if (rx_status == 1)
-      { // If frame reception was successful
-        if (dwm.ds_isErrorFrame())
-        {
-          Serial.println("[WARNING] Received error frame!");
-          curr_stage = 0;
-          dwm.standardRX();
-        }
-        else if (dwm.ds_getStage() != 3)
-        {
-          Serial.print("[WARNING] Unexpected stage: ");
-          Serial.println(dwm.ds_getStage());
-          // DWM3000.ds_sendErrorFrame(); // turned this off experimentally
-          dwm.clearSystemStatus();
-          curr_stage = 0;
-          dwm.standardRX();
-        }
-        else
-        {
-          curr_stage = 3;
-        }
-      }
-      else
-      {
-        Serial.println("[ERROR] Receiver Error occurred!");
-        dwm.clearSystemStatus();
-        curr_stage = 0;
-        dwm.standardRX();
-      }
-    }
-    else if (millis() - last_ranging_time > RESPONSE_TIMEOUT_MS)
-    {
-      Serial.println("[WARNING] Timeout waiting for second response");
-      if (++retry_count > MAX_RETRIES)
-      {
-        Serial.println("[ERROR] Max retries reached, resetting radio");
-        resetRadio();
-        retry_count = 0;
-      }
-      curr_stage = 0;
-      dwm.standardRX();
-    }
-    break;
-
-  case 3: // Second response received. Sending information frame
-    rx = dwm.readRXTimestamp();
-    t_roundB = rx - tx;
-    dwm.ds_sendRTInfo(t_roundB, t_replyB, sender, destination);
-
-    curr_stage = 0;
-    dwm.standardRX();
-    break;
-
-  default:
-    Serial.print("[ERROR] Entered unknown stage (");
-    Serial.print(curr_stage);
-    Serial.println("). Reverting back to stage 0");
-
-    curr_stage = 0;
-    dwm.standardRX();
-    break;
+    // one wait on the lines of all radios: an event of radio 2 ends it right away, the next loop() services it
+    DW3000Irq *lines[] = {&anchorEngine.irq,
+#if ANCHOR_SECOND_RADIO
+                          &anchorEngine2.irq
+#endif
+    };
+    DW3000Irq::waitAny(lines, sizeof(lines) / sizeof(lines[0]), 1);
   }
-}
\ No newline at end of file
+}
@@ -2,37 +2,293 @@
 
 #include <Arduino.h>
 #include "dw3000_vals_old.h"
-#include "dw3000_macros.h"
-#include <SPI.h>
 #include "dw3000_registers.h"
+#include "dw3000_regs.h"
+#include <SPI.h>
 
 #ifndef DEBUG_OUTPUT
 #define DEBUG_OUTPUT 0
 #endif
 
+#define TX_DONE_TIMEOUT_MS 10 // upper bound for a frame to leave the antenna (a 4096 symbol preamble alone takes ~4.2ms)
+
+#ifndef DW3000_PREAMBLE_TIMEOUT_US
+#define DW3000_PREAMBLE_TIMEOUT_US 0 // preamble detection timeout outside a response window (PRE_TOC, converted to PACs of the configured PHY), 0 keeps the receiver on until a frame arrives
+#endif
+
+#define DW3000_SYMBOL_PS 1017630 // preamble symbol at 64 MHz PRF
+#define DW3000_SFD_SYMBOLS 16    // writeSysConfig() selects the 16 symbol Decawave SFD
+#define DW3000_PHR_BITS 21       // PHR including its SECDED bits
+#define DW3000_BIT_NS_850K 1176  // one bit at 850 kb/s
+#define DW3000_BIT_NS_6M8 147    // one bit at 6.8 Mb/s
+#define DW3000_UUS_PS 1025641    // unit of RX_FWTO and ACK_RESP W4R_TIM: 512 / 499.2 MHz
+#define DW3000_RX_TIMEOUT_MARGIN_US 10 // added to the frame wait timeout of setResponseWindow() for the receiver to finish the frame
+
+#ifndef DW3000_FAST_BOOT
+#define DW3000_FAST_BOOT 0 // Set to 1 to poll SPIRDY/RCINIT after resets instead of sleeping fixed times, and to take the OTP calibration from DWM3000Driver::calibration
+#endif
+
+#define DW3000_IDLE_POLL_US 50 // status poll interval of waitForIDLE() with DW3000_FAST_BOOT
+
+#define DW3000_WAKEUP_CS_US 500 // CS low time that wakes the chip from DEEPSLEEP (AON_CFG WAKE_CSN)
+
+#ifndef DW3000_WAKEUP_TIMEOUT_MS
+#define DW3000_WAKEUP_TIMEOUT_MS 5 // wakeup() gives up when the chip is not back in IDLE after this
+#endif
+
+#ifndef DW3000_SHADOW_REGISTERS
+#define DW3000_SHADOW_REGISTERS 0 // Set to 1 to keep a copy of configuration registers, so read-modify-writes of them skip the SPI read
+#endif
+
+#ifndef DW3000_SPI_CRC
+#define DW3000_SPI_CRC 0 // SPI CRC mode init() turns on: 0 off, 1 writes (DW3000_SPI_CRC_WRITE), 2 reads and writes (DW3000_SPI_CRC_READ_WRITE)
+#endif
+
+#define DW3000_INDIRECT_A 0     // indirect pointer A: INDIRECT_ADDR_A / ADDR_OFFSET_A, data through INDIRECT_PTR_A
+#define DW3000_INDIRECT_B 1     // indirect pointer B: INDIRECT_ADDR_B / ADDR_OFFSET_B, data through INDIRECT_PTR_B
+#define DW3000_CIR_SAMPLE_LEN 6 // bytes per accumulator sample: 3 real, 3 imaginary (18 bit two's complement each)
+
+#ifndef DW3000_USE_IDF_SPI
+#define DW3000_USE_IDF_SPI 0 // Set to 1 to talk to the chip through the ESP-IDF spi_master driver (DMA, queued writes)
+#endif
+
+#include "dw3000_trace.h"
+#include "dw3000_irq.h"
+#include "dw3000_rxerr.h"
+#include "dw3000_transport.h"
+#include "dw3000_spi_arduino.h"
+#if DW3000_USE_IDF_SPI
+#include "dw3000_spi_idf.h"
+#endif
+
+/*
+ Per chip values init() takes from the OTP memory. A sketch can keep them across reboots (see dw3000_nvs.h)
+ and put them back before init(), which then only reads the PARTID to check they belong to this chip (DW3000_FAST_BOOT).
+*/
+struct DW3000Calibration
+{
+    uint32_t partId; // OTP PARTID of the chip the values were read from
+    uint32_t ldoLow;
+    uint32_t ldoHigh;
+    uint32_t biasTune;
+    uint32_t xtalTrim;
+    uint32_t tempRef; // SAR temperature reading at 22 °C
+    bool valid;
+};
+
+/*
+ Analog settings that depend on the channel (values of the Qorvo DW3000 SDK). writeSysConfig() writes the set of
+ the configured channel in one batch, so switching channels is setChannel() and writeSysConfig().
+*/
+struct DW3000ChannelSettings
+{
+    uint32_t rfTxCtrl2;        // RF_TX_CTRL_2
+    uint16_t pllCfg;           // PLL_CFG
+    uint32_t dgcLut[7];        // DGC_LUT_0_CFG ... DGC_LUT_6_CFG, contiguous on the chip
+    uint16_t otpCfg;           // OTP_CFG bits to set: DGC_KICK, and DGC_SEL for the channel 9 DGC values of the OTP
+    float clockOffsetConstant; // DRX_CAR_INT unit, in ppm
+};
+
+constexpr DW3000ChannelSettings DW3000_CHANNEL_5_SETTINGS = {
+    0x1C071134,
+    0x1F3C,
+    {0x0001C0FD, 0x0001C43E, 0x0001C6BE, 0x0001C77E, 0x0001CF36, 0x0001CFB5, 0x0001CFF5},
+    0x0040,
+    CLOCK_OFFSET_CHAN_5_CONSTANT,
+};
+
+constexpr DW3000ChannelSettings DW3000_CHANNEL_9_SETTINGS = {
+    0x1C010034,
+    0x0F3C,
+    {0x0002A8FE, 0x0002AC36, 0x0002A5FE, 0x0002AF3E, 0x0002AF7D, 0x0002AFB5, 0x0002AFB5},
+    0x2040,
+    CLOCK_OFFSET_CHAN_9_CONSTANT,
+};
+
+/*
+ @param channel CHANNEL_5 or CHANNEL_9
+ @return The settings of the channel, a constant for DWM3000<Board, Phy>
+*/
+constexpr const DW3000ChannelSettings &dw3000ChannelSettings(uint8_t channel)
+{
+    return channel == CHANNEL_9 ? DW3000_CHANNEL_9_SETTINGS : DW3000_CHANNEL_5_SETTINGS;
+}
+
+/*
+ PHY derived values. They fold to constants for DWM3000<Board, Phy>, writeSysConfig() writes them.
+*/
+
+/*
+ @param preambleLength PREAMBLE_32 ... PREAMBLE_4096
+ @return The preamble length in symbols
+*/
+constexpr uint16_t dw3000PreambleSymbols(uint8_t preambleLength)
+{
+    return preambleLength == PREAMBLE_32     ? 32
+           : preambleLength == PREAMBLE_64   ? 64
+           : preambleLength == PREAMBLE_128  ? 128
+           : preambleLength == PREAMBLE_256  ? 256
+           : preambleLength == PREAMBLE_512  ? 512
+           : preambleLength == PREAMBLE_1024 ? 1024
+           : preambleLength == PREAMBLE_1536 ? 1536
+           : preambleLength == PREAMBLE_2048 ? 2048
+                                             : 4096;
+}
+
+/*
+ @param pacSize PAC4, PAC8, PAC16 or PAC32
+ @return The preamble acquisition chunk in symbols
+*/
+constexpr uint8_t dw3000PacSymbols(uint8_t pacSize)
+{
+    return pacSize == PAC4 ? 4 : pacSize == PAC16 ? 16 : pacSize == PAC32 ? 32 : 8;
+}
+
+/*
+ PAC size the DW3000 User Manual recommends for a preamble length (longer preambles detect better with bigger chunks)
+ @param preambleLength PREAMBLE_32 ... PREAMBLE_4096
+ @return PAC4, PAC8, PAC16 or PAC32
+*/
+constexpr uint8_t dw3000RecommendedPac(uint8_t preambleLength)
+{
+    return dw3000PreambleSymbols(preambleLength) <= 32    ? PAC4
+           : dw3000PreambleSymbols(preambleLength) <= 128 ? PAC8
+           : dw3000PreambleSymbols(preambleLength) <= 512 ? PAC16
+                                                          : PAC32;
+}
+
+/*
+ SFD detection timeout (RX_SFD_TOC): preamble length + 1 + SFD length - PAC size, in symbols
+*/
+constexpr uint16_t dw3000SfdTimeout(uint8_t preambleLength, uint8_t pacSize)
+{
+    return dw3000PreambleSymbols(preambleLength) + 1 + DW3000_SFD_SYMBOLS - dw3000PacSymbols(pacSize);
+}
+
+/*
+ Preamble detection timeout (PRE_TOC) in PACs, rounded up and limited to the 16 bits of the register
+ @param timeoutUs The time the receiver listens for a preamble, 0 for no timeout
+ @param pacSize PAC4, PAC8, PAC16 or PAC32
+*/
+constexpr uint16_t dw3000PreambleTimeout(uint32_t timeoutUs, uint8_t pacSize)
+{
+    uint64_t pacPs = (uint64_t)dw3000PacSymbols(pacSize) * DW3000_SYMBOL_PS;
+    uint64_t pacs = ((uint64_t)timeoutUs * 1000000 + pacPs - 1) / pacPs;
+    return pacs > 0xFFFF ? 0xFFFF : pacs;
+}
+
+/*
+ Airtime of a frame from its first preamble symbol to its last bit: SHR, PHR and the Reed-Solomon coded payload
+ @param len Length of the frame in bytes, including the FCS
+*/
+constexpr uint32_t dw3000FrameUs(uint8_t preambleLength, uint8_t dataRate, uint8_t phrRate, uint16_t len)
+{
+    return ((uint64_t)(dw3000PreambleSymbols(preambleLength) + DW3000_SFD_SYMBOLS) * DW3000_SYMBOL_PS / 1000 +
+            DW3000_PHR_BITS * (phrRate == PHR_RATE_6_8MB ? DW3000_BIT_NS_6M8 : DW3000_BIT_NS_850K) +
+            (uint64_t)len * 8 * 378 / 330 * (dataRate == DATARATE_6_8MB ? DW3000_BIT_NS_6M8 : DW3000_BIT_NS_850K) + 999) /
+           1000;
+}
+
+/*
+ Converts µs to the UUS of RX_FWTO and W4R_TIM, limited to the 20 bits of both fields
+ @param roundUp True for a timeout (never shorter than asked), false for a delay (never longer)
+*/
+constexpr uint32_t dw3000Uus(uint32_t us, bool roundUp)
+{
+    uint64_t uus = ((uint64_t)us * 1000000 + (roundUp ? DW3000_UUS_PS - 1 : 0)) / DW3000_UUS_PS;
+    return uus > 0xFFFFF ? 0xFFFFF : uus;
+}
+
+/*
+ TX power: TX_POWER holds a setting for every part of a frame (bytes: data, PHR, SHR, STS), each a 2 bit coarse gain
+ in bits 1-0 and a 6 bit fine gain in bits 7-2. One fine step changes the output by about DW3000_TX_POWER_FINE_STEP_DB.
+*/
+#define DW3000_TX_POWER_MAX 0xFFFFFFFF  // coarse 3, fine 63 in every part
+#define DW3000_TX_POWER_FINE_STEP_DB 0.25f
+#define DW3000_PG_DELAY 0x34 // TX_CTRL_HI TX_PG_DELAY (pulse shape) of the Qorvo SDK, the same on channel 5 and 9
+
+/*
+ Crystal trim: XTAL_TRIM pulls the crystal, a higher value lowers its frequency. The 6 bit range covers roughly ±25 ppm.
+*/
+#define DW3000_XTAL_TRIM_DEFAULT 0x2E // used when the OTP holds no trim
+#define DW3000_XTAL_TRIM_MAX 0x3F
+#define DW3000_XTAL_TRIM_PPM_PER_STEP 0.8f // approximate
+
+/*
+ Temperature drift: the antenna delays grow with the temperature of the chip, convertToCM() takes the growth since the
+ antenna delay was calibrated off the time of flight. The coefficient is the time of flight bias one node adds per °C (~2.2 mm/°C), to be measured per board.
+*/
+#define DW3000_ANTENNA_DELAY_CAL_TEMP 25.0f     // °C at which ANTENNA_DELAY was calibrated
+#define DW3000_ANTENNA_DELAY_TICKS_PER_C 0.46f  // approximate
+#define DW3000_RECAL_TEMP_DELTA 20.0f           // °C away from the last PLL lock and RX calibration that make recalibrate() worth it
+
+/*
+ @param coarse Coarse gain, 0 to 3
+ @param fine Fine gain, 0 to 63
+ @return TX_POWER with the same gain for every part of the frame
+*/
+constexpr uint32_t dw3000TxPower(uint8_t coarse, uint8_t fine)
+{
+    return 0x01010101UL * (uint32_t)(((fine & 0x3F) << 2) | (coarse & 0x3));
+}
+
+/*
+ @param steps Fine gain steps below the maximum, limited to 63
+ @return TX_POWER for DW3000_TX_POWER_MAX lowered by steps * DW3000_TX_POWER_FINE_STEP_DB
+*/
+constexpr uint32_t dw3000TxPowerBackoff(uint8_t steps)
+{
+    return dw3000TxPower(3, steps > 63 ? 0 : 63 - steps);
+}
 
+/*
+ A complete set of radio settings, for switching between PHY profiles at runtime (setPhy()).
+ dw3000Phy<Phy>() (dw3000_config.h) makes one from a compile time profile.
+*/
+struct DW3000Phy
+{
+    const char *name;
+    uint8_t channel;
+    uint8_t preambleLength;
+    uint8_t preambleCode;
+    uint8_t pacSize;
+    uint8_t dataRate;
+    uint8_t phrMode;
+    uint8_t phrRate;
+};
 
+/*
+ Runtime configuration: pins and radio settings are chosen when the sketch starts and can be changed with the setters.
+ For a fixed board and PHY, DWM3000<Board, Phy> (dw3000_config.h) takes them as compile time constants instead.
+*/
+struct DWM3000Config
+{
+    DW3000Transport *transport;
+    uint8_t csPin, rstPin, mosiPin, misoPin, sckPin;
+    int antennaDelay;
+    uint8_t channel;
+    uint8_t preambleLength;
+    uint8_t preambleCode;
+    uint8_t pacSize;
+    uint8_t dataRate;
+    uint8_t phrMode;
+    uint8_t phrRate;
+};
 
-class DWM3000Class
+/*
+ The driver, parameterized over its configuration type.
+ ConfigT needs the members of DWM3000Config, but they may be static constexpr: the compiler then folds the pins
+ and the radio settings into the code. The Radio Settings setters only compile for a runtime configuration.
+*/
+template <class ConfigT>
+class DWM3000Driver
 {
 public:
-    struct Config
-    {
-        SPIClass spi;
-        uint8_t csPin, rstPin, mosiPin, misoPin, sckPin;
-        int antennaDelay;
-        uint8_t channel;
-        uint8_t preambleLength;
-        uint8_t preambleCode;
-        uint8_t pacSize;
-        uint8_t dataRate;
-        uint8_t phrMode;
-        uint8_t phrRate;
-    };
+    typedef ConfigT Config;
     // int config[9];
     Config config;
 
-    DWM3000Class(Config mconfig);
+    DWM3000Driver(Config mconfig);
 
     // Chip Setup
     void spiSelect(uint8_t cs);
@@ -41,16 +297,22 @@ public:
     void init();
 
     void writeSysConfig();
+    void writePhyConfig();
     void configureAsTX();
     void setupGPIO();
 
     // Double-Sided Ranging
     void ds_sendFrame(int stage, int destinationID, int senderID);
     void ds_sendRTInfo(int t_roundB, int t_replyB, int destinationID, int senderID);
+    void ds_readRTInfo(int *t_roundB, int *t_replyB);
     int ds_processRTInfo(int t_roundA, int t_replyA, int t_roundB, int t_replyB, int clock_offset);
     int ds_getStage();
     bool ds_isErrorFrame();
     void ds_sendErrorFrame();
+    void ds_sendPhyFrame(int stage, int profile, int txBackoff, int senderID, int destinationID);
+    void ds_readPhyFrame(int *profile, int *txBackoff);
+    void ds_sendProfileFrame(int stage, int channel, int profile, int delayMs, int senderID, int destinationID);
+    void ds_readProfileFrame(int *channel, int *profile, int *delayMs);
 
     // Radio Settings
     void setChannel(uint8_t data);
@@ -60,6 +322,12 @@ public:
     void setDatarate(uint8_t data);
     void setPHRMode(uint8_t data);
     void setPHRRate(uint8_t data);
+    void setPhy(const DW3000Phy &phy);
+    void setTXPower(uint32_t power);
+    void setPGDelay(uint8_t delay);
+    uint32_t getTXPower();
+    uint8_t getPGDelay();
+    void setXtalTrim(uint8_t trim);
 
     // Protocol Settings
     void setMode(int mode);
@@ -67,12 +335,26 @@ public:
     void setFrameLength(int frame_len);
     void setTXAntennaDelay(int delay);
 
+    // Receive Timeouts
+    void setResponseWindow(uint32_t earliestUs, uint32_t latestUs, uint16_t frameLen);
+
+    // Double Buffered RX
+    void setDoubleBuffer(bool enabled);
+    void releaseRxBuffer();
+    int rxBuffer();
+    bool rxFrameWaiting();
+    bool doubleBuffer = false;    // setDoubleBuffer(), a reset turns it off
+    uint32_t rxBufferSwaps = 0;   // buffers releaseRxBuffer() handed back to the chip
+    uint32_t rxBufferBacklog = 0; // frames that were already waiting in the other buffer when the host got done with one
+
     // Status Checks
     int receivedFrameSucc();
+    uint32_t rxErrors = 0; // DW3000RxError bits of the last failed receive that receivedFrameSucc() or readEvents() saw
     int sentFrameSucc();
     int getSenderID();
     int getDestinationID();
     bool checkForIDLE();
+    bool waitForIDLE(uint32_t timeoutMs);
     bool checkSPI();
 
     // Radio Analytics
@@ -83,22 +365,71 @@ public:
     long double getClockOffset(int32_t ext_clock_offset);
     int getRawClockOffset();
     float getTempInC();
-
+    void startTemperature();
+    bool readTemperature(float *celsius);
 
     unsigned long long readRXTimestamp();
     unsigned long long readTXTimestamp();
 
     // Chip Interaction
-    uint32_t writereg(int registerID, uint32_t data, int data_len);
+    uint32_t read(const DW3000Register &reg);
+    uint32_t read(const DW3000Field &field);
+    void write(const DW3000Register &reg, uint32_t data);
+    void write(const DW3000Field &field, uint32_t value);
+    void readBytes(const DW3000Register &reg, uint8_t *dst, uint16_t len);
+    void writeBytes(const DW3000Register &reg, const uint8_t *src, uint16_t len);
+
     uint32_t write(int base, int sub, uint32_t data, int data_len);
-    uint32_t write(int registerID, uint32_t data);
     uint32_t write(int base, int sub, uint32_t data);
 
-    uint32_t read(int registerID);
     uint32_t read(int base, int sub);
     uint8_t read8bit(int base, int sub);
     uint32_t readOTP(uint8_t addr);
 
+    void readBytes(int base, int sub, uint8_t *dst, uint16_t len);
+    void writeBytes(int base, int sub, const uint8_t *src, uint16_t len);
+
+    void beginBatch();
+    void endBatch();
+
+    // Indirect Access
+    void setIndirectPointer(uint8_t pointer, const DW3000Register &reg, uint16_t offset);
+    void readIndirect(uint8_t pointer, uint8_t *dst, uint16_t len);
+    void writeIndirect(uint8_t pointer, const uint8_t *src, uint16_t len);
+    void readAccumulator(uint16_t firstSample, uint16_t samples, uint8_t *dst);
+
+    // SPI CRC
+    void enableSpiCrc(uint8_t mode);
+
+    // OTP Calibration
+    DW3000Calibration calibration = {};  // filled by init(), or by the sketch before it (DW3000_FAST_BOOT)
+    bool calibrationFromCache = false;   // true if the last init() used calibration instead of reading the OTP
+    uint8_t xtalTrim = 0;                // XTAL_TRIM: set it before init() to use a tuned value instead of the OTP one, init() and setXtalTrim() keep it current
+
+    // Temperature Compensation
+    void recalibrate();
+    float temperature = DW3000_ANTENNA_DELAY_CAL_TEMP;              // °C of the last readTemperature() (or getTempInC())
+    float antennaDelayTemp = DW3000_ANTENNA_DELAY_CAL_TEMP;         // °C at which config.antennaDelay was calibrated
+    float antennaDelayTicksPerC = DW3000_ANTENNA_DELAY_TICKS_PER_C; // 0 turns the compensation in convertToCM() off
+
+    // Deep Sleep
+    void deepSleep();
+    bool wakeup();
+    uint32_t wakeupUs = 0; // duration of the last wakeup() in µs, from CS going low to the PLL locked and the configuration restored
+
+    // Interrupts
+    void enableInterrupts(DW3000Irq *irq);
+    uint32_t readEvents();
+    uint32_t waitForEvents(uint32_t events, uint32_t timeoutMs);
+    DW3000Irq *irq = NULL; // the IRQ line enableInterrupts() set up, NULL while the driver polls SYS_STATUS
+
+    // Register Shadow
+    void invalidateShadow();
+    uint32_t shadowHits = 0; // register reads answered from the shadow instead of the bus (= SPI transactions saved)
+
+    // SPI Tracer
+    DW3000Trace trace; // the last DW3000_TRACE_DEPTH transactions, see dw3000_trace.h
+
     // Delayed Sending Settings
     void writeTXDelay(uint32_t delay);
     void prepareDelayedTX(int destinationID, int senderID);
@@ -109,6 +440,7 @@ public:
     void standardTX();
     void standardRX();
     void TXInstantRX();
+    void TRXOff();
 
     // DWM3000 Firmware Interaction
     void softReset();
@@ -129,29 +461,87 @@ public:
 
 private:
     // Single Bit Settings
-    void setBit(int registerID, int shift, bool b);
+    void setBit(const DW3000Register &reg, int shift, bool b);
     void setBit(int reg_addr, int sub_addr, int shift, bool b);
-    void setBitLow(int registerID, int shift);
     void setBitLow(int reg_addr, int sub_addr, int shift);
-    void setBitHigh(int registerID, int shift);
     void setBitHigh(int reg_addr, int sub_addr, int shift);
 
     // Fast Commands
     void writeFastCommand(int cmd);
 
+    // Double-Sided Ranging Helper Methods
+    void ds_sendControlFrame(const uint8_t *frame, uint8_t len);
+
+    // Receive Timeout Helper Methods
+    void armRxTimeouts(bool armed);
+    void writeResponseWindow();
+    uint16_t rxPreambleTimeout();
+
+    // Double Buffered RX Helper Methods
+    const DW3000Register &rxBufferData();
+
     // SPI Interaction
-    uint32_t readOrWriteFullAddress(uint32_t base, uint32_t sub, uint32_t data, uint32_t data_len, uint32_t readWriteBit);
-    uint32_t sendBytes(int b[], int lenB, int recLen);
+    void spiTransfer(const uint8_t *header, uint8_t headerLen, const uint8_t *tx, uint8_t *rx, uint16_t len);
+    const DW3000Register &addressable(const DW3000Register &reg);
 
     // Soft Reset Helper Method
     void clearAONConfig();
 
+    // Init Helper Methods
+    void readCalibration();
+    void writeChannelSettings();
+    void lockPLL();
+    void calibrateRX();
+
     // Other Helper Methods
-    unsigned int countBits(unsigned int number);
+    unsigned long long bytesToValue(const uint8_t *bytes, uint8_t len);
+    void valueToBytes(unsigned long long value, uint8_t *bytes, uint8_t len);
     int checkForDevID();
+
+    bool batching = false;
+
+    uint32_t txPower = DW3000_TX_POWER_MAX; // setTXPower(), written again by configureAsTX()
+    uint8_t pgDelay = DW3000_PG_DELAY;     // setPGDelay(), written again by configureAsTX() and writeChannelSettings()
+
+    uint32_t responseEarliestUs = 0; // setResponseWindow(), written again by writePhyConfig()
+    uint32_t responseLatestUs = 0;   // 0 while there is no response window: the receiver waits without timeouts
+    uint16_t responseLen = 0;        // longest answer in bytes, including the FCS
+    bool rxTimeoutsArmed = false;    // SYS_CFG RXWTOE and PRE_TOC currently hold the response window
+
+    uint8_t rxBufferIndex = 0;  // RX buffer that holds the frame the host works on (doubleBuffer)
+    bool rxPending = false;     // releaseRxBuffer() found the next frame in the other buffer, receivedFrameSucc() reports it
+
+    /*
+     Shadow of a configuration register that only the host changes (DW3000_SHADOW_REGISTERS).
+     Every write through the driver updates it, writes that only cover part of the register invalidate it.
+    */
+    struct ShadowEntry
+    {
+        DW3000Register reg;
+        uint32_t value;
+        bool valid;
+    };
+
+    ShadowEntry shadow[11] = {
+        {regs::SYS_CFG, 0, false},
+        {regs::TX_FCTRL, 0, false},
+        {regs::TX_FCTRL_HI, 0, false},
+        {regs::CHAN_CTRL, 0, false},
+        {regs::STS_CFG0, 0, false},
+        {regs::DTUNE0, 0, false},
+        {regs::TX_CTRL_HI, 0, false},
+        {regs::LDO_CTRL, 0, false},
+        {regs::XTAL, 0, false},
+        {regs::CLK_CTRL, 0, false},
+        {regs::BIAS_CTRL, 0, false},
+    };
+
+    ShadowEntry *findShadow(const DW3000Register &reg);
+    void updateShadow(const DW3000Register &reg, uint16_t len, const uint8_t *data);
 };
 
-DWM3000Class::DWM3000Class(Config mconfig)
+template <class ConfigT>
+DWM3000Driver<ConfigT>::DWM3000Driver(Config mconfig)
 {
     this->config = mconfig;
 }
@@ -164,7 +554,8 @@ DWM3000Class::DWM3000Class(Config mconfig)
  Selects a SPI device through its Chip Select pin
  @param cs The pin number of the selected SPI device
 */
-void DWM3000Class::spiSelect(uint8_t cs)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::spiSelect(uint8_t cs)
 {
     pinMode(cs, OUTPUT);
     digitalWrite(cs, HIGH);
@@ -175,16 +566,15 @@ void DWM3000Class::spiSelect(uint8_t cs)
 /*
  Initializes the SPI Interface
 */
-void DWM3000Class::begin()
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::begin()
 {
     delay(5);
-    pinMode(this->config.csPin, OUTPUT);
-    this->config.spi.begin(this->config.sckPin, this->config.misoPin, this->config.mosiPin, this->config.csPin);
-    // this->config.spi.begin();
-
-    delay(5);
-
-    spiSelect(this->config.csPin);
+    if (!this->config.transport->begin(this->config.csPin, this->config.sckPin, this->config.misoPin, this->config.mosiPin))
+    {
+        Serial.println("[ERROR] Could not set up the SPI bus!");
+        return;
+    }
 
     Serial.println("[INFO] SPI ready");
 }
@@ -192,17 +582,20 @@ void DWM3000Class::begin()
 /*
  Initializes the chip, checks for a connection and sets up a initial configuration
 */
-void DWM3000Class::init()
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::init()
 {
     Serial.println("\n+++ DecaWave DWM3000 Test +++\n");
 
+    this->config.transport->setClock(DW3000_SPI_SLOW_HZ); // the PLL is not locked yet
+
     if (!checkForDevID())
     {
         Serial.println("[ERROR] Dev ID is wrong! Aborting!");
         return;
     }
 
-    setBitHigh(SYS_CFG_ID, 4);
+    setBit(regs::SYS_CFG, 4, 1);
 
     while (!checkForIDLE())
     {
@@ -212,7 +605,7 @@ void DWM3000Class::init()
 
     softReset();
 
-    delay(200);
+    waitForIDLE(200);
 
     while (!checkForIDLE())
     {
@@ -220,23 +613,30 @@ void DWM3000Class::init()
         delay(100);
     }
 
-    uint32_t ldo_low = readOTP(0x04);
-    uint32_t ldo_high = readOTP(0x05);
-    uint32_t bias_tune = readOTP(0xA);
-    bias_tune = (bias_tune >> 16) & BIAS_CTRL_BIAS_MASK;
+    if (DW3000_SPI_CRC)
+    {
+        enableSpiCrc(DW3000_SPI_CRC); // before any configuration gets written
+    }
+
+    readCalibration();
+
+    uint32_t ldo_low = this->calibration.ldoLow;
+    uint32_t ldo_high = this->calibration.ldoHigh;
+    uint32_t bias_tune = this->calibration.biasTune;
 
     if (ldo_low != 0 && ldo_high != 0 && bias_tune != 0)
     {
-        write(BIAS_CTRL_ID, bias_tune);
+        write(regs::BIAS_CTRL_BIAS, bias_tune);
 
-        write(OTP_CFG_ID, 0x0100);
+        write(regs::OTP_CFG, 0x0100);
     }
 
-    int xtrim_value = readOTP(0x1E);
+    int xtrim_value = this->xtalTrim != 0 ? this->xtalTrim : this->calibration.xtalTrim; // a tuned trim (DW3000XtalTrimLoop) wins over the OTP
 
-    xtrim_value = xtrim_value == 0 ? 0x2E : xtrim_value; // if xtrim_value from OTP memory is 0, choose 0x2E as default value
+    xtrim_value = xtrim_value == 0 ? DW3000_XTAL_TRIM_DEFAULT : xtrim_value; // if xtrim_value from OTP memory is 0, choose 0x2E as default value
 
-    write(FS_CTRL_REG, 0x14, xtrim_value);
+    this->xtalTrim = xtrim_value;
+    write(regs::XTAL_XTAL_TRIM, xtrim_value);
     if (DEBUG_OUTPUT)
         Serial.print("xtrim: ");
     if (DEBUG_OUTPUT)
@@ -244,107 +644,82 @@ void DWM3000Class::init()
 
     writeSysConfig();
 
-    write(0x00, 0x3C, 0xFFFFFFFF); // Set Status Enable
-    write(SYS_ENABLE_HI_ID, 0xFFFF);
+    enableInterrupts(this->irq); // Set Status Enable
 
-    write(AON_DIG_CFG_ID, 0x000900, 3); // AON_DIG_CFG register setup; sets up auto-rx calibration and on-wakeup GO2IDLE  //0xA
+    write(regs::AON_DIG_CFG, 0x000900); // AON_DIG_CFG register setup; sets up auto-rx calibration and on-wakeup GO2IDLE  //0xA
 
     /*
-     * Set RX and TX config
+     * Set RX and TX config (the DGC lookup table depends on the channel, writeSysConfig() wrote it)
      */
-    write(DGC_CFG0_ID, 0x10000240); // DGC_CFG0
-
-    write(DGC_CFG1_ID, 0x1B6DA489); // DGC_CFG1
-
-    write(DGC_LUT_0_CFG_ID, 0x0001C0FD); // DGC_LUT_0
-
-    write(DGC_LUT_1_CFG_ID, 0x0001C43E); // DGC_LUT_1
+    write(regs::DGC_CFG0, 0x10000240); // DGC_CFG0
 
-    write(DGC_LUT_2_CFG_ID, 0x0001C6BE); // DGC_LUT_2
+    write(regs::DGC_CFG1, 0x1B6DA489); // DGC_CFG1
 
-    write(DGC_LUT_3_CFG_ID, 0x0001C77E); // DGC_LUT_3
+    write(regs::DGC_CFG.slice(0, 2), 0xE5E5); // THR_64 value set to 0x32
 
-    write(DGC_LUT_4_CFG_ID, 0x0001CF36); // DGC_LUT_4
-
-    write(DGC_LUT_5_CFG_ID, 0x0001CFB5); // DGC_LUT_5
-
-    write(DGC_LUT_6_CFG_ID, 0x0001CFF5); // DGC_LUT_6
-
-    write(DGC_CFG_ID, 0xE5E5); // THR_64 value set to 0x32
-    int f = read(0x4, 0x20);
-
-    // SET PAC TO 16 (0x01) reg:06:00 bits:1-0, bit 4 to 0 (00001100) (0xC)
-    write(DTUNE0_ID, 0x81101D);
-
-    write(SAR_TEST_ID, 0x4); // Enable temp sensor readings
+    write(regs::SAR_TEST, 0x4); // Enable temp sensor readings
 
     /*
      * Things to do as documented in https://gist.github.com/egnor/455d510e11c22deafdec14b09da5bf54
      */
-    write(LDO_CTRL_ID, 0x14);       // LDO_RLOAD to 0x14 //0x7
-    write(0x07, 0x1A, 0x0E);       // RF_TX_CTRL_1 to 0x0E
-    write(TX_CTRL_HI_ID, 0x1C071134); // RF_TX_CTRL_2 to 0x1C071134 (due to channel 5, else (9) to 0x1C010034)
-    write(PLL_CFG_ID, 0x1F3C);     // PLL_CFG to 0x1F3C (due to channel 5, else (9) to 0x0F3C)  //0x9
-    write(0x09, 0x80, 0x81);       // PLL_CAL config to 0x81
-
-    write(CLK_CTRL_ID, 0xB40200);
-
-    write(SEQ_CTRL_ID, 0x80030738);
-
-    // custom config
+    write(regs::LDO_CTRL, 0x14);                // LDO_RLOAD to 0x14 //0x7
+    write(regs::RF_TX_CTRL, 0x0E);              // RF_TX_CTRL_1 to 0x0E (RF_TX_CTRL_2 and PLL_CFG depend on the channel, see DW3000ChannelSettings)
+    write(regs::PLL_CAL.slice(0, 1), 0x81);     // set optimal PLL calibration config value (the gist has 09:80, there is no register there)
 
-    // // SFD timeout
-    // write(0x06, 0x02, 2048 +  1 - 8 + 8); // preamble length + 1 – PAC size + SFD length.
+    write(regs::CLK_CTRL, 0xB40200);
 
-    // // preamble detection timeout
-    // uint32_t regval = read(0x06, 0x04) & 0xFFFF0000;
-    // // regval += 65535; // max timeout ~250ms, only uncomment if you don't want the receiver on until receiving a frame
-    // write(0x06, 0x04, regval);
+    write(regs::SEQ_CTRL, 0x80030738);
 
     // LEDs
-    write(GPIO_MODE_ID, 0b001001001001001001001001001); // turn on all led GPIOs
-    uint32_t clk_ctrl = read(0x11, 0x4);
-    clk_ctrl |= 1 << 18; // enable debounce clocks
-    write(CLK_CTRL_ID, clk_ctrl);
-    write(LED_CTRL_ID, 0x101); // enable blink and 14ms blink to manage brightness
+    write(regs::GPIO_MODE, 0b001001001001001001001001001); // turn on all led GPIOs
+    write(regs::CLK_CTRL_GPIO_DCLK_EN, 1);                // enable debounce clocks
+    write(regs::LED_CTRL, 0x101); // enable blink and 14ms blink to manage brightness
 
     Serial.println("[INFO] Initialization finished.\n");
 }
 
 /*
- Writes the initial configuration to the chip
+ Writes the registers that make up the PHY: PHR mode and rate, PAC size, preamble code, preamble length, data rate
+ and the timeouts derived from them. On its own (setPhy() on the same channel) it needs neither a PLL lock nor a calibration.
 */
-void DWM3000Class::writeSysConfig()
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::writePhyConfig()
 {
-    int usr_cfg = (STDRD_SYS_CONFIG & 0xFFF) | (this->config.phrMode << 3) | (this->config.phrRate << 4);
+    int usr_cfg = (STDRD_SYS_CONFIG & 0xFFF) | (this->config.phrMode << regs::SYS_CFG_PHR_MODE.shift) | (this->config.phrRate << regs::SYS_CFG_PHR_6M8.shift);
+    if (this->config.transport->crcMode != DW3000_SPI_CRC_OFF)
+    {
+        usr_cfg |= SYS_CFG_SPI_CRC_BIT_MASK; // keep the SPI CRC on
+    }
+    if (this->rxTimeoutsArmed)
+    {
+        usr_cfg |= regs::SYS_CFG_RXWTOE.mask; // keep the frame wait timeout on
+    }
+    if (this->doubleBuffer)
+    {
+        usr_cfg &= ~regs::SYS_CFG_DIS_DRXB.mask; // keep both RX buffers and the automatic receiver re-enable
+        usr_cfg |= regs::SYS_CFG_RXAUTR.mask;
+    }
 
-    write(GEN_CFG_AES_LOW_REG, 0x10, usr_cfg);
+    write(regs::SYS_CFG, usr_cfg);
 
     if (this->config.preambleCode > 24)
     {
         Serial.println("[ERROR] SCP ERROR! TX & RX Preamble Code higher than 24!");
     }
 
-    int otp_write = 0x1400;
-
-    if (this->config.preambleLength >= 256)
+    // load the receiver operating parameters for long (256 symbols and up) or short preambles from the OTP
+    int otp_write = regs::OTP_CFG_OPS_KICK.mask;
+    if (dw3000PreambleSymbols(this->config.preambleLength) < 256)
     {
-        otp_write |= 0x04;
+        otp_write |= 0x2 << regs::OTP_CFG_OPS_ID.shift;
     }
 
-    write(OTP_IF_REG, 0x08, otp_write); // set OTP config
-    write(DRX_REG, 0x00, 0x00, 1);      // reset DTUNE0_CONFIG
-
-    write(DRX_REG, 0x0, this->config.pacSize);
-
-    // 64 = STS length
-    write(STS_CFG_REG, 0x0, 64 / 8 - 1);
-
-    write(GEN_CFG_AES_LOW_REG, 0x29, 0x00, 1);
+    write(regs::OTP_CFG, otp_write); // set OTP config
 
-    write(DRX_REG, 0x0C, 0xAF5F584C);
+    // DTUNE0: PAC size in bits 1-0, bit 4 (DT0B4) set
+    write(regs::DTUNE0, 0x101C | this->config.pacSize);
 
-    int chan_ctrl_val = read(GEN_CFG_AES_HIGH_REG, 0x14); // Fetch and adjust CHAN_CTRL data
+    int chan_ctrl_val = read(regs::CHAN_CTRL); // Fetch and adjust CHAN_CTRL data
     chan_ctrl_val &= (~0x1FFF);
 
     chan_ctrl_val |= this->config.channel; // Write RF_CHAN
@@ -353,47 +728,76 @@ void DWM3000Class::writeSysConfig()
     chan_ctrl_val |= 0xF8 & (this->config.preambleCode << 3);
     chan_ctrl_val |= 0x06 & (0x2 << 1); // 16 symbol decawave SFD type
 
-    write(GEN_CFG_AES_HIGH_REG, 0x14, chan_ctrl_val); // Write new CHAN_CTRL data with updated values
+    write(regs::CHAN_CTRL, chan_ctrl_val); // Write new CHAN_CTRL data with updated values
 
     // transmit frame control: frame length, bitrate, ranging enable, preamble config
-    int tx_fctrl_val = read(GEN_CFG_AES_LOW_REG, 0x24);
-    tx_fctrl_val |= (this->config.preambleLength << 12);
-    tx_fctrl_val ^= 1 << 10; // clear out datarate bit
-    tx_fctrl_val |= (this->config.dataRate << 10);
-    write(GEN_CFG_AES_LOW_REG, 0x24, tx_fctrl_val);
+    int tx_fctrl_val = read(regs::TX_FCTRL);
+    tx_fctrl_val &= ~(regs::TX_FCTRL_TXPSR.mask | regs::TX_FCTRL_TXBR.mask);
+    tx_fctrl_val |= (this->config.preambleLength << regs::TX_FCTRL_TXPSR.shift);
+    tx_fctrl_val |= (this->config.dataRate << regs::TX_FCTRL_TXBR.shift);
+    write(regs::TX_FCTRL, tx_fctrl_val);
 
-    write(DRX_REG, 0x02, 0x81);
+    // timeouts that depend on the preamble length and the PAC size
+    write(regs::RX_SFD_TOC, dw3000SfdTimeout(this->config.preambleLength, this->config.pacSize));
+    write(regs::PRE_TOC, rxPreambleTimeout());
+    writeResponseWindow();
+}
 
-    int rf_tx_ctrl_2 = 0x1C071134;
-    int pll_conf = 0x0F3C;
+/*
+ Writes the initial configuration to the chip
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::writeSysConfig()
+{
+    writePhyConfig();
 
-    if (this->config.channel)
-    {
-        rf_tx_ctrl_2 &= ~0x00FFFF;
-        rf_tx_ctrl_2 |= 0x000001;
-        pll_conf &= 0x00FF;
-        pll_conf |= 0x001F;
-    }
+    // 64 = STS length
+    write(regs::STS_CFG0_CPS_LEN, 64 / 8 - 1);
+
+    write(regs::TX_FCTRL_HI_FINE_PLEN, 0x00);
+
+    write(regs::DTUNE3, 0xAF5F584C);
 
-    write(RF_CONF_REG, 0x1C, rf_tx_ctrl_2);
-    write(FS_CTRL_REG, 0x00, pll_conf);
+    writeChannelSettings();
 
-    write(RF_CONF_REG, 0x51, 0x14);
+    write(regs::LDO_RLOAD.slice(1, 1), 0x14);
 
-    write(RF_CONF_REG, 0x1A, 0x0E);
+    write(regs::RF_TX_CTRL, 0x0E);
 
-    write(FS_CTRL_REG, 0x08, 0x81);
+    write(regs::PLL_CAL.slice(0, 1), 0x81);
 
-    write(GEN_CFG_AES_LOW_REG, 0x44, 0x02);
+    lockPLL();
 
-    write(PMSC_REG, 0x04, 0x300200); // Set clock to auto mode
+    int otp_val = read(regs::OTP_CFG);
+    otp_val |= dw3000ChannelSettings(this->config.channel).otpCfg;
 
-    write(PMSC_REG, 0x08, 0x0138);
+    write(regs::OTP_CFG, otp_val);
+
+    write(regs::DGC_CFG.slice(1, 1), 0xF0);
+
+    calibrateRX();
+
+    write(regs::CIA_CONF.slice(2, 1), 0x01); // Enable full CIA diagnostics to get signal strength information
+
+    setTXAntennaDelay(this->config.antennaDelay); // set default antenna delay
+}
+
+/*
+ Locks the PLL (AINIT2IDLE with the system clock on auto) and switches the SPI to its fast clock once it is locked
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::lockPLL()
+{
+    write(regs::SYS_STATUS, 0x02);
+
+    write(regs::CLK_CTRL, 0x300200); // Set clock to auto mode
+
+    write(regs::SEQ_CTRL.slice(0, 2), 0x0138);
 
     int success = 0;
     for (int i = 0; i < 100; i++)
     {
-        if (read(GEN_CFG_AES_LOW_REG, 0x0) & 0x2)
+        if (read(regs::SYS_STATUS_CP_LOCK))
         {
             success = 1;
             break;
@@ -407,39 +811,50 @@ void DWM3000Class::writeSysConfig()
     else
     {
         Serial.println("[INFO] PLL is now locked.");
+        this->config.transport->setClock(DW3000_SPI_FAST_HZ);
     }
+}
 
-    int otp_val = read(OTP_IF_REG, 0x08);
-    otp_val |= 0x40;
-    if (this->config.channel)
-        otp_val |= 0x2000;
-
-    write(OTP_IF_REG, 0x08, otp_val);
-
-    write(RX_TUNE_REG, 0x19, 0xF0);
-
-    int ldo_ctrl_val = read(RF_CONF_REG, 0x48); // Save original LDO_CTRL data
+/*
+ Runs the PGF calibration of the receiver
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::calibrateRX()
+{
+    int ldo_ctrl_val = read(regs::LDO_CTRL); // Save original LDO_CTRL data
     int tmp_ldo = (0x105 | 0x100 | 0x4 | 0x1);
 
-    write(RF_CONF_REG, 0x48, tmp_ldo);
+    write(regs::LDO_CTRL, tmp_ldo);
 
-    write(EXT_SYNC_REG, 0x0C, 0x020000); // Calibrate RX
+    write(regs::RX_CAL_CFG, 0x020000); // Calibrate RX
 
-    int l = read(0x04, 0x0C);
-
-    delay(20);
+    if (DW3000_FAST_BOOT)
+    {
+        delayMicroseconds(20); // what the SDK waits here
+    }
+    else
+    {
+        delay(20);
+    }
 
-    write(EXT_SYNC_REG, 0x0C, 0x11); // Enable calibration
+    write(regs::RX_CAL_CFG.slice(0, 1), 0x11); // Enable calibration
 
     int succ = 0;
     for (int i = 0; i < 100; i++)
     {
-        if (read(EXT_SYNC_REG, 0x20))
+        if (read(regs::RX_CAL_STS))
         {
             succ = 1;
             break;
         }
-        delay(10);
+        if (DW3000_FAST_BOOT)
+        {
+            delayMicroseconds(20);
+        }
+        else
+        {
+            delay(10);
+        }
     }
 
     if (succ)
@@ -451,42 +866,134 @@ void DWM3000Class::writeSysConfig()
         Serial.println("[ERROR] PGF calibration failed!");
     }
 
-    write(EXT_SYNC_REG, 0x0C, 0x00);
-    write(EXT_SYNC_REG, 0x20, 0x01);
+    write(regs::RX_CAL_CFG.slice(0, 1), 0x00);
+    write(regs::RX_CAL_STS, 0x01);
 
-    int rx_cal_res = read(EXT_SYNC_REG, 0x14);
+    int rx_cal_res = read(regs::RX_CAL_RESI);
     if (rx_cal_res == 0x1fffffff)
     {
         Serial.println("[ERROR] PGF_CAL failed in stage I!");
     }
-    rx_cal_res = read(EXT_SYNC_REG, 0x1C);
+    rx_cal_res = read(regs::RX_CAL_RESQ);
     if (rx_cal_res == 0x1fffffff)
     {
         Serial.println("[ERROR] PGF_CAL failed in stage Q!");
     }
 
-    write(RF_CONF_REG, 0x48, ldo_ctrl_val); // Restore original LDO_CTRL data
+    write(regs::LDO_CTRL, ldo_ctrl_val); // Restore original LDO_CTRL data
+}
+
+/*
+ Locks the PLL again and repeats the receiver calibration, for a chip that drifted in temperature since init()
+ (DW3000_RECAL_TEMP_DELTA). The receiver and transmitter are turned off, the caller arms them again. Takes about as long as that part of init().
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::recalibrate()
+{
+    TRXOff();
 
-    write(0x0E, 0x02, 0x01); // Enable full CIA diagnostics to get signal strength information
+    int clk_ctrl_val = read(regs::CLK_CTRL);
+    this->config.transport->setClock(DW3000_SPI_SLOW_HZ);
+    write(regs::CLK_CTRL.slice(0, 1), 0x1); // system clock to FAST_RC/4, so the PLL locks from scratch
 
-    setTXAntennaDelay(this->config.antennaDelay); // set default antenna delay
+    lockPLL();
+    write(regs::CLK_CTRL, clk_ctrl_val); // back to the clocks init() enabled
+
+    calibrateRX();
 }
 
 /*
- Configures the chip for usage as a Transfer Device
+ Puts the chip into DEEPSLEEP, where it draws less than a µA. The configuration goes to the AON memory first and comes back
+ on its own on wakeup (ONWAKE_AON_DLD), then the chip locks its PLL (ONWAKE_GO2IDLE) and runs the PGF calibration like init() set it up.
+ The receiver and transmitter are turned off. Until wakeup() the chip reads zeros and ignores writes.
 */
-void DWM3000Class::configureAsTX()
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::deepSleep()
 {
-    write(RF_CONF_REG, 0x1C, 0x34);                // write pg_delay
-    write(GEN_CFG_AES_HIGH_REG, 0x0C, 0xFFFFFFFF); // transmit power
+    TRXOff();
+
+    write(regs::AON_DIG_CFG, 0x000900 | regs::AON_DIG_CFG_ONWAKE_AON_DLD.mask);     // what init() sets, plus the configuration download
+    write(regs::AON_CFG, regs::ANA_CFG_SLEEP_EN.mask | regs::ANA_CFG_WAKE_CSN.mask); // DEEPSLEEP (WAKE_CNT off), wake on CS held low
+
+    this->config.transport->setClock(DW3000_SPI_SLOW_HZ); // the chip is off its PLL for the CRC check of the last write, and wakes up on its RC oscillator
+
+    write(regs::AON_CTRL, 0x00);
+    write(regs::AON_CTRL, regs::AON_CTRL_ARRAY_SAVE.mask); // saves the configuration and enters DEEPSLEEP
+}
+
+/*
+ Wakes the chip from deepSleep() and writes what the AON memory does not keep (what the SDK's dwt_restoreconfig() writes):
+ the LDO and bias tuning of the OTP calibration, the analog RF settings and the DGC lookup table of the channel, the receiver
+ operating parameters. The PLL locks by itself, so neither a lock sequence nor an OTP read is needed. Measures itself in wakeupUs.
+ @return False if the chip did not come back within DW3000_WAKEUP_TIMEOUT_MS or its PLL did not lock
+*/
+template <class ConfigT>
+bool DWM3000Driver<ConfigT>::wakeup()
+{
+    unsigned long start = micros();
+
+    this->config.transport->setClock(DW3000_SPI_SLOW_HZ);
+    this->config.transport->wakeup(DW3000_WAKEUP_CS_US);
+    invalidateShadow(); // the chip starts from its reset values until the download
+
+    if (!waitForIDLE(DW3000_WAKEUP_TIMEOUT_MS))
+    {
+        Serial.println("[ERROR] DW3000 did not wake up!");
+        return false;
+    }
+
+    if (this->calibration.ldoLow != 0 && this->calibration.ldoHigh != 0 && this->calibration.biasTune != 0)
+    {
+        write(regs::BIAS_CTRL_BIAS, this->calibration.biasTune);
+        write(regs::OTP_CFG, 0x0100);
+    }
+
+    write(regs::LDO_RLOAD.slice(1, 1), 0x14);
+    write(regs::RF_TX_CTRL, 0x0E);
+    write(regs::PLL_CAL.slice(0, 1), 0x81);
+
+    writeChannelSettings(); // the DGC lookup table, RF_TX_CTRL_2 and PLL_CFG get the values they kept
+
+    int otp_write = regs::OTP_CFG_OPS_KICK.mask | dw3000ChannelSettings(this->config.channel).otpCfg;
+    if (dw3000PreambleSymbols(this->config.preambleLength) < 256)
+    {
+        otp_write |= 0x2 << regs::OTP_CFG_OPS_ID.shift;
+    }
+    write(regs::OTP_CFG, otp_write);
+
+    bool locked = false;
+    for (int i = 0; i < 100 && !locked; i++)
+    {
+        locked = read(regs::SYS_STATUS_CP_LOCK);
+    }
+    if (!locked)
+    {
+        Serial.println("[ERROR] Couldn't lock PLL Clock after wakeup!");
+        return false;
+    }
+    this->config.transport->setClock(DW3000_SPI_FAST_HZ);
+
+    this->wakeupUs = micros() - start;
+    return true;
+}
+
+/*
+ Configures the chip for usage as a Transfer Device: the PG delay and TX power last set (DW3000_PG_DELAY and DW3000_TX_POWER_MAX by default)
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::configureAsTX()
+{
+    write(regs::TX_CTRL_HI_TX_PG_DELAY, this->pgDelay); // write pg_delay
+    write(regs::TX_POWER, this->txPower);              // transmit power
 }
 
 /*
  Sets the first 4 GPIO pins as output for external measurements and LED usage
 */
-void DWM3000Class::setupGPIO()
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setupGPIO()
 {
-    write(GPIO_DIR_ID, 0xF0); // Set GPIO0 - GPIO3 as OUTPUT on DWM3000
+    write(regs::GPIO_DIR.slice(0, 1), 0xF0); // Set GPIO0 - GPIO3 as OUTPUT on DWM3000
 }
 
 /*
@@ -498,26 +1005,19 @@ void DWM3000Class::setupGPIO()
  @param stage Double-sided Ranging is more complicated than regular single-sided Ranging. Therefore,
               stages were introduced to make sure that the right frames get received at the right time. stage is a 3 bit int.
 */
-void DWM3000Class::ds_sendFrame(int stage, int senderID, int destinationID)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::ds_sendFrame(int stage, int senderID, int destinationID)
 {
-    setMode(1);
-    write(0x14, 0x01, senderID & 0xFF);
-    write(0x14, 0x02, destinationID & 0xFF);
-    write(0x14, 0x03, stage & 0x7);
-    setFrameLength(4);
+    uint8_t frame[] = {1, (uint8_t)(senderID & 0xFF), (uint8_t)(destinationID & 0xFF), (uint8_t)(stage & 0x7)}; // mode 1: double-sided ranging
+    setFrameLength(4); // reads TX_FCTRL, so it has to happen before the batch
 
+    beginBatch(); // frame and fast command get queued together
+    writeBytes(regs::TX_BUFFER, frame, sizeof(frame));
     TXInstantRX(); // Await response
+    endBatch();
+    armRxTimeouts(true); // while the frame is in the air, the receiver only takes the timeouts when it turns on
 
-    bool error = true;
-    for (int i = 0; i < 50; i++)
-    {
-        if (sentFrameSucc())
-        {
-            error = false;
-            break;
-        }
-    };
-    if (error)
+    if (!waitForEvents(DW3000_EVENT_TX_DONE, TX_DONE_TIMEOUT_MS))
     {
         Serial.println("[ERROR] Could not send frame successfully!");
     }
@@ -528,18 +1028,37 @@ void DWM3000Class::ds_sendFrame(int stage, int senderID, int destinationID)
  @param t_roundB The time that it took between chip B (this chip) sending an answer and getting a response (rx2 - tx1)
  @param t_replyB The time that the chip took to process the received frame (tx1 - rx1)
 */
-void DWM3000Class::ds_sendRTInfo(int t_roundB, int t_replyB, int destinationID, int senderID)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::ds_sendRTInfo(int t_roundB, int t_replyB, int destinationID, int senderID)
 {
-    setMode(1);
-    write(0x14, 0x01, destinationID & 0xFF);
-    write(0x14, 0x02, senderID & 0xFF);
-    write(0x14, 0x03, 4);
-    write(0x14, 0x04, t_roundB);
-    write(0x14, 0x08, t_replyB);
-
+    uint8_t frame[12] = {1, (uint8_t)(destinationID & 0xFF), (uint8_t)(senderID & 0xFF), 4}; // mode 1: double-sided ranging, stage 4
+    for (int i = 0; i < 4; i++)
+    {
+        frame[4 + i] = (t_roundB >> i * 8) & 0xFF;
+        frame[8 + i] = (t_replyB >> i * 8) & 0xFF;
+    }
     setFrameLength(12);
 
+    beginBatch();
+    writeBytes(regs::TX_BUFFER, frame, sizeof(frame));
     TXInstantRX();
+    endBatch();
+    armRxTimeouts(false); // the exchange is over, the receiver waits for the next one
+}
+
+/*
+ Reads the round trip information that chip B sent with ds_sendRTInfo from the RX buffer in one transaction
+ @param t_roundB Receives the round time of chip B
+ @param t_replyB Receives the reply time of chip B
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::ds_readRTInfo(int *t_roundB, int *t_replyB)
+{
+    uint8_t rt_info[8];
+    readBytes(rxBufferData().slice(4, 8), rt_info, sizeof(rt_info));
+
+    *t_roundB = (int)bytesToValue(rt_info, 4);
+    *t_replyB = (int)bytesToValue(rt_info + 4, 4);
 }
 
 /*
@@ -551,7 +1070,8 @@ void DWM3000Class::ds_sendRTInfo(int t_roundB, int t_replyB, int destinationID,
  @param clk_offset The calculated clock offset between both chips (See DWM3000 User Manual 10.1 for more)
  @return returns the time in units of 15.65ps that the frames were in the air on average (only one direction)
 */
-int DWM3000Class::ds_processRTInfo(int t_roundA, int t_replyA, int t_roundB, int t_replyB, int clk_offset)
+template <class ConfigT>
+int DWM3000Driver<ConfigT>::ds_processRTInfo(int t_roundA, int t_replyA, int t_roundB, int t_replyB, int clk_offset)
 { // returns ranging time in DWM3000 ps units (~15.65ps per unit)
     if (DEBUG_OUTPUT)
     {
@@ -583,24 +1103,27 @@ int DWM3000Class::ds_processRTInfo(int t_roundA, int t_replyA, int t_roundB, int
  Returns the stage that the frame was sent in
  @return The stage that the frame was sent in (read from the TX_Buffer)
 */
-int DWM3000Class::ds_getStage()
+template <class ConfigT>
+int DWM3000Driver<ConfigT>::ds_getStage()
 {
-    return read(0x12, 0x03) & 0b111;
+    return read(rxBufferData().slice(3, 1)) & 0b111;
 }
 
 /*
  Checks if frame is error frame by checking its mode bits
  @return True if mode == 7; False if anything else
 */
-bool DWM3000Class::ds_isErrorFrame()
+template <class ConfigT>
+bool DWM3000Driver<ConfigT>::ds_isErrorFrame()
 {
-    return ((read(0x12, 0x00) & 0x7) == 7);
+    return ((read(rxBufferData().slice(0, 1)) & 0x7) == 7);
 }
 
 /*
  Sends a frame that has its mode set to 7 (Error Frame). Instantly switches to receive mode (RX)
 */
-void DWM3000Class::ds_sendErrorFrame()
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::ds_sendErrorFrame()
 {
     Serial.println("[WARNING] Error Frame sent. Reverting back to stage 0.");
     setMode(7);
@@ -608,15 +1131,101 @@ void DWM3000Class::ds_sendErrorFrame()
     standardTX();
 }
 
+/*
+ Sends a double-sided ranging frame that carries the settings of a link, to agree on a switch:
+ the index of a PHY profile in its fifth byte and a TX power backoff in its sixth.
+ Waits until it is sent and switches to receive mode, like ds_sendFrame().
+ @param stage The stage of the frame (the sketches use 5 for the request, 6 for the answer)
+ @param profile Index of the profile, the sketches of both sides have to agree on the list
+ @param txBackoff Fine gain steps below the maximum TX power (dw3000TxPowerBackoff())
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::ds_sendPhyFrame(int stage, int profile, int txBackoff, int senderID, int destinationID)
+{
+    uint8_t frame[] = {1, (uint8_t)(senderID & 0xFF), (uint8_t)(destinationID & 0xFF), (uint8_t)(stage & 0x7), (uint8_t)(profile & 0xFF),
+                       (uint8_t)(txBackoff & 0xFF)};
+    ds_sendControlFrame(frame, sizeof(frame));
+}
+
+/*
+ Reads the link settings of a frame sent with ds_sendPhyFrame() in one transaction
+ @param profile Receives the profile index
+ @param txBackoff Receives the TX power backoff in fine gain steps
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::ds_readPhyFrame(int *profile, int *txBackoff)
+{
+    uint8_t link[2];
+    readBytes(rxBufferData().slice(4, 2), link, sizeof(link));
+
+    *profile = link[0];
+    *txBackoff = link[1];
+}
+
+/*
+ Sends a frame that moves a whole cell to other radio settings at the same time: the announcement of the tag (stage 7)
+ and the confirmation of an anchor (stage 7 back). 8 bytes: the link frame header, channel, profile index and the delay.
+ @param channel CHANNEL_5 or CHANNEL_9
+ @param profile Index into DW3000PhyProfiles of the channel
+ @param delayMs Time from now until the switch in ms, at most 65535
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::ds_sendProfileFrame(int stage, int channel, int profile, int delayMs, int senderID, int destinationID)
+{
+    uint8_t frame[] = {1, (uint8_t)(senderID & 0xFF), (uint8_t)(destinationID & 0xFF), (uint8_t)(stage & 0x7), (uint8_t)(channel & 0xFF),
+                       (uint8_t)(profile & 0xFF), (uint8_t)(delayMs & 0xFF), (uint8_t)((delayMs >> 8) & 0xFF)};
+    ds_sendControlFrame(frame, sizeof(frame));
+}
+
+/*
+ Reads a frame sent with ds_sendProfileFrame() in one transaction
+ @param channel Receives the channel
+ @param profile Receives the profile index
+ @param delayMs Receives the time until the switch in ms, counted from the end of the frame
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::ds_readProfileFrame(int *channel, int *profile, int *delayMs)
+{
+    uint8_t switchInfo[4];
+    readBytes(rxBufferData().slice(4, 4), switchInfo, sizeof(switchInfo));
+
+    *channel = switchInfo[0];
+    *profile = switchInfo[1];
+    *delayMs = switchInfo[2] | switchInfo[3] << 8;
+}
+
+/*
+ Sends a short control frame and turns the receiver on for the answer, frame and fast command go out in one batch
+ @param frame The frame, starting with the link frame header
+ @param len Length of the frame in bytes
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::ds_sendControlFrame(const uint8_t *frame, uint8_t len)
+{
+    setFrameLength(len);
+
+    beginBatch();
+    writeBytes(regs::TX_BUFFER, frame, len);
+    TXInstantRX();
+    endBatch();
+    armRxTimeouts(true);
+
+    if (!waitForEvents(DW3000_EVENT_TX_DONE, TX_DONE_TIMEOUT_MS))
+    {
+        Serial.println("[ERROR] Could not send frame successfully!");
+    }
+}
+
 /*
  #####  Radio Settings  #####
 */
 
 /*
- Set the channel that the chip should operate on
+ Set the channel that the chip should operate on. It takes effect with the next writeSysConfig().
  @param data CHANNEL_5 or CHANNEL_9
 */
-void DWM3000Class::setChannel(uint8_t data)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setChannel(uint8_t data)
 {
     if (data == CHANNEL_5 || data == CHANNEL_9)
         this->config.channel = data;
@@ -626,7 +1235,8 @@ void DWM3000Class::setChannel(uint8_t data)
  Set the preamble length for frame sending
  @param data See all options below or in DWM3000Constants.h
 */
-void DWM3000Class::setPreambleLength(uint8_t data)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setPreambleLength(uint8_t data)
 {
     if (data == PREAMBLE_32 || data == PREAMBLE_64 || data == PREAMBLE_1024 || data == PREAMBLE_256 || data == PREAMBLE_512 || data == PREAMBLE_1024 || data == PREAMBLE_1536 || data == PREAMBLE_2048 || data == PREAMBLE_4096)
         this->config.preambleLength = data;
@@ -636,7 +1246,8 @@ void DWM3000Class::setPreambleLength(uint8_t data)
  Set the preamble code
  @param data Should be between 9 and 12
 */
-void DWM3000Class::setPreambleCode(uint8_t data)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setPreambleCode(uint8_t data)
 {
     if (data <= 12 && data >= 9)
         this->config.preambleCode = data;
@@ -646,7 +1257,8 @@ void DWM3000Class::setPreambleCode(uint8_t data)
  Set the PAC size
  @param data PAC4, PAC8, PAC16 or PAC32
 */
-void DWM3000Class::setPACSize(uint8_t data)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setPACSize(uint8_t data)
 {
     if (data == PAC4 || data == PAC8 || data == PAC16 || data == PAC32)
         this->config.pacSize = data;
@@ -656,7 +1268,8 @@ void DWM3000Class::setPACSize(uint8_t data)
  Set the datarate the chip sends and receives on
  @param data DATARATE_6_8_MB or DATARATE_850KB
 */
-void DWM3000Class::setDatarate(uint8_t data)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setDatarate(uint8_t data)
 {
     if (data == DATARATE_6_8MB || data == DATARATE_850KB)
         this->config.dataRate = data;
@@ -666,7 +1279,8 @@ void DWM3000Class::setDatarate(uint8_t data)
  Set the PHR mode for the chip
  @param data PHR_MODE_STANDARD or PHR_MODE_LONG
 */
-void DWM3000Class::setPHRMode(uint8_t data)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setPHRMode(uint8_t data)
 {
     if (data == PHR_MODE_STANDARD || data == PHR_MODE_LONG)
         this->config.phrMode = data;
@@ -676,12 +1290,96 @@ void DWM3000Class::setPHRMode(uint8_t data)
  Set the PHR rate for the chip
  @param data PHR_RATE_6_8MB or PHR_RATE_850KB
 */
-void DWM3000Class::setPHRRate(uint8_t data)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setPHRRate(uint8_t data)
 {
     if (data == PHR_RATE_6_8MB || data == PHR_RATE_850KB)
         this->config.phrRate = data;
 }
 
+/*
+ Switches to other radio settings right away. The receiver and transmitter are turned off first.
+ On the same channel only the PHY registers are written (writePhyConfig()), a new channel also needs the PLL to lock again
+ and the receiver to be calibrated (writeSysConfig()). Only compiles for a runtime configuration (e.g. DWM3000Switchable).
+ @param phy The new settings
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setPhy(const DW3000Phy &phy)
+{
+    bool newChannel = phy.channel != this->config.channel;
+
+    this->config.channel = phy.channel;
+    this->config.preambleLength = phy.preambleLength;
+    this->config.preambleCode = phy.preambleCode;
+    this->config.pacSize = phy.pacSize;
+    this->config.dataRate = phy.dataRate;
+    this->config.phrMode = phy.phrMode;
+    this->config.phrRate = phy.phrRate;
+
+    TRXOff();
+    if (newChannel)
+    {
+        writeSysConfig();
+    }
+    else
+    {
+        beginBatch();
+        writePhyConfig();
+        endBatch();
+    }
+}
+
+/*
+ Sets the TX power, kept for configureAsTX()
+ @param power TX_POWER value: gains for data, PHR, SHR and STS (dw3000TxPower(), dw3000TxPowerBackoff())
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setTXPower(uint32_t power)
+{
+    this->txPower = power;
+    write(regs::TX_POWER, power);
+}
+
+/*
+ Sets the pulse generator delay, which shapes the transmitted pulse (its bandwidth), kept for configureAsTX() and channel switches
+ @param delay TX_PG_DELAY, 6 bits (DW3000_PG_DELAY by default)
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setPGDelay(uint8_t delay)
+{
+    this->pgDelay = delay & regs::TX_CTRL_HI_TX_PG_DELAY.mask;
+    write(regs::TX_CTRL_HI_TX_PG_DELAY, this->pgDelay);
+}
+
+/*
+ Pulls the crystal, takes effect right away. Stays until the next init(), which uses xtalTrim again.
+ @param trim XTAL_TRIM, 0 to DW3000_XTAL_TRIM_MAX, higher is slower
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setXtalTrim(uint8_t trim)
+{
+    this->xtalTrim = trim > DW3000_XTAL_TRIM_MAX ? DW3000_XTAL_TRIM_MAX : trim;
+    write(regs::XTAL_XTAL_TRIM, this->xtalTrim);
+}
+
+/*
+ @return The TX power last set, without reading the chip
+*/
+template <class ConfigT>
+uint32_t DWM3000Driver<ConfigT>::getTXPower()
+{
+    return this->txPower;
+}
+
+/*
+ @return The PG delay last set, without reading the chip
+*/
+template <class ConfigT>
+uint8_t DWM3000Driver<ConfigT>::getPGDelay()
+{
+    return this->pgDelay;
+}
+
 /*
  #####  Protocol Settings  #####
 */
@@ -694,34 +1392,37 @@ void DWM3000Class::setPHRRate(uint8_t data)
     * 2-6 - Reserved
     * 7 - Error
 */
-void DWM3000Class::setMode(int mode)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setMode(int mode)
 {
-    write(0x14, 0x00, mode & 0x7);
+    write(regs::TX_BUFFER.slice(0, 1), mode & 0x7);
 }
 
 /*
  Writes the given data to the chips TX Frame buffer
  @param frame_data The data that should be written onto the chip
 */
-void DWM3000Class::setTXFrame(unsigned long long frame_data)
-{ // deprecated! use write(TX_BUFFER_REG, [...]);
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setTXFrame(unsigned long long frame_data)
+{ // deprecated! use writeBytes(regs::TX_BUFFER, [...]);
     if (frame_data > ((pow(2, 8 * 8) - FCS_LEN)))
     {
         Serial.println("[ERROR] Frame is too long (> 1023 Bytes - FCS_LEN)!");
         return;
     }
 
-    write(TX_BUFFER_REG, 0x00, frame_data);
+    write(regs::TX_BUFFER.slice(0, 4), frame_data);
 }
 
 /*
  Sets the frames data length in bytes
  @param frameLen The length of the data in bytes
 */
-void DWM3000Class::setFrameLength(int frameLen)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setFrameLength(int frameLen)
 { // set Frame length in Bytes
     frameLen = frameLen + FCS_LEN;
-    int curr_cfg = read(0x00, 0x24);
+    int curr_cfg = read(regs::TX_FCTRL);
     if (frameLen > 1023)
     {
         Serial.println("[ERROR] Frame length + FCS_LEN (2) is longer than 1023. Aborting!");
@@ -729,17 +1430,185 @@ void DWM3000Class::setFrameLength(int frameLen)
     }
     int tmp_cfg = (curr_cfg & 0xFFFFFC00) | frameLen;
 
-    write(GEN_CFG_AES_LOW_REG, 0x24, tmp_cfg);
+    write(regs::TX_FCTRL, tmp_cfg);
 }
 
 /*
  Set the Antenna Delay for delayedTX operations
  @param data Can be anything between 0 and 0xFFFF
 */
-void DWM3000Class::setTXAntennaDelay(int delay)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setTXAntennaDelay(int delay)
 {
     this->config.antennaDelay = delay;
-    write(TX_ANTD_ID, delay);
+    write(regs::TX_ANTD, delay);
+}
+
+/*
+ #####  Receive Timeouts  #####
+*/
+
+/*
+ Sets the window in which the answer to a frame has to arrive, counted from the end of the frame to the start of the answer.
+ Sending with ds_sendFrame() or a control frame then turns the receiver on at the earliest time (W4R_TIM) and makes the chip
+ give up on its own: no preamble by the latest time raises RXPTO (PRE_TOC), no complete frame by the latest time plus
+ its airtime raises RXFTO (RX_FWTO). receivedFrameSucc() reports both as 3. standardRX() and ds_sendRTInfo() wait without them.
+ The values follow the PHY, setPhy() derives them again.
+ @param earliestUs Shortest turnaround of the other side in µs
+ @param latestUs Longest turnaround of the other side in µs, 0 turns the window off
+ @param frameLen Length of the longest answer in bytes, without the FCS
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setResponseWindow(uint32_t earliestUs, uint32_t latestUs, uint16_t frameLen)
+{
+    armRxTimeouts(false); // the next frame that expects an answer arms the new window
+
+    this->responseEarliestUs = latestUs > earliestUs ? earliestUs : 0;
+    this->responseLatestUs = latestUs;
+    this->responseLen = frameLen + FCS_LEN;
+    if (latestUs == 0)
+    {
+        write(regs::ACK_RESP, 0); // the receiver turns on right after a frame again
+    }
+    writeResponseWindow();
+}
+
+/*
+ Turns the timeouts of the response window on or off, the registers only get written when that changes
+ @param armed True before sending a frame that expects an answer
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::armRxTimeouts(bool armed)
+{
+    armed = armed && this->responseLatestUs != 0;
+    if (armed == this->rxTimeoutsArmed)
+    {
+        return;
+    }
+
+    this->rxTimeoutsArmed = armed;
+    write(regs::SYS_CFG_RXWTOE, armed);
+    write(regs::PRE_TOC, rxPreambleTimeout());
+}
+
+/*
+ Writes the receive delay and the frame wait timeout of the response window for the current PHY, nothing without a window
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::writeResponseWindow()
+{
+    if (this->responseLatestUs == 0)
+    {
+        return;
+    }
+
+    uint32_t spreadUs = this->responseLatestUs - this->responseEarliestUs;
+    uint32_t frameUs = dw3000FrameUs(this->config.preambleLength, this->config.dataRate, this->config.phrRate, this->responseLen);
+
+    write(regs::ACK_RESP, dw3000Uus(this->responseEarliestUs, false));
+    write(regs::RX_FWTO, dw3000Uus(spreadUs + frameUs + DW3000_RX_TIMEOUT_MARGIN_US, true));
+}
+
+/*
+ @return PRE_TOC for the current PHY: the spread of the response window plus the preamble while it is armed, DW3000_PREAMBLE_TIMEOUT_US otherwise
+*/
+template <class ConfigT>
+uint16_t DWM3000Driver<ConfigT>::rxPreambleTimeout()
+{
+    if (!this->rxTimeoutsArmed)
+    {
+        return dw3000PreambleTimeout(DW3000_PREAMBLE_TIMEOUT_US, this->config.pacSize);
+    }
+
+    uint32_t preambleUs = (uint64_t)dw3000PreambleSymbols(this->config.preambleLength) * DW3000_SYMBOL_PS / 1000000;
+    return dw3000PreambleTimeout(this->responseLatestUs - this->responseEarliestUs + preambleUs, this->config.pacSize);
+}
+
+/*
+ #####  Double Buffered RX  #####
+*/
+
+/*
+ Turns the second RX buffer on or off. With it the chip switches buffers after every frame and turns the receiver on again (RXAUTR),
+ so a frame that arrives while the host still reads the last one lands in the other buffer instead of being lost.
+ The host reads the frame and its timestamp from the buffer it holds, releaseRxBuffer() hands it back once it is done with it.
+ Signal strength and clock offset are not kept per buffer, they belong to the last frame that arrived.
+ A reset turns it off again.
+ @param enabled True for two buffers, false for the single buffer of the reset
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setDoubleBuffer(bool enabled)
+{
+    this->doubleBuffer = enabled;
+    this->rxBufferIndex = 0;
+    this->rxPending = false;
+
+    TRXOff(); // no frame may land while the buffers change
+    write(regs::RDB_DIAG_MODE_RDB_DMODE, enabled ? 2 : 0); // the mid set of the diagnostics in each buffer, it has IP_TS
+    write(regs::RDB_STATUS.slice(0, 1), 0xFF);
+    writePhyConfig();
+}
+
+/*
+ Hands the RX buffer of the current frame back to the chip, the host goes on with the other one. Nothing happens if the
+ buffer holds no frame (a receiver error or a timeout ended the last wait), so calling it before every standardRX() is safe.
+ If the next frame is already waiting, receivedFrameSucc() reports it without a new event on SYS_STATUS.
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::releaseRxBuffer()
+{
+    if (!this->doubleBuffer)
+    {
+        return;
+    }
+
+    uint32_t status = read(regs::RDB_STATUS.slice(0, 1));
+    uint32_t held = (status >> (4 * this->rxBufferIndex)) & 0xF;
+    if (!(held & regs::RDB_STATUS_RXFR0.mask))
+    {
+        return;
+    }
+
+    beginBatch();
+    write(regs::RDB_STATUS.slice(0, 1), held << (4 * this->rxBufferIndex)); // write 1 to clear
+    writeFastCommand(0x13);                                                 // DB_TOGGLE
+    endBatch();
+
+    this->rxBufferIndex ^= 1;
+    this->rxBufferSwaps++;
+    if ((status >> (4 * this->rxBufferIndex)) & regs::RDB_STATUS_RXFCG0.mask)
+    {
+        this->rxPending = true;
+        this->rxBufferBacklog++;
+    }
+}
+
+/*
+ @return Index of the RX buffer that holds the current frame: 0 for RX_BUFFER_0, 1 for RX_BUFFER_1 (only with setDoubleBuffer())
+*/
+template <class ConfigT>
+int DWM3000Driver<ConfigT>::rxBuffer()
+{
+    return this->doubleBuffer ? this->rxBufferIndex : 0;
+}
+
+/*
+ @return True if releaseRxBuffer() found the next frame already waiting and no clearSystemStatus() took it since.
+ Its RXFCG may be gone from SYS_STATUS (and the IRQ line low) when it arrived before the last frame was cleared.
+*/
+template <class ConfigT>
+bool DWM3000Driver<ConfigT>::rxFrameWaiting()
+{
+    return this->rxPending;
+}
+
+/*
+ @return The RX buffer the host reads the current frame from
+*/
+template <class ConfigT>
+const DW3000Register &DWM3000Driver<ConfigT>::rxBufferData()
+{
+    return rxBuffer() ? regs::RX_BUFFER_1 : regs::RX_BUFFER_0;
 }
 
 /*
@@ -748,20 +1617,31 @@ void DWM3000Class::setTXAntennaDelay(int delay)
 
 /*
  Checks if a frame got received successfully
- @return 1 if successfully received; 2 if RX Status Error occured; 0 if no frame got received
+ @return 1 if successfully received; 2 if RX Status Error occured; 3 if the receive timeouts ran out (setResponseWindow()); 0 if no frame got received
 */
-int DWM3000Class::receivedFrameSucc()
+template <class ConfigT>
+int DWM3000Driver<ConfigT>::receivedFrameSucc()
 {
-    int sys_stat = read(GEN_CFG_AES_LOW_REG, 0x44);
+    if (this->rxPending)
+    {
+        return 1;
+    }
+    int sys_stat = read(regs::SYS_STATUS);
+    int timeouts = regs::SYS_STATUS_RXFTO.mask | regs::SYS_STATUS_RXPTO.mask;
     if ((sys_stat & SYS_STATUS_FRAME_RX_SUCC) > 0)
     {
         return 1;
     }
-    else if ((sys_stat & SYS_STATUS_RX_ERR) > 0)
+    else if ((sys_stat & SYS_STATUS_RX_ERR & ~timeouts) > 0)
     {
-        Serial.printf("%#010x\n", sys_stat); // print hex
+        this->rxErrors = dw3000RxErrors(sys_stat);
         return 2;
     }
+    else if ((sys_stat & timeouts) > 0)
+    {
+        this->rxErrors = dw3000RxErrors(sys_stat);
+        return 3;
+    }
     return 0;
 }
 
@@ -769,9 +1649,10 @@ int DWM3000Class::receivedFrameSucc()
  Checks if a frame got sent successfully
  @return 1 if successfully sent; 2 if TX Status Error occured; 0 if no frame got sent
 */
-int DWM3000Class::sentFrameSucc()
+template <class ConfigT>
+int DWM3000Driver<ConfigT>::sentFrameSucc()
 { // No frame sent: 0; frame sent: 1; error while sending: 2
-    int sys_stat = read(GEN_CFG_AES_LOW_REG, 0x44);
+    int sys_stat = read(regs::SYS_STATUS);
     if ((sys_stat & SYS_STATUS_FRAME_TX_SUCC) == SYS_STATUS_FRAME_TX_SUCC)
     {
         return 1;
@@ -779,38 +1660,157 @@ int DWM3000Class::sentFrameSucc()
     return 0;
 }
 
+/*
+ Routes the events of readEvents() to the IRQ line of the chip, everything else stays off it.
+ init() calls it again, so a sketch may call it before or after init().
+ @param irq The line, begin() has to be done; NULL lets every status bit through, like the driver did before interrupts
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::enableInterrupts(DW3000Irq *irq)
+{
+    this->irq = irq;
+    if (irq == NULL)
+    {
+        write(regs::SYS_ENABLE_LO, 0xFFFFFFFF);
+        write(regs::SYS_ENABLE_HI, 0xFFFF);
+        return;
+    }
+
+    write(regs::SYS_ENABLE_LO, regs::SYS_ENABLE_LO_RXFCG_ENABLE.mask | regs::SYS_ENABLE_LO_TXFRS_ENABLE.mask |
+                                   regs::SYS_ENABLE_LO_RXPHE_ENABLE.mask | regs::SYS_ENABLE_LO_RXFCE_ENABLE.mask |
+                                   regs::SYS_ENABLE_LO_RXFSL_ENABLE.mask | regs::SYS_ENABLE_LO_RXSTO_ENABLE.mask |
+                                   regs::SYS_ENABLE_LO_CIAERR_ENABLE.mask | regs::SYS_ENABLE_LO_RXFTO_ENABLE.mask |
+                                   regs::SYS_ENABLE_LO_RXPTO_ENABLE.mask);
+    write(regs::SYS_ENABLE_HI, 0);
+}
+
+/*
+ Reads SYS_STATUS once and decodes it. With an IRQ line TX_DONE gets cleared right away: it carries nothing the
+ sketch still needs and would keep the line high. The RX events stay set until clearSystemStatus().
+ @return DW3000_EVENT_* bits of what happened since the status was last cleared
+*/
+template <class ConfigT>
+uint32_t DWM3000Driver<ConfigT>::readEvents()
+{
+    uint32_t status = read(regs::SYS_STATUS);
+    uint32_t events = 0;
+
+    if ((status & regs::SYS_STATUS_RXFCG.mask) || this->rxPending)
+    {
+        events |= DW3000_EVENT_RX_GOOD;
+    }
+    if (status & (regs::SYS_STATUS_RXPHE.mask | regs::SYS_STATUS_RXFCE.mask | regs::SYS_STATUS_RXFSL.mask |
+                  regs::SYS_STATUS_RXSTO.mask | regs::SYS_STATUS_CIAERR.mask))
+    {
+        events |= DW3000_EVENT_RX_ERROR;
+    }
+    if (status & (regs::SYS_STATUS_RXFTO.mask | regs::SYS_STATUS_RXPTO.mask))
+    {
+        events |= DW3000_EVENT_RX_TIMEOUT;
+    }
+    if (events & (DW3000_EVENT_RX_ERROR | DW3000_EVENT_RX_TIMEOUT))
+    {
+        this->rxErrors = dw3000RxErrors(status);
+    }
+    if (status & regs::SYS_STATUS_TXFRS.mask)
+    {
+        events |= DW3000_EVENT_TX_DONE;
+        if (this->irq != NULL)
+        {
+            write(regs::SYS_STATUS, 0xF0); // TXFRB, TXPRS, TXPHS, TXFRS
+        }
+    }
+    return events;
+}
+
+/*
+ Waits for one of the events. With an IRQ line the bus stays quiet until the line rises, without one SYS_STATUS gets polled.
+ @param events DW3000_EVENT_* bits that end the wait
+ @param timeoutMs Longest wait
+ @return Every event that happened (see readEvents()), 0 after the timeout
+*/
+template <class ConfigT>
+uint32_t DWM3000Driver<ConfigT>::waitForEvents(uint32_t events, uint32_t timeoutMs)
+{
+    unsigned long start = millis();
+    do
+    {
+        if (this->irq == NULL || this->irq->wait(timeoutMs))
+        {
+            uint32_t happened = readEvents();
+            if (happened & events)
+            {
+                return happened;
+            }
+        }
+    } while (millis() - start <= timeoutMs);
+    return 0;
+}
+
 /*
  Returns the senderID of the received frame.
  @return senderID of the received frame by reading out the frames data
 */
-int DWM3000Class::getSenderID()
+template <class ConfigT>
+int DWM3000Driver<ConfigT>::getSenderID()
 {
-    return read(0x12, 0x01) & 0xFF;
+    return read(rxBufferData().slice(1, 1));
 }
 
 /*
  Returns the destinationID of the received frame.
  @return destinationID of the received frame by reading out the frames data
 */
-int DWM3000Class::getDestinationID()
+template <class ConfigT>
+int DWM3000Driver<ConfigT>::getDestinationID()
 {
-    return read(0x12, 0x02) & 0xFF;
+    return read(rxBufferData().slice(2, 1));
 }
 
 /*
  Checks if the chip has its Power Management System Control (PMSC) module in IDLE mode
  @return True if in IDLE, False if not
  */
-bool DWM3000Class::checkForIDLE()
+template <class ConfigT>
+bool DWM3000Driver<ConfigT>::checkForIDLE()
 {
-    return (read(SYS_STATE_LO_ID) >> 16 & PMSC_STATE_IDLE) == PMSC_STATE_IDLE || (read(SYS_STATUS_ID) >> 16 & (SPIRDY_MASK | RCINIT_MASK)) == (SPIRDY_MASK | RCINIT_MASK) ? 1 : 0;
+    return (read(regs::SYS_STATE_LO) >> 16 & PMSC_STATE_IDLE) == PMSC_STATE_IDLE || (read(regs::SYS_STATUS) >> 16 & (SPIRDY_MASK | RCINIT_MASK)) == (SPIRDY_MASK | RCINIT_MASK) ? 1 : 0;
+}
+
+/*
+ Waits for the chip to come out of a reset.
+ With DW3000_FAST_BOOT it polls the SPIRDY/RCINIT status bits (checkForIDLE()) and returns as soon as they are set,
+ otherwise it sleeps the whole timeout like the fixed delays it replaces.
+ @param timeoutMs Upper bound for the wait in milliseconds
+ @return True if the chip is in IDLE, False if not
+*/
+template <class ConfigT>
+bool DWM3000Driver<ConfigT>::waitForIDLE(uint32_t timeoutMs)
+{
+    if (!DW3000_FAST_BOOT)
+    {
+        delay(timeoutMs);
+        return checkForIDLE();
+    }
+
+    unsigned long start = millis();
+    while (!checkForIDLE())
+    {
+        if (millis() - start >= timeoutMs)
+        {
+            return false;
+        }
+        delayMicroseconds(DW3000_IDLE_POLL_US);
+    }
+    return true;
 }
 
 /*
  Checks if SPI can communicate with the chip
  @return 1 if True, 0 if False
 */
-bool DWM3000Class::checkSPI()
+template <class ConfigT>
+bool DWM3000Driver<ConfigT>::checkSPI()
 {
     return checkForDevID();
 }
@@ -824,11 +1824,15 @@ bool DWM3000Class::checkSPI()
  NOTE: If not using 64MHz PRF: See user manual capter 4.7.2 for an alternative calculation method
  @return The Signal Strength of the received frame in dBm
 */
-double DWM3000Class::getSignalStrength()
+template <class ConfigT>
+double DWM3000Driver<ConfigT>::getSignalStrength()
 {
-    int CIRpower = read(0x0C, 0x2C) & 0x1FF;
-    int PAC_val = read(0x0C, 0x58) & 0xFFF;
-    unsigned int DGC_decision = (read(0x03, 0x60) >> 28) & 0x7;
+    uint8_t diag[48];
+    readBytes(regs::IP_DIAG_1, diag, sizeof(diag)); // IP_DIAG_1 up to IP_DIAG_12 in one transaction
+
+    int CIRpower = bytesToValue(diag, 4) & 0x1FF;
+    int PAC_val = bytesToValue(diag + 0x2C, 4) & 0xFFF;
+    unsigned int DGC_decision = (read(regs::DGC_DBG) >> 28) & 0x7;
     double PRF_const = 121.7;
 
     /*Serial.println("Signal Strength Data:");
@@ -846,14 +1850,18 @@ double DWM3000Class::getSignalStrength()
  Calculates the First Path Signal Strength of the received frame in dBm. Useful to check if a ranging was NLOS or LOS by comparing it to the overall Signal Strength.
  @return The First Path Signal Strength of the received frame in dBm
 */
-double DWM3000Class::getFirstPathSignalStrength()
+template <class ConfigT>
+double DWM3000Driver<ConfigT>::getFirstPathSignalStrength()
 {
-    float f1 = (read(0x0C, 0x30) & 0x3FFFFF) >> 2;
-    float f2 = (read(0x0C, 0x34) & 0x3FFFFF) >> 2;
-    float f3 = (read(0x0C, 0x38) & 0x3FFFFF) >> 2;
+    uint8_t diag[48];
+    readBytes(regs::IP_DIAG_1, diag, sizeof(diag)); // IP_DIAG_1 up to IP_DIAG_12 in one transaction
 
-    int PAC_val = read(0x0C, 0x58) & 0xFFF;
-    unsigned int DGC_decision = (read(0x03, 0x60) >> 28) & 0x7;
+    float f1 = (bytesToValue(diag + 0x04, 4) & 0x3FFFFF) >> 2;
+    float f2 = (bytesToValue(diag + 0x08, 4) & 0x3FFFFF) >> 2;
+    float f3 = (bytesToValue(diag + 0x0C, 4) & 0x3FFFFF) >> 2;
+
+    int PAC_val = bytesToValue(diag + 0x2C, 4) & 0xFFF;
+    unsigned int DGC_decision = (read(regs::DGC_DBG) >> 28) & 0x7;
     double PRF_const = 121.7;
 
     return 10 * log10((pow(f1, 2) + pow(f2, 2) + pow(f3, 2)) / pow(PAC_val, 2)) + (6 * DGC_decision) - PRF_const;
@@ -863,9 +1871,10 @@ double DWM3000Class::getFirstPathSignalStrength()
  Get the currently set Antenna Delay for delayedTX operations
  .@return Antenna Delay
 */
-int DWM3000Class::getTXAntennaDelay()
+template <class ConfigT>
+int DWM3000Driver<ConfigT>::getTXAntennaDelay()
 { // DEPRECATED use this->config.antennaDelay variable instead!
-    int delay = read(0x01, 0x04) & 0xFFFF;
+    int delay = read(regs::TX_ANTD);
     return delay;
 }
 
@@ -873,41 +1882,30 @@ int DWM3000Class::getTXAntennaDelay()
  Get the calculated clock offset between this chip and the chip that sent a frame
  @return Calculated clock offset of the other chip
 */
-long double DWM3000Class::getClockOffset()
+template <class ConfigT>
+long double DWM3000Driver<ConfigT>::getClockOffset()
 {
-    if (this->config.channel == CHANNEL_5)
-    {
-        return getRawClockOffset() * CLOCK_OFFSET_CHAN_5_CONSTANT / 1000000;
-    }
-    else
-    {
-        return getRawClockOffset() * CLOCK_OFFSET_CHAN_9_CONSTANT / 1000000;
-    }
+    return getRawClockOffset() * dw3000ChannelSettings(this->config.channel).clockOffsetConstant / 1000000;
 }
 
 /*
  Get the calculated clock offset from the second chips perspective
  @return Calculated clock offset of this chip from the other chips perspective
 */
-long double DWM3000Class::getClockOffset(int32_t sec_clock_offset)
-{
-    if (this->config.channel == CHANNEL_5)
-    {
-        return sec_clock_offset * CLOCK_OFFSET_CHAN_5_CONSTANT / 1000000;
-    }
-    else
-    {
-        return sec_clock_offset * CLOCK_OFFSET_CHAN_9_CONSTANT / 1000000;
-    }
+template <class ConfigT>
+long double DWM3000Driver<ConfigT>::getClockOffset(int32_t sec_clock_offset)
+{
+    return sec_clock_offset * dw3000ChannelSettings(this->config.channel).clockOffsetConstant / 1000000;
 }
 
 /*
  Get the raw clockset offset from the register of the chip
  @return Raw clock offset
 */
-int DWM3000Class::getRawClockOffset()
+template <class ConfigT>
+int DWM3000Driver<ConfigT>::getRawClockOffset()
 {
-    int raw_offset = read(0x06, 0x29) & 0x1FFFFF;
+    int raw_offset = read(regs::DRX_CAR_INT) & 0x1FFFFF;
 
     if (raw_offset & (1 << 20))
     {
@@ -923,120 +1921,233 @@ int DWM3000Class::getRawClockOffset()
 }
 
 /*
- Activates the chips internal temperature sensor and read its temperature
+ Activates the chips internal temperature sensor and waits for its temperature
  @return the chips current temperature in °C
 */
-float DWM3000Class::getTempInC()
+template <class ConfigT>
+float DWM3000Driver<ConfigT>::getTempInC()
 {
-    write(SAR_TEST_ID, 0x04); // enable temp sensor readings
+    float celsius;
+    startTemperature();
+    while (!readTemperature(&celsius))
+    {
+    };
+    return celsius;
+}
 
-    write(SAR_CTRL_ID, 0x01); // enable poll
+/*
+ Starts a SAR temperature measurement without waiting for it, readTemperature() picks it up
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::startTemperature()
+{
+    write(regs::SAR_TEST, 0x04); // enable temp sensor readings
+    write(regs::SAR_CTRL, 0x01); // enable poll
+}
 
-    while (!(read(0x08, 0x04) & 0x01))
+/*
+ Reads the measurement startTemperature() started, if it is done. Also updates temperature for convertToCM().
+ @param celsius Gets the temperature in °C
+ @return False if the SAR is not done yet (one SPI read), call again later
+*/
+template <class ConfigT>
+bool DWM3000Driver<ConfigT>::readTemperature(float *celsius)
+{
+    if (!read(regs::SAR_STATUS_SAR_DONE))
     {
-    };
+        return false;
+    }
 
-    int res = read(0x08, 0x08);
-    res = (res & 0xFF00) >> 8;
-    int otp_temp = readOTP(0x09) & 0xFF;
-    float tmp = (float)((res - otp_temp) * 1.05f) + 22.0f;
+    int res = read(regs::SAR_READING_SAR_READING_TEMP);
+    int otp_temp = this->calibration.tempRef;
+    *celsius = (float)((res - otp_temp) * 1.05f) + 22.0f;
+    this->temperature = *celsius;
 
-    write(SAR_CTRL_ID, 0x00, 1); // Reset poll enable
+    write(regs::SAR_CTRL, 0x00); // Reset poll enable
 
-    return tmp;
+    return true;
 }
 
 /*
  Reads the internal RX Timestamp. The timestamp is a relative timestamp to the chips internal clock. Units of ~15.65ps. (See DWM3000 User Manual 4.1.7 for more)
  @return The RX Timestamp in units of ~15.65ps
 */
-unsigned long long DWM3000Class::readRXTimestamp()
+template <class ConfigT>
+unsigned long long DWM3000Driver<ConfigT>::readRXTimestamp()
 {
-    uint32_t ts_low = read(0x0C, 0x00);
-    unsigned long long ts_high = read(0x0C, 0x04) & 0xFF;
-
-    unsigned long long rx_timestamp = (ts_high << 32) | ts_low;
+    uint8_t ts[5];
+    if (this->doubleBuffer)
+    {
+        // the diagnostics of the buffer: IP_TS already belongs to the frame in the other one if it arrived
+        readBytes(this->rxBufferIndex ? regs::BUF1_IP_TS : regs::BUF0_IP_TS, ts, 5);
+    }
+    else
+    {
+        readBytes(regs::IP_TS, ts, 5); // all 40 bits in one transaction
+    }
 
-    return rx_timestamp;
+    return bytesToValue(ts, 5);
 }
 
 /*
  Reads the internal TX Timestamp. The timestamp is a relative timestamp to the chips internal clock. Units of ~15.65ps. (See DWM3000 User Manual 3.2 for more)
  @return The TX Timestamp in units of ~15.65ps
 */
-unsigned long long DWM3000Class::readTXTimestamp()
+template <class ConfigT>
+unsigned long long DWM3000Driver<ConfigT>::readTXTimestamp()
+{
+    uint8_t ts[5];
+    readBytes(regs::TX_TIME_LO, ts, 5); // all 40 bits in one transaction
+
+    return bytesToValue(ts, 5);
+}
+
+/*
+ #####  Chip Interaction  #####
+*/
+
+/*
+ Reads a register. Exactly the width of the register gets read, registers wider than 4 bytes need readBytes()
+ @param reg The register (see dw3000_regs.h)
+ @return The value of the register
+*/
+template <class ConfigT>
+uint32_t DWM3000Driver<ConfigT>::read(const DW3000Register &reg)
 {
-    unsigned long long ts_low = read(0x00, 0x74);
-    unsigned long long ts_high = read(0x00, 0x78) & 0xFF;
+    ShadowEntry *entry = findShadow(reg);
+    if (entry != NULL && entry->valid)
+    {
+        this->shadowHits++;
+        return entry->value;
+    }
+
+    uint8_t len = reg.len > 4 ? 4 : reg.len;
+    uint8_t res[4];
 
-    unsigned long long tx_timestamp = (ts_high << 32) + ts_low;
+    const DW3000Register &target = addressable(reg);
+    spiTransfer(target.readHeader, target.headerLen, NULL, res, len);
+    uint32_t value = (uint32_t)bytesToValue(res, len);
 
-    return tx_timestamp;
+    if (entry != NULL)
+    {
+        entry->value = value;
+        entry->valid = true;
+    }
+    return value;
 }
 
-uint32_t DWM3000Class::writereg(int registerID, uint32_t data, int dataLen){
-    uint8_t base = (registerID >> 16) & 0xFF;
-    uint8_t sub = registerID & 0xFF;
-    return readOrWriteFullAddress(base, sub, data, dataLen, 1);
+/*
+ Reads a field of a register
+ @param field The field (see dw3000_regs.h)
+ @return The value of the field, shifted down to bit 0
+*/
+template <class ConfigT>
+uint32_t DWM3000Driver<ConfigT>::read(const DW3000Field &field)
+{
+    return (read(field.reg) & field.mask) >> field.shift;
 }
 
+/*
+ Writes a register. Exactly the width of the register gets written, so a value of 0 clears the whole register.
+ Registers wider than 4 bytes need writeBytes().
+ @param reg The register (see dw3000_regs.h)
+ @param data The data that should be written
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::write(const DW3000Register &reg, uint32_t data)
+{
+    uint8_t len = reg.len > 4 ? 4 : reg.len;
+    uint8_t payload[4];
+
+    if (DEBUG_OUTPUT && len < 4 && data >> len * 8)
+    {
+        Serial.printf("[WARNING] %#x does not fit into %d byte(s) at %02x:%02x\n", (unsigned int)data, len, reg.base, reg.sub);
+    }
+
+    valueToBytes(data, payload, len);
+    const DW3000Register &target = addressable(reg);
+    spiTransfer(target.writeHeader, target.headerLen, payload, NULL, len);
+    updateShadow(reg, len, payload);
+}
 
 /*
- #####  Chip Interaction  #####
+ Writes a field of a register, leaving the rest of the register as it is (read-modify-write)
+ @param field The field (see dw3000_regs.h)
+ @param value The value of the field, starting at bit 0
 */
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::write(const DW3000Field &field, uint32_t value)
+{
+    uint32_t data = read(field.reg);
+    data = (data & ~field.mask) | ((value << field.shift) & field.mask);
+    write(field.reg, data);
+}
 
 /*
- Writes to a specific chip register address
- @param base The chips base register address
- @param sub The chips sub register address
- @param data The data that should be written
- @param dataLen The length of the data that should be written
- @return The result of the write operation (typically 0)
+ Reads a block of bytes from the chip in a single SPI transaction (two if reg starts above DW3000_MAX_HEADER_SUB, see addressable())
+ @param reg The first register (see dw3000_regs.h), len may go past it
+ @param dst The buffer the bytes get copied into (at least len bytes)
+ @param len The number of bytes that should be read
 */
-uint32_t DWM3000Class::write(int base, int sub, uint32_t data, int dataLen)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::readBytes(const DW3000Register &reg, uint8_t *dst, uint16_t len)
 {
-    return readOrWriteFullAddress(base, sub, data, dataLen, 1);
+    const DW3000Register &target = addressable(reg);
+    spiTransfer(target.readHeader, target.headerLen, NULL, dst, len);
 }
 
-uint32_t DWM3000Class::write(int registerID, uint32_t data){
-    uint8_t base = (registerID >> 16) & 0xFF;
-    uint8_t sub = registerID & 0xFF;
-    return write(base, sub, data);
+/*
+ Writes a block of bytes to the chip in a single SPI transaction (two if reg starts above DW3000_MAX_HEADER_SUB, see addressable())
+ @param reg The first register (see dw3000_regs.h), len may go past it
+ @param src The bytes that should be written (least significant byte first)
+ @param len The number of bytes that should be written
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::writeBytes(const DW3000Register &reg, const uint8_t *src, uint16_t len)
+{
+    const DW3000Register &target = addressable(reg);
+    spiTransfer(target.writeHeader, target.headerLen, src, NULL, len);
+    updateShadow(reg, len, src);
 }
 
 /*
- Writes to a specific chip register address and automatically determines the dataLen parameter
+ Writes to a specific chip register address
  @param base The chips base register address
  @param sub The chips sub register address
  @param data The data that should be written
+ @param dataLen The length of the data that should be written in bytes (1 to 4)
  @return The result of the write operation (typically 0)
 */
-uint32_t DWM3000Class::write(int base, int sub, uint32_t data)
+template <class ConfigT>
+uint32_t DWM3000Driver<ConfigT>::write(int base, int sub, uint32_t data, int dataLen)
 {
-    return readOrWriteFullAddress(base, sub, data, 0, 1);
+    write(DW3000Register(base, sub, dataLen), data);
+    return 0;
 }
 
-uint32_t DWM3000Class::read(int registerID)
+/*
+ Writes all 4 bytes at a specific chip register address. Use the regs:: descriptors where the register is known, they have its exact width.
+ @param base The chips base register address
+ @param sub The chips sub register address
+ @param data The data that should be written
+ @return The result of the write operation (typically 0)
+*/
+template <class ConfigT>
+uint32_t DWM3000Driver<ConfigT>::write(int base, int sub, uint32_t data)
 {
-    uint8_t base = (registerID >> 16) & 0xFF;
-    uint8_t sub = registerID & 0xFF;
-    return read(base, sub);
+    return write(base, sub, data, 4);
 }
 
 /*
- Reads from a specific chip register address
+ Reads 4 bytes from a specific chip register address
  @param base The chips base register address
  @param sub The chips sub register address
  @return The result of the read operation
 */
-uint32_t DWM3000Class::read(int base, int sub)
+template <class ConfigT>
+uint32_t DWM3000Driver<ConfigT>::read(int base, int sub)
 {
-    uint32_t tmp;
-    tmp = readOrWriteFullAddress(base, sub, 0, 0, 0);
-    if (DEBUG_OUTPUT)
-        Serial.println("");
-
-    return tmp;
+    return read(DW3000Register(base, sub, 4));
 }
 
 /*
@@ -1045,9 +2156,10 @@ uint32_t DWM3000Class::read(int base, int sub)
  @param sub The chips sub register address
  @return The result of the read operation
 */
-uint8_t DWM3000Class::read8bit(int base, int sub)
+template <class ConfigT>
+uint8_t DWM3000Driver<ConfigT>::read8bit(int base, int sub)
 {
-    return (uint8_t)(read(base, sub) >> 24);
+    return (uint8_t)read(DW3000Register(base, sub, 1));
 }
 
 /*
@@ -1055,12 +2167,153 @@ uint8_t DWM3000Class::read8bit(int base, int sub)
  @param addr The OTP Memory address
  @return The result of the read operation
  */
-uint32_t DWM3000Class::readOTP(uint8_t addr)
+template <class ConfigT>
+uint32_t DWM3000Driver<ConfigT>::readOTP(uint8_t addr)
+{
+    write(regs::OTP_ADDR, addr);
+    write(regs::OTP_CFG.slice(0, 1), 0x02);
+
+    return read(regs::OTP_RDATA);
+}
+
+/*
+ Reads a block of bytes from the chip in a single SPI transaction
+ @param base The chips base register address
+ @param sub The chips sub register address
+ @param dst The buffer the bytes get copied into (at least len bytes)
+ @param len The number of bytes that should be read
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::readBytes(int base, int sub, uint8_t *dst, uint16_t len)
+{
+    readBytes(DW3000Register(base, sub, len), dst, len);
+}
+
+/*
+ Writes a block of bytes to the chip in a single SPI transaction
+ @param base The chips base register address
+ @param sub The chips sub register address
+ @param src The bytes that should be written (least significant byte first)
+ @param len The number of bytes that should be written
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::writeBytes(int base, int sub, const uint8_t *src, uint16_t len)
+{
+    writeBytes(DW3000Register(base, sub, len), src, len);
+}
+
+/*
+ Points an indirect pointer at a byte of a register, the data of the pointer (INDIRECT_PTR_A / INDIRECT_PTR_B) then reads and writes from there on.
+ Unlike the SPI header, the offset can reach every byte of the buffers (RX_BUFFER_0/1, TX_BUFFER, ACC_MEM).
+ @param pointer DW3000_INDIRECT_A or DW3000_INDIRECT_B. The driver itself uses A for accesses past DW3000_MAX_HEADER_SUB, so B stays where it was pointed.
+ @param reg The register (typically one of the buffers)
+ @param offset The first byte, relative to reg
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setIndirectPointer(uint8_t pointer, const DW3000Register &reg, uint16_t offset)
+{
+    uint8_t pointerCfg[8]; // INDIRECT_ADDR_x and ADDR_OFFSET_x are next to each other, both go out in one transaction
+    valueToBytes(reg.base, pointerCfg, 4);
+    valueToBytes(reg.sub + offset, pointerCfg + 4, 4);
+    writeBytes(pointer == DW3000_INDIRECT_B ? regs::INDIRECT_ADDR_B : regs::INDIRECT_ADDR_A, pointerCfg, sizeof(pointerCfg));
+}
+
+/*
+ Reads a block of bytes from where an indirect pointer points (see setIndirectPointer()) in a single SPI transaction
+ @param pointer DW3000_INDIRECT_A or DW3000_INDIRECT_B
+ @param dst The buffer the bytes get copied into (at least len bytes)
+ @param len The number of bytes that should be read
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::readIndirect(uint8_t pointer, uint8_t *dst, uint16_t len)
+{
+    const DW3000Register &ptr = pointer == DW3000_INDIRECT_B ? regs::INDIRECT_PTR_B : regs::INDIRECT_PTR_A;
+    spiTransfer(ptr.readHeader, ptr.headerLen, NULL, dst, len);
+}
+
+/*
+ Writes a block of bytes to where an indirect pointer points (see setIndirectPointer()) in a single SPI transaction
+ @param pointer DW3000_INDIRECT_A or DW3000_INDIRECT_B
+ @param src The bytes that should be written (least significant byte first)
+ @param len The number of bytes that should be written
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::writeIndirect(uint8_t pointer, const uint8_t *src, uint16_t len)
+{
+    const DW3000Register &ptr = pointer == DW3000_INDIRECT_B ? regs::INDIRECT_PTR_B : regs::INDIRECT_PTR_A;
+    spiTransfer(ptr.writeHeader, ptr.headerLen, src, NULL, len);
+}
+
+/*
+ Reads samples of the channel impulse response of the last received frame from the accumulator (ACC_MEM) in one burst.
+ The accumulator clocks get switched on for the read and restored afterwards.
+ @param firstSample The first sample (the first path is around sample 750 at 64 MHz PRF)
+ @param samples The number of samples
+ @param dst At least 1 + samples * DW3000_CIR_SAMPLE_LEN bytes. dst[0] is a dummy byte the chip sends first, the samples start at dst[1].
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::readAccumulator(uint16_t firstSample, uint16_t samples, uint8_t *dst)
+{
+    uint32_t clkCtrl = read(regs::CLK_CTRL);
+    write(regs::CLK_CTRL, clkCtrl | regs::CLK_CTRL_ACC_CLK_EN.mask | regs::CLK_CTRL_ACC_MCLK_EN.mask);
+
+    // always through the pointer: the SPI header could only reach the first 21 samples
+    setIndirectPointer(DW3000_INDIRECT_A, regs::ACC_MEM, firstSample * DW3000_CIR_SAMPLE_LEN);
+    readIndirect(DW3000_INDIRECT_A, dst, 1 + samples * DW3000_CIR_SAMPLE_LEN);
+
+    write(regs::CLK_CTRL, clkCtrl);
+}
+
+/*
+ Starts a batch: writes and fast commands get queued instead of waiting for each of them on the bus.
+ Reads still see every write before them, as they wait for the queue to drain first.
+ Only has an effect on transports with a queue (DW3000IdfSpi), otherwise all transfers are blocking anyway.
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::beginBatch()
+{
+    this->batching = true;
+}
+
+/*
+ Ends a batch. Queued transactions keep going out in the background until the next blocking transfer waits for them.
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::endBatch()
+{
+    this->batching = false;
+}
+
+/*
+ Turns the SPI CRC on or off, on the chip (SYS_CFG SPI_CRC) and in the transport.
+ With CRC on, the transport protects every write with a CRC byte and repeats the ones the chip flags (see dw3000_transport.h).
+ @param mode DW3000_SPI_CRC_OFF, DW3000_SPI_CRC_WRITE or DW3000_SPI_CRC_READ_WRITE
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::enableSpiCrc(uint8_t mode)
 {
-    write(OTP_IF_REG, 0x04, addr);
-    write(OTP_IF_REG, 0x08, 0x02);
+    if ((mode != DW3000_SPI_CRC_OFF) == (this->config.transport->crcMode != DW3000_SPI_CRC_OFF))
+    {
+        this->config.transport->crcMode = mode; // only switching between the modes, the chip stays as it is
+        return;
+    }
+
+    // the write that turns the CRC off still needs one, the one that turns it on does not have one yet
+    write(regs::SYS_CFG_SPI_CRC, mode != DW3000_SPI_CRC_OFF ? 1 : 0);
+    this->config.transport->crcMode = mode;
+}
 
-    return read(OTP_IF_REG, 0x10);
+/*
+ Forgets all shadowed register values, so the next read of each goes to the chip again.
+ Needed whenever the chip may have changed them on its own: after a reset or a wakeup from sleep.
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::invalidateShadow()
+{
+    for (ShadowEntry &entry : this->shadow)
+    {
+        entry.valid = false;
+    }
 }
 
 /*
@@ -1071,9 +2324,10 @@ uint32_t DWM3000Class::readOTP(uint8_t addr)
  Sets a delay for a future TX operation
  @param delay The delay in units of ~4ns (see DWM3000 User Manual 8.2.2.9 for more info)
 */
-void DWM3000Class::writeTXDelay(uint32_t delay)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::writeTXDelay(uint32_t delay)
 {
-    write(DX_TIME_ID, delay);
+    write(regs::DX_TIME, delay);
 }
 
 /*
@@ -1087,7 +2341,8 @@ void DWM3000Class::writeTXDelay(uint32_t delay)
 
  This function calculates the missing delay time, adds it to the frames payload and sets the fixed delay (TRANSMIT_DELAY).
 */
-void DWM3000Class::prepareDelayedTX(int senderID, int destinationID)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::prepareDelayedTX(int senderID, int destinationID)
 {
     long long rx_ts = readRXTimestamp();
 
@@ -1116,9 +2371,12 @@ void DWM3000Class::prepareDelayedTX(int senderID, int destinationID)
       * 7 - Error
       */
 
-    write(0x14, 0x01, senderID & 0xFF);
-    write(0x14, 0x02, destinationID & 0xFF);
-    write(0x14, 0x03, reply_delay); // set frame content
+    uint8_t frame[6] = {(uint8_t)(senderID & 0xFF), (uint8_t)(destinationID & 0xFF)};
+    for (int i = 0; i < 4; i++)
+    {
+        frame[2 + i] = (reply_delay >> i * 8) & 0xFF;
+    }
+    writeBytes(regs::TX_BUFFER.slice(1, 6), frame, sizeof(frame)); // set frame content
 
     setFrameLength(7); // Control Byte (1 Byte) + Sender ID (1 Byte) + Dest. ID (1 Byte) + Reply Delay (4 Bytes) = 7 Bytes
 
@@ -1133,41 +2391,76 @@ void DWM3000Class::prepareDelayedTX(int senderID, int destinationID)
 /*
  Activates delayed message transfer and switches to receive mode after TX is finished
 */
-void DWM3000Class::delayedTXThenRX()
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::delayedTXThenRX()
 {
+    if (this->doubleBuffer)
+    {
+        TRXOff(); // see TXInstantRX()
+    }
     writeFastCommand(0x0F);
 }
 
 /*
  Activates delayed message transfer
 */
-void DWM3000Class::delayedTX()
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::delayedTX()
 {
+    if (this->doubleBuffer)
+    {
+        TRXOff(); // see TXInstantRX()
+    }
     writeFastCommand(0x3);
 }
 
 /*
  Performs a standard TX command
 */
-void DWM3000Class::standardTX()
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::standardTX()
+{
+    if (this->doubleBuffer)
+    {
+        TRXOff(); // see TXInstantRX()
+    }
+    writeFastCommand(0x01);
+}
+
+/*
+ Performs a standard RX command. The receiver waits for a frame without the timeouts of the response window.
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::standardRX()
 {
-    DWM3000Class::writeFastCommand(0x01);
+    if (this->rxTimeoutsArmed)
+    {
+        TRXOff(); // the receiver may still wait for an answer with the timeouts on
+        armRxTimeouts(false);
+    }
+    writeFastCommand(0x02);
 }
 
 /*
- Performs a standard RX command
+ Performs a TX operation and switches to Receiver mode W4R_TIM after it, with the receive timeouts that are set
 */
-void DWM3000Class::standardRX()
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::TXInstantRX()
 {
-    DWM3000Class::writeFastCommand(0x02);
+    if (this->doubleBuffer)
+    {
+        TRXOff(); // RXAUTR turned the receiver on again after the last frame, the chip only transmits from IDLE
+    }
+    writeFastCommand(0x0C);
 }
 
 /*
- Performs a TX operation and instantly switches to Receiver mode
+ Turns the transmitter and the receiver off, the chip goes back to IDLE
 */
-void DWM3000Class::TXInstantRX()
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::TRXOff()
 {
-    DWM3000Class::writeFastCommand(0x0C);
+    writeFastCommand(0x00);
 }
 
 /*
@@ -1177,38 +2470,54 @@ void DWM3000Class::TXInstantRX()
 /*
  Soft resets the chip via software
 */
-void DWM3000Class::softReset()
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::softReset()
 {
+    this->config.transport->setClock(DW3000_SPI_SLOW_HZ); // the chip runs from its RC oscillator until the PLL locks again
+    enableSpiCrc(DW3000_SPI_CRC_OFF);                      // the reset turns it off on the chip, init() turns it on again
     clearAONConfig();
 
-    write(CLK_CTRL_ID, 0x1); // force clock to FAST_RC/4 clock
-
-    writereg(SOFT_RST_ID, 0x00, 2); // init reset
-
-    delay(100);
+    write(regs::CLK_CTRL.slice(0, 1), 0x1); // force clock to FAST_RC/4 clock
+    write(regs::SOFT_RST, 0x00);            // init reset
+    delay(DW3000_FAST_BOOT ? 1 : 100);      // the SDK holds the reset for 1 ms
+    write(regs::SOFT_RST, 0xFFFF);          // return back
+    write(regs::CLK_CTRL.slice(0, 1), 0x0); // set clock back to Auto mode
 
-    write(SOFT_RST_ID, 0xFFFF); // return back
-
-    write(CLK_CTRL_ID, 0x00, 1); // set clock back to Auto mode
+    invalidateShadow();
+    this->rxTimeoutsArmed = false; // RXWTOE is off after the reset
+    this->doubleBuffer = false;    // and DIS_DRXB on
+    this->rxBufferIndex = 0;
+    this->rxPending = false;
 }
 
 /*
  Resets the Chip by physically pulling the this->config.rstPin to LOW
 */
-void DWM3000Class::hardReset()
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::hardReset()
 {
     pinMode(this->config.rstPin, OUTPUT);
     digitalWrite(this->config.rstPin, LOW); // set reset pin active low to hard-reset DWM3000 chip
     delay(10);
     pinMode(this->config.rstPin, INPUT); // get pin back in floating state
+
+    this->config.transport->setClock(DW3000_SPI_SLOW_HZ);
+    this->config.transport->crcMode = DW3000_SPI_CRC_OFF;
+    invalidateShadow();
+    this->rxTimeoutsArmed = false;
+    this->doubleBuffer = false;
+    this->rxBufferIndex = 0;
+    this->rxPending = false;
 }
 
 /*
  Clears all System Status flags
 */
-void DWM3000Class::clearSystemStatus()
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::clearSystemStatus()
 {
-    write(GEN_CFG_AES_LOW_REG, 0x44, 0x3F7FFFFF);
+    write(regs::SYS_STATUS, 0x3F7FFFFF);
+    this->rxPending = false;
 }
 
 /*
@@ -1224,15 +2533,19 @@ void DWM3000Class::clearSystemStatus()
  @param DWM3000_ps_units DWM3000 internal picosecond units. Gets returned from timestamps for example.
  @return The distance in cm
 */
-double DWM3000Class::convertToCM(int DWM3000_ps_units)
+template <class ConfigT>
+double DWM3000Driver<ConfigT>::convertToCM(int DWM3000_ps_units)
 {
-    return (double)DWM3000_ps_units * PS_UNIT * SPEED_OF_LIGHT;
+    // antenna delay growth of this chip since its calibration, up to date as of the last readTemperature()
+    double drift = (this->temperature - this->antennaDelayTemp) * this->antennaDelayTicksPerC;
+    return ((double)DWM3000_ps_units - drift) * PS_UNIT * SPEED_OF_LIGHT;
 }
 
 /*
  Calculate the Round Trip Time (RTT) for a ping operation and print out the distance in cm
 */
-void DWM3000Class::calculateTXRXdiff()
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::calculateTXRXdiff()
 {
     unsigned long long ping_tx = readTXTimestamp();
     unsigned long long ping_rx = readRXTimestamp();
@@ -1259,7 +2572,7 @@ void DWM3000Class::calculateTXRXdiff()
       * 7 - Error
       */
 
-    long long t_reply = read(RX_BUFFER_0_REG, 0x03);
+    long long t_reply = read(rxBufferData().slice(3, 4));
 
     /*
      * Calculate round trip time (see DWM3000 User Manual page 248 for more)
@@ -1290,7 +2603,8 @@ void DWM3000Class::calculateTXRXdiff()
 /*
  Debug Output to print the Round Trip Time (RTT) and essential additional information
 */
-void DWM3000Class::printRoundTripInformation()
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::printRoundTripInformation()
 {
     Serial.println("\nRound Trip Information:");
     long long tx_ts = readTXTimestamp();
@@ -1308,7 +2622,8 @@ void DWM3000Class::printRoundTripInformation()
  @param precision Precision is 1 followed by the number of zeros for the desired number of decimal places. Example: printDouble (3.14159, 1000); prints 3.141 (three decimal places).
  @param linebreak If True, a linebreak will be added after the print (equal to Serial.println()). If not, no linebreak (equal to Serial.print())
 */
-void DWM3000Class::printDouble(double val, unsigned int precision, bool linebreak)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::printDouble(double val, unsigned int precision, bool linebreak)
 {                           // https://forum.arduino.cc/t/printing-a-double-variable/44327/2
     Serial.print(int(val)); // print the integer part
     Serial.print(".");      // print the decimal point
@@ -1339,19 +2654,36 @@ void DWM3000Class::printDouble(double val, unsigned int precision, bool linebrea
  #####  Single Bit Settings  #####
 */
 
-void DWM3000Class::setBit(int registerID, int shift, bool b)
+/*
+ Sets a bit of a register, leaving the others as they are
+ @param reg The register
+ @param shift The bit that should be modified (0 for bit 0, 1 for bit 1, etc.)
+ @param b The state that the bit should be set to. True if should be set to 1, False if 0
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setBit(const DW3000Register &reg, int shift, bool b)
 {
-    setBit(REGBASE(registerID), REGSUB(registerID), shift, b);
+    uint32_t value = read(reg);
+    if (b)
+    {
+        bitSet(value, shift);
+    }
+    else
+    {
+        bitClear(value, shift);
+    }
+    write(reg, value);
 }
 
 /*
  Set bit in a defined register address
  @param reg_addr The registers base address
  @param sub_addr The registers sub address
- @param shift The bit that should be modified, relative to the base and sub address (0 for bit 0, 1 for bit 1, etc.)
+ @param shift The bit of the byte at the base and sub address that should be modified (0 for bit 0, 1 for bit 1, etc.)
  @param b The state that the bit should be set to. True if should be set to 1, False if 0
 */
-void DWM3000Class::setBit(int reg_addr, int sub_addr, int shift, bool b)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setBit(int reg_addr, int sub_addr, int shift, bool b)
 {
     uint8_t tmpByte = read8bit(reg_addr, sub_addr);
     if (b)
@@ -1362,12 +2694,7 @@ void DWM3000Class::setBit(int reg_addr, int sub_addr, int shift, bool b)
     {
         bitClear(tmpByte, shift);
     }
-    write(reg_addr, sub_addr, tmpByte);
-}
-
-void DWM3000Class::setBitHigh(int registerID, int shift)
-{
-    setBit(REGBASE(registerID), REGSUB(registerID), shift, 1);
+    write(reg_addr, sub_addr, tmpByte, 1);
 }
 
 /*
@@ -1376,7 +2703,8 @@ void DWM3000Class::setBitHigh(int registerID, int shift)
  @param sub_addr The registers sub address
  @param shift The bit that should be modified, relative to the base and sub address (0 for bit 0, 1 for bit 1, etc.)
 */
-void DWM3000Class::setBitHigh(int reg_addr, int sub_addr, int shift)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setBitHigh(int reg_addr, int sub_addr, int shift)
 {
     setBit(reg_addr, sub_addr, shift, 1);
 }
@@ -1387,7 +2715,8 @@ void DWM3000Class::setBitHigh(int reg_addr, int sub_addr, int shift)
  @param sub_addr The registers sub address
  @param shift The bit that should be modified, relative to the base and sub address (0 for bit 0, 1 for bit 1, etc.)
 */
-void DWM3000Class::setBitLow(int reg_addr, int sub_addr, int shift)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::setBitLow(int reg_addr, int sub_addr, int shift)
 {
     setBit(reg_addr, sub_addr, shift, 0);
 }
@@ -1400,7 +2729,8 @@ void DWM3000Class::setBitLow(int reg_addr, int sub_addr, int shift)
  Writes a Fast Command to the chip (See DWM3000 User Manual chapter 9 for more)
  @param cmd The command that should be sent
 */
-void DWM3000Class::writeFastCommand(int cmd)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::writeFastCommand(int cmd)
 {
     if (DEBUG_OUTPUT)
         Serial.print("[INFO] Executing short command: ");
@@ -1414,9 +2744,9 @@ void DWM3000Class::writeFastCommand(int cmd)
     if (DEBUG_OUTPUT)
         Serial.println(header, BIN);
 
-    int header_arr[] = {header};
+    uint8_t header_arr[] = {(uint8_t)header};
 
-    sendBytes(header_arr, 1, 0);
+    spiTransfer(header_arr, 1, NULL, NULL, 0);
 }
 
 /*
@@ -1424,133 +2754,112 @@ void DWM3000Class::writeFastCommand(int cmd)
 */
 
 /*
- Helper function to read or write to a specific chip register address
- @param base The base register address
- @param sub  The sub register address
- @param data The data that should be written (if anything should be written, else left at 0)
- @param dataLen The length of the data that should be sent in bits. Can be left at zero to automatically determine the data length,
-        but can be very useful if e.g. 32 bits of 0x00 should be written
- @param readWriteBit Defines if a read or write operation will be performed. 0 if data should be read back, 1 if only a write should be performed.
- @return Returns 0 or the result of the read operation
-*/
-uint32_t DWM3000Class::readOrWriteFullAddress(uint32_t base, uint32_t sub, uint32_t data, uint32_t dataLen, uint32_t readWriteBit)
+ Internal helper function that performs one SPI transaction through the configured transport.
+ The header and all data bytes are sent in a single CS assertion, so a buffer of any length costs a single transaction.
+ Every transaction ends up in the tracer (a no-op unless DW3000_TRACE_DEPTH is set).
+ @param header The header bytes
+ @param headerLen The length of the header in bytes
+ @param tx The bytes that should be written after the header, or NULL when reading
+ @param rx The buffer that receives the bytes clocked in after the header, or NULL when writing
+ @param len The number of data bytes after the header
+ */
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::spiTransfer(const uint8_t *header, uint8_t headerLen, const uint8_t *tx, uint8_t *rx, uint16_t len)
 {
-    uint32_t header = 0x00;
-
-    if (readWriteBit)
-        header = header | 0x80;
+    uint32_t start = DW3000_TRACE_DEPTH ? DW3000Trace::now() : 0;
+    uint8_t crcMode = this->config.transport->crcMode;
+    bool crcChecked = rx != NULL ? crcMode == DW3000_SPI_CRC_READ_WRITE : crcMode != DW3000_SPI_CRC_OFF;
+    uint8_t traceFlags = crcChecked ? DW3000_TRACE_CRC : 0;
 
-    header = header | ((base & 0x1F) << 1);
-
-    if (sub > 0)
+    if (this->batching && rx == NULL)
     {
-        header = header | 0x40;
-        header = header << 8;
-        header = header | ((sub & 0x7F) << 2);
+        this->config.transport->queue(header, headerLen, tx, len);
+        this->trace.record(start, header, headerLen, tx, len, traceFlags | DW3000_TRACE_QUEUED);
     }
+    else
+    {
+        this->config.transport->transfer(header, headerLen, tx, rx, len);
+        this->trace.record(start, header, headerLen, rx != NULL ? rx : tx, len, traceFlags | (rx != NULL ? DW3000_TRACE_READ : 0));
+    }
+}
 
-    uint32_t header_size = header > 0xFF ? 2 : 1;
-    uint32_t res = 0;
-
-    if (!readWriteBit)
+/*
+ Makes a register reachable for an SPI transaction: the SPI header only carries sub addresses up to DW3000_MAX_HEADER_SUB,
+ for anything above (e.g. RX_BUFFER_0.slice(200, 16)) indirect pointer A gets pointed at it and is accessed instead.
+ @param reg The register
+ @return reg itself, or INDIRECT_PTR_A
+*/
+template <class ConfigT>
+const DW3000Register &DWM3000Driver<ConfigT>::addressable(const DW3000Register &reg)
+{
+    if (!reg.indirect())
     {
-        int headerArr[header_size];
+        return reg;
+    }
 
-        if (header_size == 1)
-        {
-            headerArr[0] = header;
-        }
-        else
-        {
-            headerArr[0] = (header & 0xFF00) >> 8;
-            headerArr[1] = header & 0xFF;
-        }
+    setIndirectPointer(DW3000_INDIRECT_A, reg, 0);
+    return regs::INDIRECT_PTR_A;
+}
 
-        res = (uint32_t)sendBytes(headerArr, header_size, 4);
-        return res;
-    }
-    else
-    {
-        uint32_t payload_bytes = 0;
-        if (dataLen == 0)
-        {
-            if (data > 0)
-            {
-                uint32_t payload_bits = countBits(data);
-                payload_bytes = (payload_bits - (payload_bits % 8)) / 8; // calc the used bytes for transaction
-                if ((payload_bits % 8) > 0)
-                {
-                    payload_bytes++;
-                }
-            }
-            else
-            {
-                payload_bytes = 1;
-            }
-        }
-        else
-        {
-            payload_bytes = dataLen;
-        }
-        int payload[header_size + payload_bytes];
+/*
+ #####  Register Shadow  #####
+*/
 
-        if (header_size == 1)
-        {
-            payload[0] = header;
-        }
-        else
-        {
-            payload[0] = (header & 0xFF00) >> 8;
-            payload[1] = header & 0xFF;
-        }
+/*
+ Finds the shadow of a register
+ @param reg The register that is accessed
+ @return The shadow entry, NULL if reg is not shadowed (or DW3000_SHADOW_REGISTERS is off)
+*/
+template <class ConfigT>
+typename DWM3000Driver<ConfigT>::ShadowEntry *DWM3000Driver<ConfigT>::findShadow(const DW3000Register &reg)
+{
+    if (!DW3000_SHADOW_REGISTERS)
+    {
+        return NULL;
+    }
 
-        for (int i = 0; i < payload_bytes; i++)
+    for (ShadowEntry &entry : this->shadow)
+    {
+        if (entry.reg.base == reg.base && entry.reg.sub == reg.sub && entry.reg.len == reg.len)
         {
-            payload[header_size + i] = (data >> i * 8) & 0xFF;
+            return &entry;
         }
-
-        res = (uint32_t)sendBytes(payload, 2 + payload_bytes, 0); // "2 +" because the first 2 bytes are the header part
-        return res;
     }
+    return NULL;
 }
 
 /*
- Internal helper function to send and receive Bytes through the SPI Interface
- @param b The bytes to be sent as an array
- @param lenB The length of the array b
- @param recLen The length of bytes that should be received back after sending the data b
- @return Returns 0 or the received bytes from the chip
- */
-uint32_t DWM3000Class::sendBytes(int b[], int lenB, int recLen)
+ Keeps the shadow in line with a write: a write of a whole shadowed register becomes its new value,
+ a write that covers only part of one invalidates it
+ @param reg The register that was written
+ @param len The number of bytes that were written
+ @param data The bytes that were written
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::updateShadow(const DW3000Register &reg, uint16_t len, const uint8_t *data)
 {
-    digitalWrite(this->config.csPin, LOW);
-    for (int i = 0; i < lenB; i++)
+    if (!DW3000_SHADOW_REGISTERS)
     {
-        this->config.spi.transfer(b[i]);
+        return;
     }
-    int rec;
-    uint32_t val, tmp;
-    if (recLen > 0)
+
+    for (ShadowEntry &entry : this->shadow)
     {
-        for (int i = 0; i < recLen; i++)
+        if (entry.reg.base != reg.base || reg.sub >= entry.reg.sub + entry.reg.len || entry.reg.sub >= reg.sub + len)
         {
-            tmp = this->config.spi.transfer(0x00);
-            if (i == 0)
-            {
-                val = tmp; // Read first 4 octets
-            }
-            else
-            {
-                val |= (uint32_t)tmp << 8 * i;
-            }
+            continue;
+        }
+
+        if (entry.reg.sub == reg.sub && entry.reg.len == len)
+        {
+            entry.value = (uint32_t)bytesToValue(data, len);
+            entry.valid = true;
+        }
+        else
+        {
+            entry.valid = false;
         }
     }
-    else
-    {
-        val = 0;
-    }
-    digitalWrite(this->config.csPin, HIGH);
-    return val;
 }
 
 /*
@@ -1560,38 +2869,111 @@ uint32_t DWM3000Class::sendBytes(int b[], int lenB, int recLen)
 /*
  Clears the Always On register. This register stores information as long as power is supplied to the chip.
 */
-void DWM3000Class::clearAONConfig()
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::clearAONConfig()
 {
-    write(AON_REG, NO_OFFSET, 0x00, 2);
-    write(AON_REG, 0x14, 0x00, 1);
+    write(regs::AON_DIG_CFG.slice(0, 2), 0x00);
+    write(regs::AON_CFG, 0x00);
 
-    write(AON_REG, 0x04, 0x00, 1); // clear control of aon reg
+    write(regs::AON_CTRL, 0x00); // clear control of aon reg
 
-    write(AON_REG, 0x04, 0x02);
+    write(regs::AON_CTRL, 0x02);
 
     delay(1);
 }
 
+/*
+ Fills calibration from the OTP memory. With DW3000_FAST_BOOT a valid calibration of the same chip (same PARTID) is kept,
+ which saves 5 of the 6 OTP reads.
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::readCalibration()
+{
+    uint32_t partId = readOTP(0x06);
+
+    this->calibrationFromCache = DW3000_FAST_BOOT && this->calibration.valid && this->calibration.partId == partId;
+    if (this->calibrationFromCache)
+    {
+        return;
+    }
+
+    this->calibration.partId = partId;
+    this->calibration.ldoLow = readOTP(0x04);
+    this->calibration.ldoHigh = readOTP(0x05);
+    this->calibration.biasTune = (readOTP(0xA) >> 16) & BIAS_CTRL_BIAS_MASK;
+    this->calibration.xtalTrim = readOTP(0x1E);
+    this->calibration.tempRef = readOTP(0x09) & 0xFF;
+    this->calibration.valid = true;
+}
+
+/*
+ Writes the DW3000ChannelSettings of the configured channel as one batch: RF_TX_CTRL_2, PLL_CFG and the DGC lookup table,
+ whose seven registers go out as a single 28 byte burst. The PLL has to lock again afterwards (see writeSysConfig()).
+ RF_TX_CTRL_2 is TX_CTRL_HI, its PG delay comes from setPGDelay() instead of the table.
+*/
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::writeChannelSettings()
+{
+    const DW3000ChannelSettings &settings = dw3000ChannelSettings(this->config.channel);
+    const DW3000Register dgcLut(regs::DGC_LUT_0_CFG.base, regs::DGC_LUT_0_CFG.sub, sizeof(settings.dgcLut));
+
+    uint8_t lut[sizeof(settings.dgcLut)];
+    for (int i = 0; i < 7; i++)
+    {
+        valueToBytes(settings.dgcLut[i], lut + i * 4, 4);
+    }
+
+    beginBatch();
+    write(regs::RF_TX_CTRL_2, (settings.rfTxCtrl2 & ~regs::TX_CTRL_HI_TX_PG_DELAY.mask) | this->pgDelay);
+    write(regs::PLL_CFG, settings.pllCfg);
+    writeBytes(dgcLut, lut, sizeof(lut));
+    endBatch();
+}
+
 /*
  #####  Other Helper Methods  #####
 */
 
 /*
- Helper function to count the bits of a number
- return length of a number in bits
+ Helper function to assemble a little endian value from bytes read off the chip
+ @param bytes The bytes in the order they were received (least significant first)
+ @param len The number of bytes (up to 8)
+ @return The assembled value
+*/
+template <class ConfigT>
+unsigned long long DWM3000Driver<ConfigT>::bytesToValue(const uint8_t *bytes, uint8_t len)
+{
+    unsigned long long val = 0;
+    for (int i = len - 1; i >= 0; i--)
+    {
+        val = (val << 8) | bytes[i];
+    }
+    return val;
+}
+
+/*
+ Helper function to split a value into the little endian bytes the chip expects
+ @param value The value
+ @param bytes Receives the bytes, least significant first
+ @param len The number of bytes (up to 8)
 */
-unsigned int DWM3000Class::countBits(unsigned int number)
+template <class ConfigT>
+void DWM3000Driver<ConfigT>::valueToBytes(unsigned long long value, uint8_t *bytes, uint8_t len)
 {
-    return (int)log2(number) + 1;
+    for (int i = 0; i < len; i++)
+    {
+        bytes[i] = (value >> i * 8) & 0xFF;
+    }
 }
 
 /*
  Checks if a DeviceID can be read from the device (if not, SPI can not connect to the chip). Acts as a sanity check.
  @return 1 if DeviceID could be read; 0 if not.
 */
-int DWM3000Class::checkForDevID()
+template <class ConfigT>
+int DWM3000Driver<ConfigT>::checkForDevID()
 {
-    int res = read(DEV_ID_ID);
+    uint32_t res = read(regs::DEV_ID);
     if (res != 0xDECA0302 && res != 0xDECA0312)
     {
         Serial.println("[ERROR] DEV_ID IS WRONG!");
@@ -1599,3 +2981,5 @@ int DWM3000Class::checkForDevID()
     }
     return 1;
 }
+
+typedef DWM3000Driver<DWM3000Config> DWM3000Class;
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "dw3000_api.h"
+
+/*
+ Compile time configurations for DWM3000<Board, Phy>: a board fixes the pins, a PHY fixes the radio settings.
+ A sketch for a different wiring or radio setup derives from one of them and overrides the constants it changes.
+*/
+
+/*
+ ESP32-WROOM devboard, DWM3000 on VSPI
+*/
+struct DW3000BoardEsp32Wroom
+{
+    static constexpr uint8_t csPin = 4;
+    static constexpr uint8_t rstPin = 27;
+    static constexpr uint8_t mosiPin = 23;
+    static constexpr uint8_t misoPin = 19;
+    static constexpr uint8_t sckPin = 18;
+    static constexpr uint8_t irqPin = 34; // input only, which is all the IRQ line needs
+};
+
+/*
+ ESP32-WROOM devboard, second DWM3000 on the default HSPI pins (GPIO12 is a strapping pin, keep it low at boot)
+*/
+struct DW3000BoardEsp32WroomHspi
+{
+    static constexpr uint8_t csPin = 15;
+    static constexpr uint8_t rstPin = 26;
+    static constexpr uint8_t mosiPin = 13;
+    static constexpr uint8_t misoPin = 12;
+    static constexpr uint8_t sckPin = 14;
+    static constexpr uint8_t irqPin = 35;
+};
+
+/*
+ WT32-ETH01, DWM3000 on the pins the ethernet PHY leaves free
+*/
+struct DW3000BoardWt32Eth01
+{
+    static constexpr uint8_t csPin = 5;
+    static constexpr uint8_t rstPin = 27;
+    static constexpr uint8_t mosiPin = 12;
+    static constexpr uint8_t misoPin = 15;
+    static constexpr uint8_t sckPin = 14;
+    static constexpr uint8_t irqPin = 35;
+};
+
+/*
+ PHY profiles: radio settings that belong together, the same on the tag and all anchors.
+ The PAC size follows the preamble length, writeSysConfig() derives the SFD and preamble detection timeouts from both.
+ Airtime of a 12 byte ranging frame: ~4.3 ms long range, ~1.1 ms medium, ~0.2 ms fast.
+*/
+
+/*
+ 4096 symbol preamble, 850 kb/s: the most link budget, for long distances
+*/
+template <uint8_t Channel = CHANNEL_5>
+struct DW3000PhyLongRange
+{
+    static constexpr const char *name = "long";
+    static constexpr uint8_t channel = Channel;
+    static constexpr uint8_t preambleLength = PREAMBLE_4096;
+    static constexpr uint8_t preambleCode = 9;
+    static constexpr uint8_t pacSize = dw3000RecommendedPac(preambleLength);
+    static constexpr uint8_t dataRate = DATARATE_850KB;
+    static constexpr uint8_t phrMode = PHR_MODE_STANDARD;
+    static constexpr uint8_t phrRate = PHR_RATE_850KB;
+};
+
+/*
+ 1024 symbol preamble, 6.8 Mb/s data and PHR: between the two, for medium distances
+*/
+template <uint8_t Channel = CHANNEL_5>
+struct DW3000PhyMedium
+{
+    static constexpr const char *name = "medium";
+    static constexpr uint8_t channel = Channel;
+    static constexpr uint8_t preambleLength = PREAMBLE_1024;
+    static constexpr uint8_t preambleCode = 9;
+    static constexpr uint8_t pacSize = dw3000RecommendedPac(preambleLength);
+    static constexpr uint8_t dataRate = DATARATE_6_8MB;
+    static constexpr uint8_t phrMode = PHR_MODE_STANDARD;
+    static constexpr uint8_t phrRate = PHR_RATE_6_8MB;
+};
+
+/*
+ 128 symbol preamble, 6.8 Mb/s data and PHR: short frames, for short distances and high ranging rates
+*/
+template <uint8_t Channel = CHANNEL_5>
+struct DW3000PhyFast
+{
+    static constexpr const char *name = "fast";
+    static constexpr uint8_t channel = Channel;
+    static constexpr uint8_t preambleLength = PREAMBLE_128;
+    static constexpr uint8_t preambleCode = 9;
+    static constexpr uint8_t pacSize = dw3000RecommendedPac(preambleLength);
+    static constexpr uint8_t dataRate = DATARATE_6_8MB;
+    static constexpr uint8_t phrMode = PHR_MODE_STANDARD;
+    static constexpr uint8_t phrRate = PHR_RATE_6_8MB;
+};
+
+/*
+ @return The settings of a compile time profile as a DW3000Phy, for setPhy()
+*/
+template <class Phy>
+constexpr DW3000Phy dw3000Phy()
+{
+    return {Phy::name, Phy::channel, Phy::preambleLength, Phy::preambleCode, Phy::pacSize, Phy::dataRate, Phy::phrMode, Phy::phrRate};
+}
+
+#define DW3000_PHY_PROFILE_COUNT 3
+
+/*
+ The profiles a link can switch between, most robust first. Frames that negotiate a switch carry the index into it.
+*/
+template <uint8_t Channel = CHANNEL_5>
+struct DW3000PhyProfiles
+{
+    static constexpr DW3000Phy all[DW3000_PHY_PROFILE_COUNT] = {
+        dw3000Phy<DW3000PhyLongRange<Channel>>(),
+        dw3000Phy<DW3000PhyMedium<Channel>>(),
+        dw3000Phy<DW3000PhyFast<Channel>>(),
+    };
+};
+
+/*
+ @param channel CHANNEL_5 or CHANNEL_9, chosen at runtime
+ @param index Index into DW3000PhyProfiles
+ @return The profile, for setPhy()
+*/
+inline const DW3000Phy &dw3000PhyProfile(uint8_t channel, int index)
+{
+    return channel == CHANNEL_9 ? DW3000PhyProfiles<CHANNEL_9>::all[index] : DW3000PhyProfiles<CHANNEL_5>::all[index];
+}
+
+/*
+ @return Index of a compile time profile in DW3000PhyProfiles, 0 if it is not one of them
+*/
+template <class Phy>
+constexpr int dw3000PhyProfileIndex()
+{
+    for (int i = 0; i < DW3000_PHY_PROFILE_COUNT; i++)
+    {
+        const DW3000Phy &phy = DW3000PhyProfiles<Phy::channel>::all[i];
+        if (phy.preambleLength == Phy::preambleLength && phy.dataRate == Phy::dataRate && phy.phrRate == Phy::phrRate)
+        {
+            return i;
+        }
+    }
+    return 0;
+}
+
+typedef DW3000PhyLongRange<CHANNEL_5> DW3000PhyCh5Long;
+typedef DW3000PhyLongRange<CHANNEL_9> DW3000PhyCh9Long;
+typedef DW3000PhyFast<CHANNEL_5> DW3000PhyCh5Short;
+typedef DW3000PhyFast<CHANNEL_9> DW3000PhyCh9Short;
+
+/*
+ Configuration of DWM3000<Board, Phy>: only the transport and the antenna delay are left to runtime
+ (the transport is an object of the sketch, the antenna delay gets calibrated per device)
+*/
+template <class Board, class Phy>
+struct DWM3000StaticConfig
+{
+    DW3000Transport *transport;
+    int antennaDelay;
+
+    static constexpr uint8_t csPin = Board::csPin;
+    static constexpr uint8_t rstPin = Board::rstPin;
+    static constexpr uint8_t mosiPin = Board::mosiPin;
+    static constexpr uint8_t misoPin = Board::misoPin;
+    static constexpr uint8_t sckPin = Board::sckPin;
+
+    static constexpr uint8_t channel = Phy::channel;
+    static constexpr uint8_t preambleLength = Phy::preambleLength;
+    static constexpr uint8_t preambleCode = Phy::preambleCode;
+    static constexpr uint8_t pacSize = Phy::pacSize;
+    static constexpr uint8_t dataRate = Phy::dataRate;
+    static constexpr uint8_t phrMode = Phy::phrMode;
+    static constexpr uint8_t phrRate = Phy::phrRate;
+};
+
+template <class Board, class Phy>
+using DWM3000 = DWM3000Driver<DWM3000StaticConfig<Board, Phy>>;
+
+/*
+ Configuration of DWM3000Switchable<Board, Phy>: the board fixes the pins, the radio settings start as Phy
+ and can change at runtime (setPhy(), the Radio Settings setters)
+*/
+template <class Board, class Phy>
+struct DWM3000BoardConfig
+{
+    DW3000Transport *transport;
+    int antennaDelay;
+
+    uint8_t channel = Phy::channel;
+    uint8_t preambleLength = Phy::preambleLength;
+    uint8_t preambleCode = Phy::preambleCode;
+    uint8_t pacSize = Phy::pacSize;
+    uint8_t dataRate = Phy::dataRate;
+    uint8_t phrMode = Phy::phrMode;
+    uint8_t phrRate = Phy::phrRate;
+
+    static constexpr uint8_t csPin = Board::csPin;
+    static constexpr uint8_t rstPin = Board::rstPin;
+    static constexpr uint8_t mosiPin = Board::mosiPin;
+    static constexpr uint8_t misoPin = Board::misoPin;
+    static constexpr uint8_t sckPin = Board::sckPin;
+};
+
+template <class Board, class Phy>
+using DWM3000Switchable = DWM3000Driver<DWM3000BoardConfig<Board, Phy>>;
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <Arduino.h>
+
+#ifndef DW3000_IRQ_POLL_US
+#define DW3000_IRQ_POLL_US 5 // without interrupts (host build) wait() checks the line this often, about the ISR to task latency of an ESP32
+#endif
+
+#define DW3000_EVENT_RX_GOOD 0x1    // frame received with a good CRC (RXFCG)
+#define DW3000_EVENT_RX_ERROR 0x2   // PHR, CRC or Reed-Solomon error, SFD timeout or CIA error
+#define DW3000_EVENT_TX_DONE 0x4    // frame sent (TXFRS)
+#define DW3000_EVENT_RX_TIMEOUT 0x8 // frame wait or preamble detection timeout
+#define DW3000_EVENTS_ALL 0xF
+
+/*
+ IRQ line of a DW3000: high while SYS_STATUS holds an event that SYS_ENABLE lets through (DWM3000Driver::enableInterrupts()).
+ On the ESP32 its rising edge wakes the task that called begin() with a FreeRTOS task notification, so the task sleeps in wait()
+ instead of polling SYS_STATUS over SPI, and reads the status once (DWM3000Driver::readEvents()) when there is something to read.
+ All lines of a board notify the same task: a board with more than one chip waits on all of them with waitAny().
+
+    DW3000Irq irq;
+    irq.begin(Board::irqPin);
+    dwm.enableInterrupts(&irq);
+    if (irq.wait(10))                   // sleeps until the chip has news, at most 10 ms
+        events = dwm.readEvents();      // DW3000_EVENT_* bits
+*/
+class DW3000Irq
+{
+public:
+    /*
+     Attaches the ISR to the pin the IRQ line of the chip is wired to
+     @param pin GPIO of the IRQ line
+    */
+    void begin(uint8_t pin)
+    {
+        this->pin = pin;
+        pinMode(pin, INPUT);
+#ifdef ARDUINO_ARCH_ESP32
+        this->task = xTaskGetCurrentTaskHandle();
+        attachInterruptArg(digitalPinToInterrupt(pin), isr, this, RISING);
+#endif
+    }
+
+    /*
+     @return True while the chip holds an event nobody cleared yet, costs no SPI transaction
+    */
+    bool pending()
+    {
+        return digitalRead(this->pin) == HIGH;
+    }
+
+    /*
+     Waits for the line to rise. The host build has no interrupts: it checks the line and lets DW3000_IRQ_POLL_US pass,
+     the caller loops (the simulated nodes only take turns between two loop() calls)
+     @param timeoutMs Longest wait
+     @return True if the line is high
+    */
+    bool wait(uint32_t timeoutMs)
+    {
+        DW3000Irq *self = this;
+        return waitAny(&self, 1, timeoutMs);
+    }
+
+    /*
+     Waits for any of the lines of a board to rise. All of them notify the same task, so an edge of one line ends the wait
+     and none gets lost to a wait() on another line that is still low.
+     @param lines The lines, all begin() in the calling task
+     @param count Number of lines
+     @param timeoutMs Longest wait
+     @return True if one of the lines is high
+    */
+    static bool waitAny(DW3000Irq *const *lines, int count, uint32_t timeoutMs)
+    {
+#ifdef ARDUINO_ARCH_ESP32
+        ulTaskNotifyTake(pdTRUE, 0); // edges of events that were handled already
+        if (anyPending(lines, count))
+        {
+            return true; // the lines are level triggered: no edge comes for an event that is still set
+        }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs));
+#else
+        if (anyPending(lines, count))
+        {
+            return true;
+        }
+        delayMicroseconds(DW3000_IRQ_POLL_US);
+#endif
+        return anyPending(lines, count);
+    }
+
+private:
+    uint8_t pin = 0;
+
+    static bool anyPending(DW3000Irq *const *lines, int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (lines[i]->pending())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+#ifdef ARDUINO_ARCH_ESP32
+    TaskHandle_t task = NULL;
+
+    static void IRAM_ATTR isr(void *arg)
+    {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(((DW3000Irq *)arg)->task, &woken);
+        if (woken)
+        {
+            portYIELD_FROM_ISR();
+        }
+    }
+#endif
+};
+
+/*
+ The events of DWM3000Driver::readEvents() in the terms of DWM3000Driver::receivedFrameSucc()
+ @return 1 if a frame was received; 2 on a receiver error; 3 on a receive timeout; 0 if none of them happened
+*/
+inline int dw3000FrameStatus(uint32_t events)
+{
+    if (events & DW3000_EVENT_RX_GOOD)
+    {
+        return 1;
+    }
+    return events & DW3000_EVENT_RX_ERROR ? 2 : events & DW3000_EVENT_RX_TIMEOUT ? 3 : 0;
+}
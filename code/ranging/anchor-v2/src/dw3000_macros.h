@@ -1,2 +0,0 @@
-#define REGBASE(x) ((x >> 16) & 0xFF)
-#define REGSUB(x) (x & 0xFF)
\ No newline at end of file
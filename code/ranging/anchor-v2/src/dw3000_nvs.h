@@ -0,0 +1,114 @@
+#pragma once
+
+#include <Preferences.h>
+
+#include "dw3000_api.h"
+
+#define DW3000_NVS_NAMESPACE "dw3000"
+
+/*
+ Keeps the OTP calibration of a DW3000 (DW3000Calibration) in NVS, so that init() with DW3000_FAST_BOOT
+ does not read it from the OTP again after a reboot, and a tuned crystal trim next to it. Every radio of a board needs its own key.
+*/
+class DW3000CalibrationStore
+{
+public:
+    /*
+     @param key NVS key of the radio (at most 15 characters)
+    */
+    DW3000CalibrationStore(const char *key) : key(key)
+    {
+    }
+
+    /*
+     Reads the stored calibration
+     @param cal Gets the stored values, or is marked invalid if there are none
+     @return True if a calibration was stored
+    */
+    bool load(DW3000Calibration &cal)
+    {
+        Preferences prefs;
+        bool found = false;
+        if (prefs.begin(DW3000_NVS_NAMESPACE, true))
+        {
+            found = prefs.getBytes(this->key, &cal, sizeof(cal)) == sizeof(cal) && cal.valid;
+            prefs.end();
+        }
+        if (!found)
+        {
+            cal.valid = false;
+        }
+        return found;
+    }
+
+    /*
+     Stores a calibration init() read from the OTP. Nothing gets written if it came from the store anyway, to spare the flash.
+     @param cal The calibration of the radio
+     @param fromCache DWM3000Driver::calibrationFromCache after init()
+    */
+    void store(const DW3000Calibration &cal, bool fromCache)
+    {
+        if (fromCache || !cal.valid)
+        {
+            return;
+        }
+
+        Preferences prefs;
+        if (prefs.begin(DW3000_NVS_NAMESPACE, false))
+        {
+            prefs.putBytes(this->key, &cal, sizeof(cal));
+            prefs.end();
+        }
+    }
+
+    /*
+     Reads a crystal trim DW3000XtalTrimLoop converged to
+     @return The trim, or 0 if none was stored (init() then uses the OTP value)
+    */
+    uint8_t loadXtalTrim()
+    {
+        char name[16];
+        xtalKey(name);
+        uint8_t trim = 0;
+        Preferences prefs;
+        if (prefs.begin(DW3000_NVS_NAMESPACE, true))
+        {
+            if (prefs.getBytes(name, &trim, sizeof(trim)) != sizeof(trim))
+            {
+                trim = 0;
+            }
+            prefs.end();
+        }
+        return trim;
+    }
+
+    /*
+     Stores a converged crystal trim, skips the write if it is already stored
+     @param trim DW3000XtalTrimLoop::trim()
+    */
+    void storeXtalTrim(uint8_t trim)
+    {
+        if (trim == loadXtalTrim())
+        {
+            return;
+        }
+
+        char name[16];
+        xtalKey(name);
+        Preferences prefs;
+        if (prefs.begin(DW3000_NVS_NAMESPACE, false))
+        {
+            prefs.putBytes(name, &trim, sizeof(trim));
+            prefs.end();
+        }
+    }
+
+private:
+    const char *key;
+
+    // the trim goes under "<key>_xt", cut to the 15 characters NVS allows
+    void xtalKey(char *name)
+    {
+        snprintf(name, 16, "%.12s_xt", this->key);
+    }
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+
+#define DW3000_MAX_HEADER_SUB 0x7F // highest sub address a SPI header can carry, bursts starting below it still run past it
+
+/*
+ First header byte for a register access (See DWM3000 User Manual 2.3.1.2 for more)
+ @param base The base register address
+ @param sub The sub register address. 0 uses the short 1 byte header, anything else the 2 byte full address header.
+ The full address header only has 7 bits for it, offsets above DW3000_MAX_HEADER_SUB go through an indirect pointer.
+ @param write True for a write, False for a read
+*/
+constexpr uint8_t dw3000HeaderByte0(uint8_t base, uint16_t sub, bool write)
+{
+    return (write ? 0x80 : 0x00) | ((base & 0x1F) << 1) | (sub == 0 ? 0x00 : 0x40 | ((sub >> 6) & 0x01));
+}
+
+/*
+ Second header byte for a full address register access, only sent if sub is not 0
+*/
+constexpr uint8_t dw3000HeaderByte1(uint16_t sub)
+{
+    return (sub & 0x3F) << 2;
+}
+
+/*
+ Compile time description of a DW3000 register: address, exact width in bytes and the precomputed SPI headers.
+ The descriptors of all registers are generated into dw3000_regs.h (namespace regs) by generate_register_descriptors.sh.
+*/
+struct DW3000Register
+{
+    uint8_t base;
+    uint16_t sub; // can be past DW3000_MAX_HEADER_SUB for slices of the buffers, the headers are then unusable (see indirect())
+    uint16_t len;
+    uint8_t headerLen;
+    uint8_t readHeader[2];
+    uint8_t writeHeader[2];
+
+    constexpr DW3000Register(uint8_t base, uint16_t sub, uint16_t len)
+        : base(base), sub(sub), len(len), headerLen(sub == 0 ? 1 : 2),
+          readHeader{dw3000HeaderByte0(base, sub, false), dw3000HeaderByte1(sub)},
+          writeHeader{dw3000HeaderByte0(base, sub, true), dw3000HeaderByte1(sub)}
+    {
+    }
+
+    /*
+     Part of this register, for accesses that should only touch some of its bytes
+     @param offset The first byte, relative to the register
+     @param len The number of bytes
+    */
+    constexpr DW3000Register slice(uint16_t offset, uint16_t len) const
+    {
+        return DW3000Register(base, sub + offset, len);
+    }
+
+    /*
+     @return True if the sub address does not fit into the SPI header, the driver then accesses the register through indirect pointer A
+    */
+    constexpr bool indirect() const
+    {
+        return sub > DW3000_MAX_HEADER_SUB;
+    }
+};
+
+/*
+ A field inside a register: the bits of mask, shifted by shift
+*/
+struct DW3000Field
+{
+    DW3000Register reg;
+    uint32_t mask;
+    uint8_t shift;
+
+    constexpr DW3000Field(DW3000Register reg, uint32_t mask, uint8_t shift) : reg(reg), mask(mask), shift(shift)
+    {
+    }
+};
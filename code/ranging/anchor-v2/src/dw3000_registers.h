@@ -18,6 +18,16 @@ extern "C"
 #define DRX_CAR_INT_ID          0x060029UL
 #define IP_TS_ID                0x0C0000UL
 #define TX_TIME_HI_ID           0x000078UL
+#define RX_BUFFER_0_ID          0x120000UL
+#define RX_BUFFER_1_ID          0x130000UL
+#define TX_BUFFER_ID            0x140000UL
+#define ACC_MEM_ID              0x150000UL
+#define INDIRECT_PTR_A_ID       0x1D0000UL
+#define INDIRECT_PTR_B_ID       0x1E0000UL
+#define BUF0_RX_FINFO_ID        0x180000UL
+#define BUF0_IP_TS_ID           0x180020UL
+#define BUF1_RX_FINFO_ID        0x1800E8UL
+#define BUF1_IP_TS_ID           0x180108UL
 
 //
 
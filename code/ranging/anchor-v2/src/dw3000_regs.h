@@ -0,0 +1,768 @@
+// generated by generate_register_descriptors.sh from dw3000_registers.h, do not edit
+
+#pragma once
+
+#include "dw3000_register.h"
+
+namespace regs
+{
+    constexpr DW3000Register RF_TX_CTRL(0x07, 0x1A, 1);
+    constexpr DW3000Register RF_TX_CTRL_2(0x07, 0x1C, 4);
+    constexpr DW3000Register PRE_TOC(0x06, 0x04, 2);
+    constexpr DW3000Register RX_SFD_TOC(0x06, 0x02, 2);
+    constexpr DW3000Register AON_CFG(0x0A, 0x14, 1);
+    constexpr DW3000Register DRX_CAR_INT(0x06, 0x29, 3);
+    constexpr DW3000Register IP_TS(0x0C, 0x00, 5);
+    constexpr DW3000Register TX_TIME_HI(0x00, 0x78, 1);
+    constexpr DW3000Register RX_BUFFER_0(0x12, 0x00, 1024);
+    constexpr DW3000Register RX_BUFFER_1(0x13, 0x00, 1024);
+    constexpr DW3000Register TX_BUFFER(0x14, 0x00, 1024);
+    constexpr DW3000Register ACC_MEM(0x15, 0x00, 6096);
+    constexpr DW3000Register INDIRECT_PTR_A(0x1D, 0x00, 4);
+    constexpr DW3000Register INDIRECT_PTR_B(0x1E, 0x00, 4);
+    constexpr DW3000Register BUF0_RX_FINFO(0x18, 0x00, 4);
+    constexpr DW3000Register BUF0_IP_TS(0x18, 0x20, 5);
+    constexpr DW3000Register BUF1_RX_FINFO(0x18, 0xE8, 4);
+    constexpr DW3000Register BUF1_IP_TS(0x18, 0x108, 5);
+    constexpr DW3000Register DEV_ID(0x00, 0x00, 4);
+    constexpr DW3000Register EUI_64_LO(0x00, 0x04, 4);
+    constexpr DW3000Register EUI_64_HI(0x00, 0x08, 4);
+    constexpr DW3000Register PANADR(0x00, 0x0C, 4);
+    constexpr DW3000Register SYS_CFG(0x00, 0x10, 4);
+    constexpr DW3000Register ADR_FILT_CFG(0x00, 0x14, 4);
+    constexpr DW3000Register SPICRC_CFG(0x00, 0x18, 4);
+    constexpr DW3000Register SYS_TIME(0x00, 0x1C, 4);
+    constexpr DW3000Register TX_FCTRL(0x00, 0x24, 4);
+    constexpr DW3000Register TX_FCTRL_HI(0x00, 0x28, 4);
+    constexpr DW3000Register DX_TIME(0x00, 0x2C, 4);
+    constexpr DW3000Register DREF_TIME(0x00, 0x30, 4);
+    constexpr DW3000Register RX_FWTO(0x00, 0x34, 4);
+    constexpr DW3000Register SYS_ENABLE_LO(0x00, 0x3C, 4);
+    constexpr DW3000Register SYS_ENABLE_HI(0x00, 0x40, 4);
+    constexpr DW3000Register SYS_STATUS(0x00, 0x44, 4);
+    constexpr DW3000Register SYS_STATUS_HI(0x00, 0x48, 4);
+    constexpr DW3000Register RX_FINFO(0x00, 0x4C, 4);
+    constexpr DW3000Register RX_TIME_0(0x00, 0x64, 4);
+    constexpr DW3000Register RX_TIME_RAW(0x00, 0x70, 4);
+    constexpr DW3000Register TX_TIME_LO(0x00, 0x74, 4);
+    constexpr DW3000Register TX_TIME_RAW(0x01, 0x00, 4);
+    constexpr DW3000Register TX_ANTD(0x01, 0x04, 2);
+    constexpr DW3000Register ACK_RESP(0x01, 0x08, 4);
+    constexpr DW3000Register TX_POWER(0x01, 0x0C, 4);
+    constexpr DW3000Register CHAN_CTRL(0x01, 0x14, 4);
+    constexpr DW3000Register LE_PEND_01(0x01, 0x18, 4);
+    constexpr DW3000Register LE_PEND_23(0x01, 0x1C, 4);
+    constexpr DW3000Register RDB_STATUS(0x01, 0x24, 4);
+    constexpr DW3000Register RDB_DIAG_MODE(0x01, 0x28, 4);
+    constexpr DW3000Register AES_CFG(0x01, 0x30, 4);
+    constexpr DW3000Register AES_IV0(0x01, 0x34, 4);
+    constexpr DW3000Register AES_IV1(0x01, 0x38, 4);
+    constexpr DW3000Register AES_IV2(0x01, 0x3C, 4);
+    constexpr DW3000Register AES_IV3(0x01, 0x40, 4);
+    constexpr DW3000Register DMA_CFG0(0x01, 0x44, 4);
+    constexpr DW3000Register DMA_CFG1(0x01, 0x48, 4);
+    constexpr DW3000Register AES_START(0x01, 0x4C, 4);
+    constexpr DW3000Register AES_STS(0x01, 0x50, 4);
+    constexpr DW3000Register AES_KEY0(0x01, 0x54, 4);
+    constexpr DW3000Register AES_KEY1(0x01, 0x58, 4);
+    constexpr DW3000Register AES_KEY2(0x01, 0x5C, 4);
+    constexpr DW3000Register AES_KEY3(0x01, 0x60, 4);
+    constexpr DW3000Register STS_CFG0(0x02, 0x00, 4);
+    constexpr DW3000Register STS_CTRL(0x02, 0x04, 4);
+    constexpr DW3000Register STS_STS(0x02, 0x08, 4);
+    constexpr DW3000Register STS_KEY0(0x02, 0x0C, 4);
+    constexpr DW3000Register STS_KEY1(0x02, 0x10, 4);
+    constexpr DW3000Register STS_KEY2(0x02, 0x14, 4);
+    constexpr DW3000Register STS_KEY3(0x02, 0x18, 4);
+    constexpr DW3000Register STS_IV0(0x02, 0x1C, 4);
+    constexpr DW3000Register STS_IV1(0x02, 0x20, 4);
+    constexpr DW3000Register STS_IV2(0x02, 0x24, 4);
+    constexpr DW3000Register STS_IV3(0x02, 0x28, 4);
+    constexpr DW3000Register LCSS_MARGIN(0x02, 0x34, 4);
+    constexpr DW3000Register MRX_CFG(0x03, 0x00, 4);
+    constexpr DW3000Register ADC_THRESH_CFG(0x03, 0x10, 4);
+    constexpr DW3000Register AGC_CFG(0x03, 0x14, 4);
+    constexpr DW3000Register DGC_CFG(0x03, 0x18, 4);
+    constexpr DW3000Register DGC_CFG0(0x03, 0x1C, 4);
+    constexpr DW3000Register DGC_CFG1(0x03, 0x20, 4);
+    constexpr DW3000Register DGC_CFG2(0x03, 0x24, 4);
+    constexpr DW3000Register DGC_LUT_0_CFG(0x03, 0x38, 4);
+    constexpr DW3000Register DGC_LUT_1_CFG(0x03, 0x3C, 4);
+    constexpr DW3000Register DGC_LUT_2_CFG(0x03, 0x40, 4);
+    constexpr DW3000Register DGC_LUT_3_CFG(0x03, 0x44, 4);
+    constexpr DW3000Register DGC_LUT_4_CFG(0x03, 0x48, 4);
+    constexpr DW3000Register DGC_LUT_5_CFG(0x03, 0x4C, 4);
+    constexpr DW3000Register DGC_LUT_6_CFG(0x03, 0x50, 4);
+    constexpr DW3000Register ADC_THRESH_DBG(0x03, 0x58, 4);
+    constexpr DW3000Register DGC_DBG(0x03, 0x60, 4);
+    constexpr DW3000Register EC_CTRL(0x04, 0x00, 4);
+    constexpr DW3000Register RX_CAL_CFG(0x04, 0x0C, 4);
+    constexpr DW3000Register RX_CAL_RESI(0x04, 0x14, 4);
+    constexpr DW3000Register RX_CAL_RESQ(0x04, 0x1C, 4);
+    constexpr DW3000Register RX_CAL_STS(0x04, 0x20, 4);
+    constexpr DW3000Register GPIO_MODE(0x05, 0x00, 4);
+    constexpr DW3000Register GPIO_DIR(0x05, 0x08, 4);
+    constexpr DW3000Register GPIO_OUT(0x05, 0x0C, 4);
+    constexpr DW3000Register GPIO_IRQE(0x05, 0x10, 4);
+    constexpr DW3000Register GPIO_ISTS(0x05, 0x14, 4);
+    constexpr DW3000Register GPIO_ISEN(0x05, 0x18, 4);
+    constexpr DW3000Register GPIO_IMODE(0x05, 0x1C, 4);
+    constexpr DW3000Register GPIO_IBES(0x05, 0x20, 4);
+    constexpr DW3000Register GPIO_ICLR(0x05, 0x24, 4);
+    constexpr DW3000Register GPIO_IDBE(0x05, 0x28, 4);
+    constexpr DW3000Register GPIO_RAW(0x05, 0x2C, 4);
+    constexpr DW3000Register DTUNE0(0x06, 0x00, 2);
+    constexpr DW3000Register DTUNE1(0x06, 0x04, 4);
+    constexpr DW3000Register DTUNE3(0x06, 0x0C, 4);
+    constexpr DW3000Register DTUNE4(0x06, 0x10, 4);
+    constexpr DW3000Register DTUNE5(0x06, 0x14, 4);
+    constexpr DW3000Register DRX_DIAG3(0x06, 0x29, 3);
+    constexpr DW3000Register RF_ENABLE(0x07, 0x00, 4);
+    constexpr DW3000Register RF_CTRL_MASK(0x07, 0x04, 4);
+    constexpr DW3000Register RX_CTRL_HI(0x07, 0x10, 4);
+    constexpr DW3000Register RF_SWITCH_CTRL(0x07, 0x14, 4);
+    constexpr DW3000Register TX_CTRL_LO(0x07, 0x18, 2);
+    constexpr DW3000Register TX_CTRL_HI(0x07, 0x1C, 4);
+    constexpr DW3000Register TX_TEST(0x07, 0x28, 4);
+    constexpr DW3000Register SAR_TEST(0x07, 0x34, 1);
+    constexpr DW3000Register PG_TST_DATA(0x07, 0x38, 4);
+    constexpr DW3000Register RF_STATUS(0x07, 0x3C, 4);
+    constexpr DW3000Register LDO_TUNE_LO(0x07, 0x40, 4);
+    constexpr DW3000Register LDO_TUNE_HI(0x07, 0x44, 4);
+    constexpr DW3000Register LDO_CTRL(0x07, 0x48, 4);
+    constexpr DW3000Register LDO_RLOAD(0x07, 0x50, 4);
+    constexpr DW3000Register SAR_CTRL(0x08, 0x00, 1);
+    constexpr DW3000Register SAR_STATUS(0x08, 0x04, 1);
+    constexpr DW3000Register SAR_READING(0x08, 0x08, 4);
+    constexpr DW3000Register SAR_WAKE_RD(0x08, 0x0C, 4);
+    constexpr DW3000Register PGC_CTRL(0x08, 0x10, 4);
+    constexpr DW3000Register PGC_STATUS(0x08, 0x14, 4);
+    constexpr DW3000Register PG_TEST(0x08, 0x18, 4);
+    constexpr DW3000Register PG_CAL_TARGET(0x08, 0x1C, 4);
+    constexpr DW3000Register PLL_CFG(0x09, 0x00, 2);
+    constexpr DW3000Register PLL_COARSE_CODE(0x09, 0x04, 4);
+    constexpr DW3000Register PLL_CAL(0x09, 0x08, 4);
+    constexpr DW3000Register PLL_COMMON(0x09, 0x10, 2);
+    constexpr DW3000Register PLL_STATUS(0x09, 0x0C, 4);
+    constexpr DW3000Register XTAL(0x09, 0x14, 4);
+    constexpr DW3000Register AON_DIG_CFG(0x0A, 0x00, 3);
+    constexpr DW3000Register AON_CTRL(0x0A, 0x04, 1);
+    constexpr DW3000Register AON_RDATA(0x0A, 0x08, 4);
+    constexpr DW3000Register AON_ADDR(0x0A, 0x0C, 4);
+    constexpr DW3000Register AON_WDATA(0x0A, 0x10, 4);
+    constexpr DW3000Register ANA_CFG(0x0A, 0x14, 4);
+    constexpr DW3000Register OTP_WDATA(0x0B, 0x00, 4);
+    constexpr DW3000Register OTP_ADDR(0x0B, 0x04, 2);
+    constexpr DW3000Register OTP_CFG(0x0B, 0x08, 2);
+    constexpr DW3000Register OTP_STATUS(0x0B, 0x0C, 4);
+    constexpr DW3000Register OTP_RDATA(0x0B, 0x10, 4);
+    constexpr DW3000Register IP_TOA_LO(0x0C, 0x00, 4);
+    constexpr DW3000Register IP_TOA_HI(0x0C, 0x04, 4);
+    constexpr DW3000Register STS_TOA_LO(0x0C, 0x08, 4);
+    constexpr DW3000Register STS_TOA_HI(0x0C, 0x0C, 4);
+    constexpr DW3000Register STS1_TOA_LO(0x0C, 0x10, 4);
+    constexpr DW3000Register STS1_TOA_HI(0x0C, 0x14, 4);
+    constexpr DW3000Register CIA_TDOA_0(0x0C, 0x18, 4);
+    constexpr DW3000Register CIA_TDOA_1_PDOA(0x0C, 0x1C, 4);
+    constexpr DW3000Register CIA_DIAG_0(0x0C, 0x20, 4);
+    constexpr DW3000Register CIA_DIAG_1(0x0C, 0x24, 4);
+    constexpr DW3000Register IP_DIAG_0(0x0C, 0x28, 4);
+    constexpr DW3000Register IP_DIAG_1(0x0C, 0x2C, 4);
+    constexpr DW3000Register IP_DIAG_2(0x0C, 0x30, 4);
+    constexpr DW3000Register IP_DIAG_3(0x0C, 0x34, 4);
+    constexpr DW3000Register IP_DIAG_4(0x0C, 0x38, 4);
+    constexpr DW3000Register IP_DIAG_5(0x0C, 0x3C, 4);
+    constexpr DW3000Register IP_DIAG_6(0x0C, 0x40, 4);
+    constexpr DW3000Register IP_DIAG_7(0x0C, 0x44, 4);
+    constexpr DW3000Register IP_DIAG_8(0x0C, 0x48, 4);
+    constexpr DW3000Register IP_DIAG_9(0x0C, 0x4C, 4);
+    constexpr DW3000Register IP_DIAG_10(0x0C, 0x50, 4);
+    constexpr DW3000Register IP_DIAG_11(0x0C, 0x54, 4);
+    constexpr DW3000Register IP_DIAG_12(0x0C, 0x58, 4);
+    constexpr DW3000Register STS_DIAG_0(0x0C, 0x5C, 4);
+    constexpr DW3000Register STS_DIAG_1(0x0C, 0x60, 4);
+    constexpr DW3000Register STS_DIAG_2(0x0C, 0x64, 4);
+    constexpr DW3000Register STS_DIAG_3(0x0C, 0x68, 4);
+    constexpr DW3000Register STS_DIAG_4(0x0D, 0x00, 4);
+    constexpr DW3000Register STS_DIAG_5(0x0D, 0x04, 4);
+    constexpr DW3000Register STS_DIAG_6(0x0D, 0x08, 4);
+    constexpr DW3000Register STS_DIAG_7(0x0D, 0x0C, 4);
+    constexpr DW3000Register STS_DIAG_8(0x0D, 0x10, 4);
+    constexpr DW3000Register STS_DIAG_9(0x0D, 0x14, 4);
+    constexpr DW3000Register STS_DIAG_10(0x0D, 0x18, 4);
+    constexpr DW3000Register STS_DIAG_11(0x0D, 0x1C, 4);
+    constexpr DW3000Register STS_DIAG_12(0x0D, 0x20, 4);
+    constexpr DW3000Register STS_DIAG_13(0x0D, 0x24, 4);
+    constexpr DW3000Register STS_DIAG_14(0x0D, 0x28, 4);
+    constexpr DW3000Register STS_DIAG_15(0x0D, 0x2C, 4);
+    constexpr DW3000Register STS_DIAG_16(0x0D, 0x30, 4);
+    constexpr DW3000Register STS_DIAG_17(0x0D, 0x34, 4);
+    constexpr DW3000Register STS1_DIAG_0(0x0D, 0x38, 4);
+    constexpr DW3000Register STS1_DIAG_1(0x0D, 0x3C, 4);
+    constexpr DW3000Register STS1_DIAG_2(0x0D, 0x40, 4);
+    constexpr DW3000Register STS1_DIAG_3(0x0D, 0x44, 4);
+    constexpr DW3000Register STS1_DIAG_4(0x0D, 0x48, 4);
+    constexpr DW3000Register STS1_DIAG_5(0x0D, 0x4C, 4);
+    constexpr DW3000Register STS1_DIAG_6(0x0D, 0x50, 4);
+    constexpr DW3000Register STS1_DIAG_7(0x0D, 0x54, 4);
+    constexpr DW3000Register STS1_DIAG_8(0x0D, 0x58, 4);
+    constexpr DW3000Register STS1_DIAG_9(0x0D, 0x5C, 4);
+    constexpr DW3000Register STS1_DIAG_10(0x0D, 0x60, 4);
+    constexpr DW3000Register STS1_DIAG_11(0x0D, 0x64, 4);
+    constexpr DW3000Register STS1_DIAG_12(0x0D, 0x68, 4);
+    constexpr DW3000Register CIA_CONF(0x0E, 0x00, 4);
+    constexpr DW3000Register FP_CONF(0x0E, 0x04, 4);
+    constexpr DW3000Register IP_CONFIG_LO(0x0E, 0x0C, 2);
+    constexpr DW3000Register IP_CONFIG_HI(0x0E, 0x0E, 4);
+    constexpr DW3000Register STS_CONFIG_LO(0x0E, 0x12, 4);
+    constexpr DW3000Register STS_CONFIG_HI(0x0E, 0x16, 4);
+    constexpr DW3000Register CIA_ADJUST(0x0E, 0x1A, 4);
+    constexpr DW3000Register PGF_DELAY_COMP_LO(0x0E, 0x1E, 4);
+    constexpr DW3000Register PGF_DELAY_COMP_HI(0x0E, 0x22, 4);
+    constexpr DW3000Register EVC_CTRL(0x0F, 0x00, 4);
+    constexpr DW3000Register EVC_COUNT0(0x0F, 0x04, 4);
+    constexpr DW3000Register EVC_COUNT1(0x0F, 0x08, 4);
+    constexpr DW3000Register EVC_COUNT2(0x0F, 0x0C, 4);
+    constexpr DW3000Register EVC_COUNT3(0x0F, 0x10, 4);
+    constexpr DW3000Register EVC_COUNT4(0x0F, 0x14, 4);
+    constexpr DW3000Register EVC_COUNT5(0x0F, 0x18, 4);
+    constexpr DW3000Register EVC_COUNT6(0x0F, 0x1C, 4);
+    constexpr DW3000Register TEST_CTRL0(0x0F, 0x24, 4);
+    constexpr DW3000Register EVC_COUNT7(0x0F, 0x28, 4);
+    constexpr DW3000Register SPI_MODE(0x0F, 0x2C, 4);
+    constexpr DW3000Register SYS_STATE_LO(0x0F, 0x30, 4);
+    constexpr DW3000Register FCMD_STATUS(0x0F, 0x3C, 4);
+    constexpr DW3000Register CTR_DBG(0x0F, 0x48, 4);
+    constexpr DW3000Register SOFT_RST(0x11, 0x00, 2);
+    constexpr DW3000Register CLK_CTRL(0x11, 0x04, 4);
+    constexpr DW3000Register SEQ_CTRL(0x11, 0x08, 4);
+    constexpr DW3000Register PWR_UP_TIMES_TXFINESEQ(0x11, 0x10, 4);
+    constexpr DW3000Register LED_CTRL(0x11, 0x16, 4);
+    constexpr DW3000Register RX_SNIFF(0x11, 0x1A, 4);
+    constexpr DW3000Register BIAS_CTRL(0x11, 0x1F, 2);
+    constexpr DW3000Register FINT_STAT(0x1F, 0x00, 4);
+    constexpr DW3000Register INDIRECT_ADDR_A(0x1F, 0x04, 4);
+    constexpr DW3000Register ADDR_OFFSET_A(0x1F, 0x08, 4);
+    constexpr DW3000Register INDIRECT_ADDR_B(0x1F, 0x0C, 4);
+    constexpr DW3000Register ADDR_OFFSET_B(0x1F, 0x10, 4);
+
+    // fields
+    constexpr DW3000Field ACK_RESP_W4R_TIM(ACK_RESP, 0xFFFFFUL, 0);
+    constexpr DW3000Field ADR_FILT_CFG_FFAA(ADR_FILT_CFG, 0x4UL, 2);
+    constexpr DW3000Field ADR_FILT_CFG_FFAB(ADR_FILT_CFG, 0x1UL, 0);
+    constexpr DW3000Field ADR_FILT_CFG_FFAD(ADR_FILT_CFG, 0x2UL, 1);
+    constexpr DW3000Field ADR_FILT_CFG_FFAE(ADR_FILT_CFG, 0x80UL, 7);
+    constexpr DW3000Field ADR_FILT_CFG_FFAF(ADR_FILT_CFG, 0x40UL, 6);
+    constexpr DW3000Field ADR_FILT_CFG_FFAM(ADR_FILT_CFG, 0x8UL, 3);
+    constexpr DW3000Field ADR_FILT_CFG_FFAMULTI(ADR_FILT_CFG, 0x20UL, 5);
+    constexpr DW3000Field ADR_FILT_CFG_FFAR(ADR_FILT_CFG, 0x10UL, 4);
+    constexpr DW3000Field ADR_FILT_CFG_FFBC(ADR_FILT_CFG, 0x100UL, 8);
+    constexpr DW3000Field ADR_FILT_CFG_FFIB(ADR_FILT_CFG, 0x200UL, 9);
+    constexpr DW3000Field ADR_FILT_CFG_LE0_PEND(ADR_FILT_CFG, 0x400UL, 10);
+    constexpr DW3000Field ADR_FILT_CFG_LE1_PEND(ADR_FILT_CFG, 0x800UL, 11);
+    constexpr DW3000Field ADR_FILT_CFG_LE2_PEND(ADR_FILT_CFG, 0x1000UL, 12);
+    constexpr DW3000Field ADR_FILT_CFG_LE3_PEND(ADR_FILT_CFG, 0x2000UL, 13);
+    constexpr DW3000Field ADR_FILT_CFG_LSADRAPE(ADR_FILT_CFG, 0x8000UL, 15);
+    constexpr DW3000Field ADR_FILT_CFG_SSADRAPE(ADR_FILT_CFG, 0x4000UL, 14);
+    constexpr DW3000Field AES_CFG_CORE_SEL(AES_CFG, 0x800UL, 11);
+    constexpr DW3000Field AES_CFG_KEY_ADDR(AES_CFG, 0x38UL, 3);
+    constexpr DW3000Field AES_CFG_KEY_LOAD(AES_CFG, 0x40UL, 6);
+    constexpr DW3000Field AES_CFG_KEY_OTP(AES_CFG, 0x1000UL, 12);
+    constexpr DW3000Field AES_CFG_KEY_SIZE(AES_CFG, 0x6UL, 1);
+    constexpr DW3000Field AES_CFG_KEY_SRC(AES_CFG, 0x80UL, 7);
+    constexpr DW3000Field AES_CFG_MODE(AES_CFG, 0x1UL, 0);
+    constexpr DW3000Field AES_CFG_TAG_SIZE(AES_CFG, 0x700UL, 8);
+    constexpr DW3000Field AES_START_AES_START(AES_START, 0x1UL, 0);
+    constexpr DW3000Field AES_STS_AES_DONE(AES_STS, 0x1UL, 0);
+    constexpr DW3000Field AES_STS_AUTH_ERR(AES_STS, 0x2UL, 1);
+    constexpr DW3000Field AES_STS_MEM_CONF(AES_STS, 0x8UL, 3);
+    constexpr DW3000Field AES_STS_RAM_EMPTY(AES_STS, 0x10UL, 4);
+    constexpr DW3000Field AES_STS_RAM_FULL(AES_STS, 0x20UL, 5);
+    constexpr DW3000Field AES_STS_TRANS_ERR(AES_STS, 0x4UL, 2);
+    constexpr DW3000Field ANA_CFG_BROUT_EN(ANA_CFG, 0x4UL, 2);
+    constexpr DW3000Field ANA_CFG_PRES_SLEEP(ANA_CFG, 0x20UL, 5);
+    constexpr DW3000Field ANA_CFG_SLEEP_EN(ANA_CFG, 0x1UL, 0);
+    constexpr DW3000Field ANA_CFG_WAKE_CNT(ANA_CFG, 0x2UL, 1);
+    constexpr DW3000Field ANA_CFG_WAKE_CSN(ANA_CFG, 0x8UL, 3);
+    constexpr DW3000Field ANA_CFG_WAKE_WUP(ANA_CFG, 0x10UL, 4);
+    constexpr DW3000Field AON_ADDR_ADDR(AON_ADDR, 0x1FFUL, 0);
+    constexpr DW3000Field AON_CTRL_ARRAY_RESTORE(AON_CTRL, 0x1UL, 0);
+    constexpr DW3000Field AON_CTRL_ARRAY_SAVE(AON_CTRL, 0x2UL, 1);
+    constexpr DW3000Field AON_CTRL_CONFIG_UPLOAD(AON_CTRL, 0x4UL, 2);
+    constexpr DW3000Field AON_CTRL_DCA_ENAB(AON_CTRL, 0x80UL, 7);
+    constexpr DW3000Field AON_CTRL_DCA_READ_EN(AON_CTRL, 0x8UL, 3);
+    constexpr DW3000Field AON_CTRL_DCA_WRITE_EN(AON_CTRL, 0x10UL, 4);
+    constexpr DW3000Field AON_CTRL_DCA_WRITE_HI_EN(AON_CTRL, 0x20UL, 5);
+    constexpr DW3000Field AON_DIG_CFG_ONWAKE_AON_DLD(AON_DIG_CFG, 0x1UL, 0);
+    constexpr DW3000Field AON_DIG_CFG_ONWAKE_GO2IDLE(AON_DIG_CFG, 0x100UL, 8);
+    constexpr DW3000Field AON_DIG_CFG_ONWAKE_GO2RX(AON_DIG_CFG, 0x200UL, 9);
+    constexpr DW3000Field AON_DIG_CFG_ONWAKE_RUN_SAR(AON_DIG_CFG, 0x2UL, 1);
+    constexpr DW3000Field AON_RDATA_RDATA(AON_RDATA, 0xFFUL, 0);
+    constexpr DW3000Field AON_WDATA_WDATA(AON_WDATA, 0xFFUL, 0);
+    constexpr DW3000Field BIAS_CTRL_BIAS(BIAS_CTRL, 0x1FUL, 0);
+    constexpr DW3000Field CHAN_CTRL_RF_CHAN(CHAN_CTRL, 0x1UL, 0);
+    constexpr DW3000Field CHAN_CTRL_RX_PCODE(CHAN_CTRL, 0x1F00UL, 8);
+    constexpr DW3000Field CHAN_CTRL_SFD_TYPE(CHAN_CTRL, 0x6UL, 1);
+    constexpr DW3000Field CHAN_CTRL_TX_PCODE(CHAN_CTRL, 0xF8UL, 3);
+    constexpr DW3000Field CIA_ADJUST_PDOA_ADJ_OFFSET(CIA_ADJUST, 0x3FFFUL, 0);
+    constexpr DW3000Field CIA_CONF_MINDIAG(CIA_CONF, 0x100000UL, 20);
+    constexpr DW3000Field CIA_CONF_RXANTD(CIA_CONF, 0xFFFFUL, 0);
+    constexpr DW3000Field CIA_DIAG_0_COE_PPM(CIA_DIAG_0, 0x1FFFUL, 0);
+    constexpr DW3000Field CIA_TDOA_0_TDOA(CIA_TDOA_0, 0xFFFFFFFFUL, 0);
+    constexpr DW3000Field CIA_TDOA_1_PDOA_FP_TH_MD(CIA_TDOA_1_PDOA, 0x40000000UL, 30);
+    constexpr DW3000Field CIA_TDOA_1_PDOA_PDOA(CIA_TDOA_1_PDOA, 0x3FFF0000UL, 16);
+    constexpr DW3000Field CIA_TDOA_1_PDOA_TDOA(CIA_TDOA_1_PDOA, 0x1FFUL, 0);
+    constexpr DW3000Field CLK_CTRL_ACC_CLK_EN(CLK_CTRL, 0x40UL, 6);
+    constexpr DW3000Field CLK_CTRL_ACC_MCLK_EN(CLK_CTRL, 0x8000UL, 15);
+    constexpr DW3000Field CLK_CTRL_CIA_CLK_EN(CLK_CTRL, 0x100UL, 8);
+    constexpr DW3000Field CLK_CTRL_GPIO_CLK_EN(CLK_CTRL, 0x10000UL, 16);
+    constexpr DW3000Field CLK_CTRL_GPIO_DCLK_EN(CLK_CTRL, 0x40000UL, 18);
+    constexpr DW3000Field CLK_CTRL_GPIO_DRST_N(CLK_CTRL, 0x80000UL, 19);
+    constexpr DW3000Field CLK_CTRL_LP_CLK_EN(CLK_CTRL, 0x800000UL, 23);
+    constexpr DW3000Field CLK_CTRL_OTP_CLK_EN(CLK_CTRL, 0x200UL, 9);
+    constexpr DW3000Field CLK_CTRL_RX_BUF_CLK_ON(CLK_CTRL, 0x800UL, 11);
+    constexpr DW3000Field CLK_CTRL_RX_CLK_SEL(CLK_CTRL, 0xCUL, 2);
+    constexpr DW3000Field CLK_CTRL_SAR_CLK_EN(CLK_CTRL, 0x400UL, 10);
+    constexpr DW3000Field CLK_CTRL_SYS_CLK_SEL(CLK_CTRL, 0x3UL, 0);
+    constexpr DW3000Field CLK_CTRL_TX_BUF_CLK_ON(CLK_CTRL, 0x1000UL, 12);
+    constexpr DW3000Field CLK_CTRL_TX_CLK_SEL(CLK_CTRL, 0x30UL, 4);
+    constexpr DW3000Field CTR_DBG_CTR_DBG(CTR_DBG, 0xFFFFFFFFUL, 0);
+    constexpr DW3000Field DEV_ID_MODEL(DEV_ID, 0xFF00UL, 8);
+    constexpr DW3000Field DEV_ID_REV(DEV_ID, 0xFUL, 0);
+    constexpr DW3000Field DEV_ID_RIDTAG(DEV_ID, 0xFFFF0000UL, 16);
+    constexpr DW3000Field DEV_ID_VER(DEV_ID, 0xF0UL, 4);
+    constexpr DW3000Field DGC_CFG_RX_TUNE_EN(DGC_CFG, 0x1UL, 0);
+    constexpr DW3000Field DGC_CFG_THR_64(DGC_CFG, 0x7E00UL, 9);
+    constexpr DW3000Field DGC_DBG_DGC_DECISION(DGC_DBG, 0x70000000UL, 28);
+    constexpr DW3000Field DMA_CFG0_CP_END_SEL(DMA_CFG0, 0x4000000UL, 26);
+    constexpr DW3000Field DMA_CFG0_DST_ADDR(DMA_CFG0, 0x3FF0000UL, 16);
+    constexpr DW3000Field DMA_CFG0_DST_PORT(DMA_CFG0, 0xE000UL, 13);
+    constexpr DW3000Field DMA_CFG0_SRC_ADDR(DMA_CFG0, 0x1FF8UL, 3);
+    constexpr DW3000Field DMA_CFG0_SRC_PORT(DMA_CFG0, 0x7UL, 0);
+    constexpr DW3000Field DMA_CFG1_HDR_SIZE(DMA_CFG1, 0x7FUL, 0);
+    constexpr DW3000Field DMA_CFG1_PYLD_SIZE(DMA_CFG1, 0x1FF80UL, 7);
+    constexpr DW3000Field DREF_TIME_DREF(DREF_TIME, 0xFFFFFFFEUL, 1);
+    constexpr DW3000Field DRX_DIAG3_CAR_INT(DRX_DIAG3, 0x1FFFFFUL, 0);
+    constexpr DW3000Field DTUNE0_DT0B4(DTUNE0, 0x10UL, 4);
+    constexpr DW3000Field DTUNE0_PRE_PAC_SYM(DTUNE0, 0x3UL, 0);
+    constexpr DW3000Field DTUNE1_PRE_TOC(DTUNE1, 0xFFFFUL, 0);
+    constexpr DW3000Field DTUNE4_RX_SFD_HLDOFF(DTUNE4, 0xFF000000UL, 24);
+    constexpr DW3000Field DX_TIME_DX_TIME(DX_TIME, 0xFFFFFFFEUL, 1);
+    constexpr DW3000Field EC_CTRL_OSTR_MODE(EC_CTRL, 0x800UL, 11);
+    constexpr DW3000Field EC_CTRL_OSTS_WAIT(EC_CTRL, 0x7F8UL, 3);
+    constexpr DW3000Field EUI_64_HI_EUI_64(EUI_64_HI, 0xFFFFFFFFUL, 0);
+    constexpr DW3000Field EUI_64_LO_EUI_64(EUI_64_LO, 0xFFFFFFFFUL, 0);
+    constexpr DW3000Field EVC_COUNT0_EVC_PHE(EVC_COUNT0, 0xFFFUL, 0);
+    constexpr DW3000Field EVC_COUNT0_EVC_RSE(EVC_COUNT0, 0xFFF0000UL, 16);
+    constexpr DW3000Field EVC_COUNT1_EVC_FCE(EVC_COUNT1, 0xFFF0000UL, 16);
+    constexpr DW3000Field EVC_COUNT1_EVC_FCG(EVC_COUNT1, 0xFFFUL, 0);
+    constexpr DW3000Field EVC_COUNT2_EVC_FFR(EVC_COUNT2, 0xFFUL, 0);
+    constexpr DW3000Field EVC_COUNT2_EVC_OVR(EVC_COUNT2, 0xFF0000UL, 16);
+    constexpr DW3000Field EVC_COUNT3_EVC_PTO(EVC_COUNT3, 0xFFF0000UL, 16);
+    constexpr DW3000Field EVC_COUNT3_EVC_STO(EVC_COUNT3, 0xFFFUL, 0);
+    constexpr DW3000Field EVC_COUNT4_EVC_FWTO(EVC_COUNT4, 0xFFUL, 0);
+    constexpr DW3000Field EVC_COUNT4_EVC_TXFS(EVC_COUNT4, 0xFFF0000UL, 16);
+    constexpr DW3000Field EVC_COUNT5_EVC_HPW(EVC_COUNT5, 0xFFUL, 0);
+    constexpr DW3000Field EVC_COUNT5_EVC_SWCE(EVC_COUNT5, 0xFF0000UL, 16);
+    constexpr DW3000Field EVC_COUNT6_EVC_PREJ(EVC_COUNT6, 0xFFFUL, 0);
+    constexpr DW3000Field EVC_COUNT7_EVC_CPQE(EVC_COUNT7, 0xFFUL, 0);
+    constexpr DW3000Field EVC_COUNT7_EVC_VWARN(EVC_COUNT7, 0xFF0000UL, 16);
+    constexpr DW3000Field EVC_CTRL_EVC_CLR(EVC_CTRL, 0x2UL, 1);
+    constexpr DW3000Field EVC_CTRL_EVC_EN(EVC_CTRL, 0x1UL, 0);
+    constexpr DW3000Field FCMD_STATUS_FCMD_STATUS(FCMD_STATUS, 0x1FUL, 0);
+    constexpr DW3000Field FINT_STAT_CCA_FAIL_AAT(FINT_STAT, 0x2UL, 1);
+    constexpr DW3000Field FINT_STAT_RXERR(FINT_STAT, 0x10UL, 4);
+    constexpr DW3000Field FINT_STAT_RXOK(FINT_STAT, 0x8UL, 3);
+    constexpr DW3000Field FINT_STAT_RXTO(FINT_STAT, 0x20UL, 5);
+    constexpr DW3000Field FINT_STAT_RXTSERR(FINT_STAT, 0x4UL, 2);
+    constexpr DW3000Field FINT_STAT_SYS_EVENT(FINT_STAT, 0x40UL, 6);
+    constexpr DW3000Field FINT_STAT_SYS_PANIC(FINT_STAT, 0x80UL, 7);
+    constexpr DW3000Field FINT_STAT_TXOK(FINT_STAT, 0x1UL, 0);
+    constexpr DW3000Field FP_CONF_CAL_TEMP(FP_CONF, 0x7F800UL, 11);
+    constexpr DW3000Field FP_CONF_FP_AGREED_TH(FP_CONF, 0x700UL, 8);
+    constexpr DW3000Field FP_CONF_TC_RXDLY_EN(FP_CONF, 0x100000UL, 20);
+    constexpr DW3000Field GPIO_DIR_GDP0(GPIO_DIR, 0x1UL, 0);
+    constexpr DW3000Field GPIO_DIR_GDP1(GPIO_DIR, 0x2UL, 1);
+    constexpr DW3000Field GPIO_DIR_GDP2(GPIO_DIR, 0x4UL, 2);
+    constexpr DW3000Field GPIO_DIR_GDP3(GPIO_DIR, 0x8UL, 3);
+    constexpr DW3000Field GPIO_DIR_GDP4(GPIO_DIR, 0x10UL, 4);
+    constexpr DW3000Field GPIO_DIR_GDP5(GPIO_DIR, 0x20UL, 5);
+    constexpr DW3000Field GPIO_DIR_GDP6(GPIO_DIR, 0x40UL, 6);
+    constexpr DW3000Field GPIO_DIR_GDP7(GPIO_DIR, 0x80UL, 7);
+    constexpr DW3000Field GPIO_DIR_GDP8(GPIO_DIR, 0x100UL, 8);
+    constexpr DW3000Field GPIO_IBES_GIBES0(GPIO_IBES, 0x1UL, 0);
+    constexpr DW3000Field GPIO_IBES_GIBES1(GPIO_IBES, 0x2UL, 1);
+    constexpr DW3000Field GPIO_IBES_GIBES2(GPIO_IBES, 0x4UL, 2);
+    constexpr DW3000Field GPIO_IBES_GIBES3(GPIO_IBES, 0x8UL, 3);
+    constexpr DW3000Field GPIO_IBES_GIBES4(GPIO_IBES, 0x10UL, 4);
+    constexpr DW3000Field GPIO_IBES_GIBES5(GPIO_IBES, 0x20UL, 5);
+    constexpr DW3000Field GPIO_IBES_GIBES6(GPIO_IBES, 0x40UL, 6);
+    constexpr DW3000Field GPIO_IBES_GIBES7(GPIO_IBES, 0x80UL, 7);
+    constexpr DW3000Field GPIO_IBES_GIBES8(GPIO_IBES, 0x100UL, 8);
+    constexpr DW3000Field GPIO_ICLR_GICLR0(GPIO_ICLR, 0x1UL, 0);
+    constexpr DW3000Field GPIO_ICLR_GICLR1(GPIO_ICLR, 0x2UL, 1);
+    constexpr DW3000Field GPIO_ICLR_GICLR2(GPIO_ICLR, 0x4UL, 2);
+    constexpr DW3000Field GPIO_ICLR_GICLR3(GPIO_ICLR, 0x8UL, 3);
+    constexpr DW3000Field GPIO_ICLR_GICLR4(GPIO_ICLR, 0x10UL, 4);
+    constexpr DW3000Field GPIO_ICLR_GICLR5(GPIO_ICLR, 0x20UL, 5);
+    constexpr DW3000Field GPIO_ICLR_GICLR6(GPIO_ICLR, 0x40UL, 6);
+    constexpr DW3000Field GPIO_ICLR_GICLR7(GPIO_ICLR, 0x80UL, 7);
+    constexpr DW3000Field GPIO_ICLR_GICLR8(GPIO_ICLR, 0x100UL, 8);
+    constexpr DW3000Field GPIO_IDBE_GIDBE0(GPIO_IDBE, 0x1UL, 0);
+    constexpr DW3000Field GPIO_IDBE_GIDBE1(GPIO_IDBE, 0x2UL, 1);
+    constexpr DW3000Field GPIO_IDBE_GIDBE2(GPIO_IDBE, 0x4UL, 2);
+    constexpr DW3000Field GPIO_IDBE_GIDBE3(GPIO_IDBE, 0x8UL, 3);
+    constexpr DW3000Field GPIO_IDBE_GIDBE4(GPIO_IDBE, 0x10UL, 4);
+    constexpr DW3000Field GPIO_IDBE_GIDBE5(GPIO_IDBE, 0x20UL, 5);
+    constexpr DW3000Field GPIO_IDBE_GIDBE6(GPIO_IDBE, 0x40UL, 6);
+    constexpr DW3000Field GPIO_IDBE_GIDBE7(GPIO_IDBE, 0x80UL, 7);
+    constexpr DW3000Field GPIO_IDBE_GIDBE8(GPIO_IDBE, 0x100UL, 8);
+    constexpr DW3000Field GPIO_IMODE_GIMOD0(GPIO_IMODE, 0x1UL, 0);
+    constexpr DW3000Field GPIO_IMODE_GIMOD1(GPIO_IMODE, 0x2UL, 1);
+    constexpr DW3000Field GPIO_IMODE_GIMOD2(GPIO_IMODE, 0x4UL, 2);
+    constexpr DW3000Field GPIO_IMODE_GIMOD3(GPIO_IMODE, 0x8UL, 3);
+    constexpr DW3000Field GPIO_IMODE_GIMOD4(GPIO_IMODE, 0x10UL, 4);
+    constexpr DW3000Field GPIO_IMODE_GIMOD5(GPIO_IMODE, 0x20UL, 5);
+    constexpr DW3000Field GPIO_IMODE_GIMOD6(GPIO_IMODE, 0x40UL, 6);
+    constexpr DW3000Field GPIO_IMODE_GIMOD7(GPIO_IMODE, 0x80UL, 7);
+    constexpr DW3000Field GPIO_IMODE_GIMOD8(GPIO_IMODE, 0x100UL, 8);
+    constexpr DW3000Field GPIO_IRQE_GIRQE0(GPIO_IRQE, 0x1UL, 0);
+    constexpr DW3000Field GPIO_IRQE_GIRQE1(GPIO_IRQE, 0x2UL, 1);
+    constexpr DW3000Field GPIO_IRQE_GIRQE2(GPIO_IRQE, 0x4UL, 2);
+    constexpr DW3000Field GPIO_IRQE_GIRQE3(GPIO_IRQE, 0x8UL, 3);
+    constexpr DW3000Field GPIO_IRQE_GIRQE4(GPIO_IRQE, 0x10UL, 4);
+    constexpr DW3000Field GPIO_IRQE_GIRQE5(GPIO_IRQE, 0x20UL, 5);
+    constexpr DW3000Field GPIO_IRQE_GIRQE6(GPIO_IRQE, 0x40UL, 6);
+    constexpr DW3000Field GPIO_IRQE_GIRQE7(GPIO_IRQE, 0x80UL, 7);
+    constexpr DW3000Field GPIO_IRQE_GIRQE8(GPIO_IRQE, 0x100UL, 8);
+    constexpr DW3000Field GPIO_ISEN_GISEN0(GPIO_ISEN, 0x1UL, 0);
+    constexpr DW3000Field GPIO_ISEN_GISEN1(GPIO_ISEN, 0x2UL, 1);
+    constexpr DW3000Field GPIO_ISEN_GISEN2(GPIO_ISEN, 0x4UL, 2);
+    constexpr DW3000Field GPIO_ISEN_GISEN3(GPIO_ISEN, 0x8UL, 3);
+    constexpr DW3000Field GPIO_ISEN_GISEN4(GPIO_ISEN, 0x10UL, 4);
+    constexpr DW3000Field GPIO_ISEN_GISEN5(GPIO_ISEN, 0x20UL, 5);
+    constexpr DW3000Field GPIO_ISEN_GISEN6(GPIO_ISEN, 0x40UL, 6);
+    constexpr DW3000Field GPIO_ISEN_GISEN7(GPIO_ISEN, 0x80UL, 7);
+    constexpr DW3000Field GPIO_ISEN_GISEN8(GPIO_ISEN, 0x100UL, 8);
+    constexpr DW3000Field GPIO_ISTS_GISTS0(GPIO_ISTS, 0x1UL, 0);
+    constexpr DW3000Field GPIO_ISTS_GISTS1(GPIO_ISTS, 0x2UL, 1);
+    constexpr DW3000Field GPIO_ISTS_GISTS2(GPIO_ISTS, 0x4UL, 2);
+    constexpr DW3000Field GPIO_ISTS_GISTS3(GPIO_ISTS, 0x8UL, 3);
+    constexpr DW3000Field GPIO_ISTS_GISTS4(GPIO_ISTS, 0x10UL, 4);
+    constexpr DW3000Field GPIO_ISTS_GISTS5(GPIO_ISTS, 0x20UL, 5);
+    constexpr DW3000Field GPIO_ISTS_GISTS6(GPIO_ISTS, 0x40UL, 6);
+    constexpr DW3000Field GPIO_ISTS_GISTS7(GPIO_ISTS, 0x80UL, 7);
+    constexpr DW3000Field GPIO_ISTS_GISTS8(GPIO_ISTS, 0x100UL, 8);
+    constexpr DW3000Field GPIO_MODE_MSGP0_MODE(GPIO_MODE, 0x7UL, 0);
+    constexpr DW3000Field GPIO_MODE_MSGP1_MODE(GPIO_MODE, 0x38UL, 3);
+    constexpr DW3000Field GPIO_MODE_MSGP2_MODE(GPIO_MODE, 0x1C0UL, 6);
+    constexpr DW3000Field GPIO_MODE_MSGP3_MODE(GPIO_MODE, 0xE00UL, 9);
+    constexpr DW3000Field GPIO_MODE_MSGP4_MODE(GPIO_MODE, 0x7000UL, 12);
+    constexpr DW3000Field GPIO_MODE_MSGP5_MODE(GPIO_MODE, 0x38000UL, 15);
+    constexpr DW3000Field GPIO_MODE_MSGP6_MODE(GPIO_MODE, 0x1C0000UL, 18);
+    constexpr DW3000Field GPIO_MODE_MSGP7_MODE(GPIO_MODE, 0xE00000UL, 21);
+    constexpr DW3000Field GPIO_MODE_MSGP8_MODE(GPIO_MODE, 0x7000000UL, 24);
+    constexpr DW3000Field GPIO_OUT_GOP0(GPIO_OUT, 0x1UL, 0);
+    constexpr DW3000Field GPIO_OUT_GOP1(GPIO_OUT, 0x2UL, 1);
+    constexpr DW3000Field GPIO_OUT_GOP2(GPIO_OUT, 0x4UL, 2);
+    constexpr DW3000Field GPIO_OUT_GOP3(GPIO_OUT, 0x8UL, 3);
+    constexpr DW3000Field GPIO_OUT_GOP4(GPIO_OUT, 0x10UL, 4);
+    constexpr DW3000Field GPIO_OUT_GOP5(GPIO_OUT, 0x20UL, 5);
+    constexpr DW3000Field GPIO_OUT_GOP6(GPIO_OUT, 0x40UL, 6);
+    constexpr DW3000Field GPIO_OUT_GOP7(GPIO_OUT, 0x80UL, 7);
+    constexpr DW3000Field GPIO_OUT_GOP8(GPIO_OUT, 0x100UL, 8);
+    constexpr DW3000Field GPIO_RAW_GRAWP0(GPIO_RAW, 0x1UL, 0);
+    constexpr DW3000Field GPIO_RAW_GRAWP1(GPIO_RAW, 0x2UL, 1);
+    constexpr DW3000Field GPIO_RAW_GRAWP2(GPIO_RAW, 0x4UL, 2);
+    constexpr DW3000Field GPIO_RAW_GRAWP3(GPIO_RAW, 0x8UL, 3);
+    constexpr DW3000Field GPIO_RAW_GRAWP4(GPIO_RAW, 0x10UL, 4);
+    constexpr DW3000Field GPIO_RAW_GRAWP5(GPIO_RAW, 0x20UL, 5);
+    constexpr DW3000Field GPIO_RAW_GRAWP6(GPIO_RAW, 0x40UL, 6);
+    constexpr DW3000Field GPIO_RAW_GRAWP7(GPIO_RAW, 0x80UL, 7);
+    constexpr DW3000Field GPIO_RAW_GRAWP8(GPIO_RAW, 0x100UL, 8);
+    constexpr DW3000Field IP_CONFIG_HI_IP_RTM(IP_CONFIG_HI, 0x1FUL, 0);
+    constexpr DW3000Field IP_CONFIG_LO_IP_NTM(IP_CONFIG_LO, 0x1FUL, 0);
+    constexpr DW3000Field IP_CONFIG_LO_IP_PMULT(IP_CONFIG_LO, 0x60UL, 5);
+    constexpr DW3000Field IP_DIAG_0_PEAKAMP(IP_DIAG_0, 0x1FFFFFUL, 0);
+    constexpr DW3000Field IP_DIAG_0_PEAKLOC(IP_DIAG_0, 0x7FE00000UL, 21);
+    constexpr DW3000Field IP_DIAG_12_IPNACC(IP_DIAG_12, 0xFFFUL, 0);
+    constexpr DW3000Field IP_DIAG_1_IPCHANNELAREA(IP_DIAG_1, 0x1FFFFUL, 0);
+    constexpr DW3000Field IP_DIAG_2_IPF1(IP_DIAG_2, 0x3FFFFFUL, 0);
+    constexpr DW3000Field IP_DIAG_3_IPF2(IP_DIAG_3, 0x3FFFFFUL, 0);
+    constexpr DW3000Field IP_DIAG_4_IPF3(IP_DIAG_4, 0x3FFFFFUL, 0);
+    constexpr DW3000Field IP_DIAG_8_IPFPLOC(IP_DIAG_8, 0xFFFFUL, 0);
+    constexpr DW3000Field IP_TOA_HI_IP_POA(IP_TOA_HI, 0x3FFF00UL, 8);
+    constexpr DW3000Field IP_TOA_HI_IP_TOA(IP_TOA_HI, 0xFFUL, 0);
+    constexpr DW3000Field IP_TOA_HI_IP_TOAST(IP_TOA_HI, 0xFF000000UL, 24);
+    constexpr DW3000Field IP_TOA_LO_IP_TOA(IP_TOA_LO, 0xFFFFFFFFUL, 0);
+    constexpr DW3000Field LDO_CTRL_LDO_VDDHVTX_EN(LDO_CTRL, 0x800UL, 11);
+    constexpr DW3000Field LDO_CTRL_LDO_VDDHVTX_VREF(LDO_CTRL, 0x8000000UL, 27);
+    constexpr DW3000Field LDO_CTRL_LDO_VDDIF2_EN(LDO_CTRL, 0x100UL, 8);
+    constexpr DW3000Field LDO_CTRL_LDO_VDDMS1_EN(LDO_CTRL, 0x1UL, 0);
+    constexpr DW3000Field LDO_CTRL_LDO_VDDMS2_EN(LDO_CTRL, 0x2UL, 1);
+    constexpr DW3000Field LDO_CTRL_LDO_VDDMS2_VREF(LDO_CTRL, 0x20000UL, 17);
+    constexpr DW3000Field LDO_CTRL_LDO_VDDMS3_EN(LDO_CTRL, 0x4UL, 2);
+    constexpr DW3000Field LDO_CTRL_LDO_VDDPLL_EN(LDO_CTRL, 0x10UL, 4);
+    constexpr DW3000Field LDO_CTRL_LDO_VDDPLL_VREF(LDO_CTRL, 0x100000UL, 20);
+    constexpr DW3000Field LDO_CTRL_LDO_VDDTX1_EN(LDO_CTRL, 0x20UL, 5);
+    constexpr DW3000Field LDO_CTRL_LDO_VDDTX1_VREF(LDO_CTRL, 0x200000UL, 21);
+    constexpr DW3000Field LDO_CTRL_LDO_VDDTX2_EN(LDO_CTRL, 0x40UL, 6);
+    constexpr DW3000Field LDO_CTRL_LDO_VDDTX2_VREF(LDO_CTRL, 0x400000UL, 22);
+    constexpr DW3000Field LDO_CTRL_LDO_VDDVCO_EN(LDO_CTRL, 0x8UL, 3);
+    constexpr DW3000Field LDO_CTRL_LDO_VDDVCO_VREF(LDO_CTRL, 0x80000UL, 19);
+    constexpr DW3000Field LDO_TUNE_HI_LDO_HVAUX_TUNE(LDO_TUNE_HI, 0xF000UL, 12);
+    constexpr DW3000Field LED_CTRL_BLINK_EN(LED_CTRL, 0x100UL, 8);
+    constexpr DW3000Field LED_CTRL_FORCE_TRIGGER(LED_CTRL, 0xF0000UL, 16);
+    constexpr DW3000Field OTP_ADDR_OTP_ADDR(OTP_ADDR, 0x7FFUL, 0);
+    constexpr DW3000Field OTP_CFG_BIAS_KICK(OTP_CFG, 0x100UL, 8);
+    constexpr DW3000Field OTP_CFG_DGC_KICK(OTP_CFG, 0x40UL, 6);
+    constexpr DW3000Field OTP_CFG_DGC_SEL(OTP_CFG, 0x2000UL, 13);
+    constexpr DW3000Field OTP_CFG_LDO_KICK(OTP_CFG, 0x80UL, 7);
+    constexpr DW3000Field OTP_CFG_OPS_ID(OTP_CFG, 0x1800UL, 11);
+    constexpr DW3000Field OTP_CFG_OPS_KICK(OTP_CFG, 0x400UL, 10);
+    constexpr DW3000Field OTP_CFG_OTP_MAN_CTR_EN(OTP_CFG, 0x1UL, 0);
+    constexpr DW3000Field OTP_CFG_OTP_READ(OTP_CFG, 0x2UL, 1);
+    constexpr DW3000Field OTP_CFG_OTP_WRITE(OTP_CFG, 0x4UL, 2);
+    constexpr DW3000Field OTP_CFG_OTP_WRITE_MR(OTP_CFG, 0x8UL, 3);
+    constexpr DW3000Field OTP_RDATA_OTP_RDATA(OTP_RDATA, 0xFFFFFFFFUL, 0);
+    constexpr DW3000Field OTP_STATUS_OTP_PROG_DONE(OTP_STATUS, 0x1UL, 0);
+    constexpr DW3000Field OTP_STATUS_OTP_VPP_OK(OTP_STATUS, 0x2UL, 1);
+    constexpr DW3000Field OTP_WDATA_OTP_WDATA(OTP_WDATA, 0xFFFFFFFFUL, 0);
+    constexpr DW3000Field PANADR_PAN_ID(PANADR, 0xFFFF0000UL, 16);
+    constexpr DW3000Field PANADR_SHORTADDR(PANADR, 0xFFFFUL, 0);
+    constexpr DW3000Field PGC_CTRL_PGC_AUTO_CAL(PGC_CTRL, 0x2UL, 1);
+    constexpr DW3000Field PGC_CTRL_PGC_START(PGC_CTRL, 0x1UL, 0);
+    constexpr DW3000Field PGC_STATUS_AUTOCAL_DONE(PGC_STATUS, 0x1000UL, 12);
+    constexpr DW3000Field PGC_STATUS_PG_DELAY_COUNT(PGC_STATUS, 0xFFFUL, 0);
+    constexpr DW3000Field PG_CAL_TARGET_TARGET(PG_CAL_TARGET, 0xFFFUL, 0);
+    constexpr DW3000Field PG_TEST_TX_TEST_CH1(PG_TEST, 0xFUL, 0);
+    constexpr DW3000Field PG_TEST_TX_TEST_CH2(PG_TEST, 0xF0UL, 4);
+    constexpr DW3000Field PG_TEST_TX_TEST_CH3(PG_TEST, 0xF00UL, 8);
+    constexpr DW3000Field PG_TEST_TX_TEST_CH4(PG_TEST, 0xF000UL, 12);
+    constexpr DW3000Field PG_TST_DATA_PG_TEST_DATA(PG_TST_DATA, 0xFFFFFFFFUL, 0);
+    constexpr DW3000Field PLL_CAL_PLL_CAL_EN(PLL_CAL, 0x100UL, 8);
+    constexpr DW3000Field PLL_CAL_PLL_TUNE_OVR(PLL_CAL, 0x4UL, 2);
+    constexpr DW3000Field PLL_CAL_PLL_USE_OLD(PLL_CAL, 0x2UL, 1);
+    constexpr DW3000Field PLL_CAL_PLL_WD_EN(PLL_CAL, 0x80000UL, 19);
+    constexpr DW3000Field PLL_COARSE_CODE_CH5_VCO_COARSE_TUNE(PLL_COARSE_CODE, 0x3FFF00UL, 8);
+    constexpr DW3000Field PLL_COARSE_CODE_CH9_RVCO_FREQ_BOOST(PLL_COARSE_CODE, 0x1000000UL, 24);
+    constexpr DW3000Field PLL_COARSE_CODE_CH9_VCO_COARSE_TUNE(PLL_COARSE_CODE, 0x1FUL, 0);
+    constexpr DW3000Field PLL_STATUS_CPC_CAL_DONE(PLL_STATUS, 0x1UL, 0);
+    constexpr DW3000Field PLL_STATUS_LD_CODE(PLL_STATUS, 0x1F00UL, 8);
+    constexpr DW3000Field PLL_STATUS_PLL_HI_FLAG(PLL_STATUS, 0x8UL, 3);
+    constexpr DW3000Field PLL_STATUS_PLL_LOCK_FLAG(PLL_STATUS, 0x2UL, 1);
+    constexpr DW3000Field PLL_STATUS_PLL_LO_FLAG_N(PLL_STATUS, 0x4UL, 2);
+    constexpr DW3000Field PLL_STATUS_PLL_OVRFLOW(PLL_STATUS, 0x10UL, 4);
+    constexpr DW3000Field PLL_STATUS_VCO_TUNE_UPDATE(PLL_STATUS, 0x20UL, 5);
+    constexpr DW3000Field PLL_STATUS_XTAL_AMP_SETTLED(PLL_STATUS, 0x40UL, 6);
+    constexpr DW3000Field RDB_DIAG_MODE_RDB_DMODE(RDB_DIAG_MODE, 0x7UL, 0);
+    constexpr DW3000Field RDB_STATUS_CIADONE0(RDB_STATUS, 0x4UL, 2);
+    constexpr DW3000Field RDB_STATUS_CIADONE1(RDB_STATUS, 0x40UL, 6);
+    constexpr DW3000Field RDB_STATUS_CP_ERR0(RDB_STATUS, 0x8UL, 3);
+    constexpr DW3000Field RDB_STATUS_CP_ERR1(RDB_STATUS, 0x80UL, 7);
+    constexpr DW3000Field RDB_STATUS_RXFCG0(RDB_STATUS, 0x1UL, 0);
+    constexpr DW3000Field RDB_STATUS_RXFCG1(RDB_STATUS, 0x10UL, 4);
+    constexpr DW3000Field RDB_STATUS_RXFR0(RDB_STATUS, 0x2UL, 1);
+    constexpr DW3000Field RDB_STATUS_RXFR1(RDB_STATUS, 0x20UL, 5);
+    constexpr DW3000Field RF_ENABLE_PLL_RX_PRE_EN(RF_ENABLE, 0x8000000UL, 27);
+    constexpr DW3000Field RF_ENABLE_PLL_TX_PRE_EN(RF_ENABLE, 0x4000000UL, 26);
+    constexpr DW3000Field RF_ENABLE_TX_BIAS_EN(RF_ENABLE, 0x400UL, 10);
+    constexpr DW3000Field RF_ENABLE_TX_CH5(RF_ENABLE, 0x2000UL, 13);
+    constexpr DW3000Field RF_ENABLE_TX_EN(RF_ENABLE, 0x1000UL, 12);
+    constexpr DW3000Field RF_ENABLE_TX_EN_BUF(RF_ENABLE, 0x800UL, 11);
+    constexpr DW3000Field RF_ENABLE_TX_SW_EN(RF_ENABLE, 0x2000000UL, 25);
+    constexpr DW3000Field RF_STATUS_PLL1_HI_FLAG(RF_STATUS, 0x4UL, 2);
+    constexpr DW3000Field RF_STATUS_PLL1_LOCK(RF_STATUS, 0x1UL, 0);
+    constexpr DW3000Field RF_STATUS_PLL1_LO_FLAG(RF_STATUS, 0x2UL, 1);
+    constexpr DW3000Field RF_STATUS_PLL1_MID_FLAG(RF_STATUS, 0x8UL, 3);
+    constexpr DW3000Field RF_SWITCH_CTRL_ANTSWCTRL(RF_SWITCH_CTRL, 0x7000UL, 12);
+    constexpr DW3000Field RF_SWITCH_CTRL_ANTSWEN(RF_SWITCH_CTRL, 0x100UL, 8);
+    constexpr DW3000Field RF_SWITCH_CTRL_ANT_SW_NO_TOGGLE(RF_SWITCH_CTRL, 0x1UL, 0);
+    constexpr DW3000Field RF_SWITCH_CTRL_ANT_SW_PDOA_PORT(RF_SWITCH_CTRL, 0x2UL, 1);
+    constexpr DW3000Field RF_SWITCH_CTRL_TXRX_SW_CTRL(RF_SWITCH_CTRL, 0x3F000000UL, 24);
+    constexpr DW3000Field RF_SWITCH_CTRL_TXRX_SW_EN(RF_SWITCH_CTRL, 0x10000UL, 16);
+    constexpr DW3000Field RX_CAL_CFG_CAL_EN(RX_CAL_CFG, 0x10UL, 4);
+    constexpr DW3000Field RX_CAL_CFG_CAL_MODE(RX_CAL_CFG, 0x3UL, 0);
+    constexpr DW3000Field RX_CAL_CFG_COMP_DLY(RX_CAL_CFG, 0xF0000UL, 16);
+    constexpr DW3000Field RX_FINFO_RNG(RX_FINFO, 0x8000UL, 15);
+    constexpr DW3000Field RX_FINFO_RXBR(RX_FINFO, 0x2000UL, 13);
+    constexpr DW3000Field RX_FINFO_RXFLEN(RX_FINFO, 0x3FFUL, 0);
+    constexpr DW3000Field RX_FINFO_RXNSPL(RX_FINFO, 0x1800UL, 11);
+    constexpr DW3000Field RX_FINFO_RXPACC(RX_FINFO, 0xFFF00000UL, 20);
+    constexpr DW3000Field RX_FINFO_RXPRF(RX_FINFO, 0x30000UL, 16);
+    constexpr DW3000Field RX_FINFO_RXPSR(RX_FINFO, 0xC0000UL, 18);
+    constexpr DW3000Field RX_FWTO_FWTO(RX_FWTO, 0xFFFFFUL, 0);
+    constexpr DW3000Field RX_SNIFF_SNIFF_OFF(RX_SNIFF, 0xFF00UL, 8);
+    constexpr DW3000Field RX_SNIFF_SNIFF_ON(RX_SNIFF, 0xFUL, 0);
+    constexpr DW3000Field RX_TIME_RAW_RX_RAWST(RX_TIME_RAW, 0xFFFFFFFFUL, 0);
+    constexpr DW3000Field SAR_CTRL_SAR_OVR_MUX_EN(SAR_CTRL, 0x20UL, 5);
+    constexpr DW3000Field SAR_CTRL_SAR_START(SAR_CTRL, 0x1UL, 0);
+    constexpr DW3000Field SAR_READING_SAR_READING_TEMP(SAR_READING, 0xFF00UL, 8);
+    constexpr DW3000Field SAR_READING_SAR_READING_VBAT(SAR_READING, 0xFFUL, 0);
+    constexpr DW3000Field SAR_STATUS_SAR_DONE(SAR_STATUS, 0x1UL, 0);
+    constexpr DW3000Field SAR_TEST_SAR_RDEN(SAR_TEST, 0x4UL, 2);
+    constexpr DW3000Field SAR_WAKE_RD_SAR_LAST_TEMP(SAR_WAKE_RD, 0xFF00UL, 8);
+    constexpr DW3000Field SAR_WAKE_RD_SAR_LAST_VBAT(SAR_WAKE_RD, 0xFFUL, 0);
+    constexpr DW3000Field SEQ_CTRL_AINIT2IDLE(SEQ_CTRL, 0x100UL, 8);
+    constexpr DW3000Field SEQ_CTRL_ARX2SLP(SEQ_CTRL, 0x1000UL, 12);
+    constexpr DW3000Field SEQ_CTRL_ATX2SLP(SEQ_CTRL, 0x800UL, 11);
+    constexpr DW3000Field SEQ_CTRL_AUTO_RX_SEQ(SEQ_CTRL, 0x400UL, 10);
+    constexpr DW3000Field SEQ_CTRL_AUTO_TX_SEQ(SEQ_CTRL, 0x200UL, 9);
+    constexpr DW3000Field SEQ_CTRL_CIA_SEQ_EN(SEQ_CTRL, 0x20000UL, 17);
+    constexpr DW3000Field SEQ_CTRL_FORCE2IDLE(SEQ_CTRL, 0x400000UL, 22);
+    constexpr DW3000Field SEQ_CTRL_FORCE2INIT(SEQ_CTRL, 0x800000UL, 23);
+    constexpr DW3000Field SEQ_CTRL_FORCE_SYNC(SEQ_CTRL, 0x2000000UL, 25);
+    constexpr DW3000Field SEQ_CTRL_LP_CLK_DIV(SEQ_CTRL, 0xFC000000UL, 26);
+    constexpr DW3000Field SEQ_CTRL_PLL_SYNC_MODE(SEQ_CTRL, 0x8000UL, 15);
+    constexpr DW3000Field SPICRC_CFG_SPI_RD_CRC(SPICRC_CFG, 0xFFUL, 0);
+    constexpr DW3000Field SPI_MODE_SPI_MODE(SPI_MODE, 0x3UL, 0);
+    constexpr DW3000Field STS1_DIAG_12_CY1NACC(STS1_DIAG_12, 0xFFFUL, 0);
+    constexpr DW3000Field STS1_DIAG_1_CY1CHANNELAREA(STS1_DIAG_1, 0xFFFFFUL, 0);
+    constexpr DW3000Field STS1_DIAG_2_CY1F1(STS1_DIAG_2, 0x3FFFFFUL, 0);
+    constexpr DW3000Field STS1_DIAG_3_CY1F2(STS1_DIAG_3, 0x3FFFFFUL, 0);
+    constexpr DW3000Field STS1_DIAG_4_CY1F3(STS1_DIAG_4, 0x3FFFFFUL, 0);
+    constexpr DW3000Field STS1_TOA_HI_STS1_POA(STS1_TOA_HI, 0x3FFF00UL, 8);
+    constexpr DW3000Field STS1_TOA_HI_STS1_TOA(STS1_TOA_HI, 0xFFUL, 0);
+    constexpr DW3000Field STS1_TOA_HI_STS1_TOAST(STS1_TOA_HI, 0xFF800000UL, 23);
+    constexpr DW3000Field STS1_TOA_LO_STS1_TOA(STS1_TOA_LO, 0xFFFFFFFFUL, 0);
+    constexpr DW3000Field STS_CFG0_CPS_LEN(STS_CFG0, 0xFFUL, 0);
+    constexpr DW3000Field STS_CONFIG_HI_FP_AGREED_EN(STS_CONFIG_HI, 0x10000000UL, 28);
+    constexpr DW3000Field STS_CONFIG_HI_RES_B0(STS_CONFIG_HI, 0xF0UL, 4);
+    constexpr DW3000Field STS_CONFIG_HI_STS_CQ_EN(STS_CONFIG_HI, 0x20000000UL, 29);
+    constexpr DW3000Field STS_CONFIG_HI_STS_PGR_EN(STS_CONFIG_HI, 0x80000000UL, 31);
+    constexpr DW3000Field STS_CONFIG_HI_STS_SS_EN(STS_CONFIG_HI, 0x40000000UL, 30);
+    constexpr DW3000Field STS_CONFIG_LO_STS_MAN_TH(STS_CONFIG_LO, 0x7F0000UL, 16);
+    constexpr DW3000Field STS_CONFIG_LO_STS_NTM(STS_CONFIG_LO, 0x1FUL, 0);
+    constexpr DW3000Field STS_CONFIG_LO_STS_PMULT(STS_CONFIG_LO, 0x60UL, 5);
+    constexpr DW3000Field STS_CTRL_LOAD_IV(STS_CTRL, 0x1UL, 0);
+    constexpr DW3000Field STS_CTRL_RST_LAST(STS_CTRL, 0x2UL, 1);
+    constexpr DW3000Field STS_DIAG_0_PEAKAMP(STS_DIAG_0, 0x1FFFFFUL, 0);
+    constexpr DW3000Field STS_DIAG_0_PEAKLOC(STS_DIAG_0, 0x3FE00000UL, 21);
+    constexpr DW3000Field STS_DIAG_12_CYNACC(STS_DIAG_12, 0xFFFUL, 0);
+    constexpr DW3000Field STS_DIAG_12_SFDPHASECOUNT(STS_DIAG_12, 0xFFF000UL, 12);
+    constexpr DW3000Field STS_DIAG_1_CY0CHANNELAREA(STS_DIAG_1, 0xFFFFFUL, 0);
+    constexpr DW3000Field STS_DIAG_2_CY0F1(STS_DIAG_2, 0x3FFFFFUL, 0);
+    constexpr DW3000Field STS_DIAG_3_CY0F2(STS_DIAG_3, 0x3FFFFFUL, 0);
+    constexpr DW3000Field STS_DIAG_4_CY0F3(STS_DIAG_4, 0x3FFFFFUL, 0);
+    constexpr DW3000Field STS_STS_ACC_QUAL(STS_STS, 0xFFFUL, 0);
+    constexpr DW3000Field STS_TOA_HI_STS_POA(STS_TOA_HI, 0x3FFF00UL, 8);
+    constexpr DW3000Field STS_TOA_HI_STS_TOA(STS_TOA_HI, 0xFFUL, 0);
+    constexpr DW3000Field STS_TOA_HI_STS_TOAST(STS_TOA_HI, 0xFF800000UL, 23);
+    constexpr DW3000Field STS_TOA_LO_STS_TOA(STS_TOA_LO, 0xFFFFFFFFUL, 0);
+    constexpr DW3000Field SYS_CFG_AUTO_ACK(SYS_CFG, 0x800UL, 11);
+    constexpr DW3000Field SYS_CFG_CIA_IPATOV(SYS_CFG, 0x80UL, 7);
+    constexpr DW3000Field SYS_CFG_CIA_STS(SYS_CFG, 0x100UL, 8);
+    constexpr DW3000Field SYS_CFG_CP_SDC(SYS_CFG, 0x8000UL, 15);
+    constexpr DW3000Field SYS_CFG_CP_SPC(SYS_CFG, 0x3000UL, 12);
+    constexpr DW3000Field SYS_CFG_DIS_DRXB(SYS_CFG, 0x8UL, 3);
+    constexpr DW3000Field SYS_CFG_DIS_FCE(SYS_CFG, 0x4UL, 2);
+    constexpr DW3000Field SYS_CFG_DIS_FCS_TX(SYS_CFG, 0x2UL, 1);
+    constexpr DW3000Field SYS_CFG_FAST_AAT_EN(SYS_CFG, 0x40000UL, 18);
+    constexpr DW3000Field SYS_CFG_FFEN(SYS_CFG, 0x1UL, 0);
+    constexpr DW3000Field SYS_CFG_PDOA_MODE(SYS_CFG, 0x30000UL, 16);
+    constexpr DW3000Field SYS_CFG_PHR_6M8(SYS_CFG, 0x20UL, 5);
+    constexpr DW3000Field SYS_CFG_PHR_MODE(SYS_CFG, 0x10UL, 4);
+    constexpr DW3000Field SYS_CFG_RXAUTR(SYS_CFG, 0x400UL, 10);
+    constexpr DW3000Field SYS_CFG_RXWTOE(SYS_CFG, 0x200UL, 9);
+    constexpr DW3000Field SYS_CFG_SPI_CRC(SYS_CFG, 0x40UL, 6);
+    constexpr DW3000Field SYS_ENABLE_HI_AES_DONE_ENABLE(SYS_ENABLE_HI, 0x40UL, 6);
+    constexpr DW3000Field SYS_ENABLE_HI_AES_ERR_ENABLE(SYS_ENABLE_HI, 0x80UL, 7);
+    constexpr DW3000Field SYS_ENABLE_HI_CCA_FAIL_ENABLE(SYS_ENABLE_HI, 0x1000UL, 12);
+    constexpr DW3000Field SYS_ENABLE_HI_CMD_ERR_ENABLE(SYS_ENABLE_HI, 0x100UL, 8);
+    constexpr DW3000Field SYS_ENABLE_HI_GPIOIRQ_ENABLE(SYS_ENABLE_HI, 0x20UL, 5);
+    constexpr DW3000Field SYS_ENABLE_HI_RXPREJ_ENABLE(SYS_ENABLE_HI, 0x2UL, 1);
+    constexpr DW3000Field SYS_ENABLE_HI_SPIERR_ENABLE(SYS_ENABLE_HI, 0x800UL, 11);
+    constexpr DW3000Field SYS_ENABLE_HI_SPI_OVF_ENABLE(SYS_ENABLE_HI, 0x200UL, 9);
+    constexpr DW3000Field SYS_ENABLE_HI_SPI_UNF_ENABLE(SYS_ENABLE_HI, 0x400UL, 10);
+    constexpr DW3000Field SYS_ENABLE_HI_VT_DET_ENABLE(SYS_ENABLE_HI, 0x10UL, 4);
+    constexpr DW3000Field SYS_ENABLE_LO_AAT_ENABLE(SYS_ENABLE_LO, 0x8UL, 3);
+    constexpr DW3000Field SYS_ENABLE_LO_ARFE_ENABLE(SYS_ENABLE_LO, 0x20000000UL, 29);
+    constexpr DW3000Field SYS_ENABLE_LO_CIADONE_ENABLE(SYS_ENABLE_LO, 0x400UL, 10);
+    constexpr DW3000Field SYS_ENABLE_LO_CIAERR_ENABLE(SYS_ENABLE_LO, 0x40000UL, 18);
+    constexpr DW3000Field SYS_ENABLE_LO_CPERR_ENABLE(SYS_ENABLE_LO, 0x10000000UL, 28);
+    constexpr DW3000Field SYS_ENABLE_LO_CP_LOCK_ENABLE(SYS_ENABLE_LO, 0x2UL, 1);
+    constexpr DW3000Field SYS_ENABLE_LO_HPDWARN_ENABLE(SYS_ENABLE_LO, 0x8000000UL, 27);
+    constexpr DW3000Field SYS_ENABLE_LO_PLL_HILO_ENABLE(SYS_ENABLE_LO, 0x2000000UL, 25);
+    constexpr DW3000Field SYS_ENABLE_LO_RCINIT_ENABLE(SYS_ENABLE_LO, 0x1000000UL, 24);
+    constexpr DW3000Field SYS_ENABLE_LO_RXFCE_ENABLE(SYS_ENABLE_LO, 0x8000UL, 15);
+    constexpr DW3000Field SYS_ENABLE_LO_RXFCG_ENABLE(SYS_ENABLE_LO, 0x4000UL, 14);
+    constexpr DW3000Field SYS_ENABLE_LO_RXFR_ENABLE(SYS_ENABLE_LO, 0x2000UL, 13);
+    constexpr DW3000Field SYS_ENABLE_LO_RXFSL_ENABLE(SYS_ENABLE_LO, 0x10000UL, 16);
+    constexpr DW3000Field SYS_ENABLE_LO_RXFTO_ENABLE(SYS_ENABLE_LO, 0x20000UL, 17);
+    constexpr DW3000Field SYS_ENABLE_LO_RXOVRR_ENABLE(SYS_ENABLE_LO, 0x100000UL, 20);
+    constexpr DW3000Field SYS_ENABLE_LO_RXPHD_ENABLE(SYS_ENABLE_LO, 0x800UL, 11);
+    constexpr DW3000Field SYS_ENABLE_LO_RXPHE_ENABLE(SYS_ENABLE_LO, 0x1000UL, 12);
+    constexpr DW3000Field SYS_ENABLE_LO_RXPRD_ENABLE(SYS_ENABLE_LO, 0x100UL, 8);
+    constexpr DW3000Field SYS_ENABLE_LO_RXPTO_ENABLE(SYS_ENABLE_LO, 0x200000UL, 21);
+    constexpr DW3000Field SYS_ENABLE_LO_RXSFDD_ENABLE(SYS_ENABLE_LO, 0x200UL, 9);
+    constexpr DW3000Field SYS_ENABLE_LO_RXSTO_ENABLE(SYS_ENABLE_LO, 0x4000000UL, 26);
+    constexpr DW3000Field SYS_ENABLE_LO_SPICRCE_ENABLE(SYS_ENABLE_LO, 0x4UL, 2);
+    constexpr DW3000Field SYS_ENABLE_LO_SPIRDY_ENABLE(SYS_ENABLE_LO, 0x800000UL, 23);
+    constexpr DW3000Field SYS_ENABLE_LO_TXFRB_ENABLE(SYS_ENABLE_LO, 0x10UL, 4);
+    constexpr DW3000Field SYS_ENABLE_LO_TXFRS_ENABLE(SYS_ENABLE_LO, 0x80UL, 7);
+    constexpr DW3000Field SYS_ENABLE_LO_TXPHS_ENABLE(SYS_ENABLE_LO, 0x40UL, 6);
+    constexpr DW3000Field SYS_ENABLE_LO_TXPRS_ENABLE(SYS_ENABLE_LO, 0x20UL, 5);
+    constexpr DW3000Field SYS_ENABLE_LO_VWARN_ENABLE(SYS_ENABLE_LO, 0x80000UL, 19);
+    constexpr DW3000Field SYS_STATUS_AAT(SYS_STATUS, 0x8UL, 3);
+    constexpr DW3000Field SYS_STATUS_ARFE(SYS_STATUS, 0x20000000UL, 29);
+    constexpr DW3000Field SYS_STATUS_CIADONE(SYS_STATUS, 0x400UL, 10);
+    constexpr DW3000Field SYS_STATUS_CIAERR(SYS_STATUS, 0x40000UL, 18);
+    constexpr DW3000Field SYS_STATUS_CPERR(SYS_STATUS, 0x10000000UL, 28);
+    constexpr DW3000Field SYS_STATUS_CP_LOCK(SYS_STATUS, 0x2UL, 1);
+    constexpr DW3000Field SYS_STATUS_HI_AES_DONE(SYS_STATUS_HI, 0x40UL, 6);
+    constexpr DW3000Field SYS_STATUS_HI_AES_ERR(SYS_STATUS_HI, 0x80UL, 7);
+    constexpr DW3000Field SYS_STATUS_HI_CCA_FAIL(SYS_STATUS_HI, 0x1000UL, 12);
+    constexpr DW3000Field SYS_STATUS_HI_CMD_ERR(SYS_STATUS_HI, 0x100UL, 8);
+    constexpr DW3000Field SYS_STATUS_HI_GPIO_IRQ(SYS_STATUS_HI, 0x20UL, 5);
+    constexpr DW3000Field SYS_STATUS_HI_RXPREJ(SYS_STATUS_HI, 0x2UL, 1);
+    constexpr DW3000Field SYS_STATUS_HI_SPIERR(SYS_STATUS_HI, 0x800UL, 11);
+    constexpr DW3000Field SYS_STATUS_HI_SPI_OVF(SYS_STATUS_HI, 0x200UL, 9);
+    constexpr DW3000Field SYS_STATUS_HI_SPI_UNF(SYS_STATUS_HI, 0x400UL, 10);
+    constexpr DW3000Field SYS_STATUS_HI_VT_DET(SYS_STATUS_HI, 0x10UL, 4);
+    constexpr DW3000Field SYS_STATUS_HPDWARN(SYS_STATUS, 0x8000000UL, 27);
+    constexpr DW3000Field SYS_STATUS_IRQS(SYS_STATUS, 0x1UL, 0);
+    constexpr DW3000Field SYS_STATUS_PLL_HILO(SYS_STATUS, 0x2000000UL, 25);
+    constexpr DW3000Field SYS_STATUS_RCINIT(SYS_STATUS, 0x1000000UL, 24);
+    constexpr DW3000Field SYS_STATUS_RXFCE(SYS_STATUS, 0x8000UL, 15);
+    constexpr DW3000Field SYS_STATUS_RXFCG(SYS_STATUS, 0x4000UL, 14);
+    constexpr DW3000Field SYS_STATUS_RXFR(SYS_STATUS, 0x2000UL, 13);
+    constexpr DW3000Field SYS_STATUS_RXFSL(SYS_STATUS, 0x10000UL, 16);
+    constexpr DW3000Field SYS_STATUS_RXFTO(SYS_STATUS, 0x20000UL, 17);
+    constexpr DW3000Field SYS_STATUS_RXOVRR(SYS_STATUS, 0x100000UL, 20);
+    constexpr DW3000Field SYS_STATUS_RXPHD(SYS_STATUS, 0x800UL, 11);
+    constexpr DW3000Field SYS_STATUS_RXPHE(SYS_STATUS, 0x1000UL, 12);
+    constexpr DW3000Field SYS_STATUS_RXPRD(SYS_STATUS, 0x100UL, 8);
+    constexpr DW3000Field SYS_STATUS_RXPTO(SYS_STATUS, 0x200000UL, 21);
+    constexpr DW3000Field SYS_STATUS_RXSFDD(SYS_STATUS, 0x200UL, 9);
+    constexpr DW3000Field SYS_STATUS_RXSTO(SYS_STATUS, 0x4000000UL, 26);
+    constexpr DW3000Field SYS_STATUS_SPICRCE(SYS_STATUS, 0x4UL, 2);
+    constexpr DW3000Field SYS_STATUS_SPIRDY(SYS_STATUS, 0x800000UL, 23);
+    constexpr DW3000Field SYS_STATUS_TXFRB(SYS_STATUS, 0x10UL, 4);
+    constexpr DW3000Field SYS_STATUS_TXFRS(SYS_STATUS, 0x80UL, 7);
+    constexpr DW3000Field SYS_STATUS_TXPHS(SYS_STATUS, 0x40UL, 6);
+    constexpr DW3000Field SYS_STATUS_TXPRS(SYS_STATUS, 0x20UL, 5);
+    constexpr DW3000Field SYS_STATUS_VWARN(SYS_STATUS, 0x80000UL, 19);
+    constexpr DW3000Field SYS_TIME_SYS_TIME(SYS_TIME, 0xFFFFFFFEUL, 1);
+    constexpr DW3000Field TEST_CTRL0_CIA_RUN(TEST_CTRL0, 0x4000000UL, 26);
+    constexpr DW3000Field TEST_CTRL0_CIA_WDEN(TEST_CTRL0, 0x1000000UL, 24);
+    constexpr DW3000Field TEST_CTRL0_HIRQ_POL(TEST_CTRL0, 0x200000UL, 21);
+    constexpr DW3000Field TEST_CTRL0_TX_PSTM(TEST_CTRL0, 0x10UL, 4);
+    constexpr DW3000Field TX_CTRL_HI_TX_PG_DELAY(TX_CTRL_HI, 0x3FUL, 0);
+    constexpr DW3000Field TX_CTRL_LO_TX_LOBUF_CTRL(TX_CTRL_LO, 0x0UL, 20);
+    constexpr DW3000Field TX_CTRL_LO_TX_VBULK_CTRL(TX_CTRL_LO, 0x0UL, 18);
+    constexpr DW3000Field TX_CTRL_LO_TX_VCASC_CTRL(TX_CTRL_LO, 0x0UL, 16);
+    constexpr DW3000Field TX_FCTRL_HI_FINE_PLEN(TX_FCTRL_HI, 0xFF00UL, 8);
+    constexpr DW3000Field TX_FCTRL_TR(TX_FCTRL, 0x800UL, 11);
+    constexpr DW3000Field TX_FCTRL_TXBR(TX_FCTRL, 0x400UL, 10);
+    constexpr DW3000Field TX_FCTRL_TXB_OFFSET(TX_FCTRL, 0x3FF0000UL, 16);
+    constexpr DW3000Field TX_FCTRL_TXFLEN(TX_FCTRL, 0x3FFUL, 0);
+    constexpr DW3000Field TX_FCTRL_TXPSR(TX_FCTRL, 0xF000UL, 12);
+    constexpr DW3000Field TX_POWER_COARSE(TX_POWER, 0x3UL, 0);
+    constexpr DW3000Field TX_POWER_FINE(TX_POWER, 0xFCUL, 2);
+    constexpr DW3000Field TX_TEST_TX_ENTEST_CH1(TX_TEST, 0x8UL, 3);
+    constexpr DW3000Field TX_TEST_TX_ENTEST_CH2(TX_TEST, 0x4UL, 2);
+    constexpr DW3000Field TX_TEST_TX_ENTEST_CH3(TX_TEST, 0x2UL, 1);
+    constexpr DW3000Field TX_TEST_TX_ENTEST_CH4(TX_TEST, 0x1UL, 0);
+    constexpr DW3000Field TX_TIME_RAW_TX_RAWST(TX_TIME_RAW, 0xFFFFFFFFUL, 0);
+    constexpr DW3000Field XTAL_XTAL_TRIM(XTAL, 0x7FUL, 0);
+}
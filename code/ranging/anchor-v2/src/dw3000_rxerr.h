@@ -0,0 +1,158 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "dw3000_regs.h"
+
+/*
+ Why a receive failed, decoded from SYS_STATUS. One receive can fail for more than one reason (a PHR error also loses the FCS).
+*/
+enum DW3000RxError
+{
+    DW3000_RX_ERR_PHR,              // RXPHE: the PHR failed its SECDED check, wrong length or data rate
+    DW3000_RX_ERR_FCS,              // RXFCE: the payload arrived with a bad CRC
+    DW3000_RX_ERR_RS,               // RXFSL: the Reed-Solomon decoder could not correct the payload (sync loss)
+    DW3000_RX_ERR_SFD_TIMEOUT,      // RXSTO: preamble without an SFD in RX_SFD_TOC, usually a preamble longer than configured
+    DW3000_RX_ERR_PREAMBLE_TIMEOUT, // RXPTO: no preamble within PRE_TOC
+    DW3000_RX_ERR_FRAME_TIMEOUT,    // RXFTO: no complete frame within RX_FWTO
+    DW3000_RX_ERR_CIA,              // CIAERR: the CIA could not find the first path, no timestamp
+    DW3000_RX_ERR_STS,              // CPERR: STS quality too low
+    DW3000_RX_ERR_OVERRUN,          // RXOVRR: a frame arrived while both RX buffers were full
+    DW3000_RX_ERR_BACKSTOP,         // no event from the chip at all, the sketch gave up waiting
+    DW3000_RX_ERR_COUNT
+};
+
+/*
+ @param status SYS_STATUS (low word)
+ @return A bit (1 << DW3000RxError) for every receive error in it, 0 if there is none
+*/
+inline uint32_t dw3000RxErrors(uint32_t status)
+{
+    static const uint32_t bits[DW3000_RX_ERR_BACKSTOP] = {
+        regs::SYS_STATUS_RXPHE.mask, regs::SYS_STATUS_RXFCE.mask, regs::SYS_STATUS_RXFSL.mask,
+        regs::SYS_STATUS_RXSTO.mask, regs::SYS_STATUS_RXPTO.mask, regs::SYS_STATUS_RXFTO.mask,
+        regs::SYS_STATUS_CIAERR.mask, regs::SYS_STATUS_CPERR.mask, regs::SYS_STATUS_RXOVRR.mask};
+
+    uint32_t errors = 0;
+    for (int i = 0; i < DW3000_RX_ERR_BACKSTOP; i++)
+    {
+        if (status & bits[i])
+        {
+            errors |= 1UL << i;
+        }
+    }
+    return errors;
+}
+
+/*
+ @return Short name of a DW3000RxError, as the command channel prints it
+*/
+inline const char *dw3000RxErrorName(int error)
+{
+    static const char *names[DW3000_RX_ERR_COUNT] = {"phr", "fcs", "rs", "sfd_to", "pre_to", "frame_to", "cia", "sts", "overrun", "backstop"};
+    return error >= 0 && error < DW3000_RX_ERR_COUNT ? names[error] : "?";
+}
+
+/*
+ Outcome of the receives of one stage of one link (an anchor on the tag, a radio on the anchor).
+ Every receive that ended gets added once, with the status the sketch acted on.
+
+    DW3000RxStats stats;
+    if (status = dwm.receivedFrameSucc())
+        stats.add(status, dwm.rxErrors);
+    stats.print(client);  // "receives 1000 good 99.80% failed 0.42/s: fcs 1 pre_to 1"
+*/
+class DW3000RxStats
+{
+public:
+    uint32_t receives = 0;                     // receives that ended, with a frame or without
+    uint32_t good = 0;                         // frames with a good CRC
+    uint32_t errors[DW3000_RX_ERR_COUNT] = {}; // failed receives per reason
+
+    /*
+     @param status Like receivedFrameSucc(): 1 for a frame, 2 for a receiver error, 3 for a timeout
+     @param rxErrors DW3000RxError bits of a failed receive (DWM3000Driver::rxErrors), 0 counts as DW3000_RX_ERR_BACKSTOP
+    */
+    void add(int status, uint32_t rxErrors)
+    {
+        if (this->receives++ == 0)
+        {
+            this->firstMs = millis();
+        }
+        if (status == 1)
+        {
+            this->good++;
+            return;
+        }
+        if (rxErrors == 0)
+        {
+            rxErrors = 1UL << DW3000_RX_ERR_BACKSTOP;
+        }
+        for (int i = 0; i < DW3000_RX_ERR_COUNT; i++)
+        {
+            if (rxErrors & (1UL << i))
+            {
+                this->errors[i]++;
+            }
+        }
+    }
+
+    /*
+     Adds up the counts of another stage or link
+    */
+    void add(const DW3000RxStats &other)
+    {
+        if (this->receives == 0 || (other.receives && (long)(other.firstMs - this->firstMs) < 0))
+        {
+            this->firstMs = other.firstMs;
+        }
+        this->receives += other.receives;
+        this->good += other.good;
+        for (int i = 0; i < DW3000_RX_ERR_COUNT; i++)
+        {
+            this->errors[i] += other.errors[i];
+        }
+    }
+
+    /*
+     @return Share of the receives that failed for a reason, 0 to 1
+    */
+    float rate(int error) const
+    {
+        return this->receives ? (float)this->errors[error] / this->receives : 0;
+    }
+
+    /*
+     @return Failed receives per second since the first receive
+    */
+    float failuresPerSecond() const
+    {
+        unsigned long ms = millis() - this->firstMs;
+        return this->receives && ms ? (this->receives - this->good) * 1000.0f / ms : 0;
+    }
+
+    /*
+     Prints the counts on one line, reasons that never happened are left out
+    */
+    void print(Print &out) const
+    {
+        out.printf("receives %lu good %.2f%% failed %.2f/s:", (unsigned long)this->receives,
+                   this->receives ? 100.0f * this->good / this->receives : 0.0f, failuresPerSecond());
+        for (int i = 0; i < DW3000_RX_ERR_COUNT; i++)
+        {
+            if (this->errors[i])
+            {
+                out.printf(" %s %lu", dw3000RxErrorName(i), (unsigned long)this->errors[i]);
+            }
+        }
+        out.println();
+    }
+
+    void clear()
+    {
+        *this = DW3000RxStats();
+    }
+
+private:
+    unsigned long firstMs = 0; // millis() of the first receive
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "dw3000_transport.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <soc/gpio_reg.h>
+#include <soc/soc_caps.h>
+#endif
+
+/*
+ SPI transport for the DW3000 built on the Arduino SPIClass.
+ CS is driven by software, every transaction is blocking.
+ Each transaction runs inside beginTransaction()/endTransaction() with the clock set through setClock().
+*/
+class DW3000ArduinoSpi : public DW3000Transport
+{
+public:
+    DW3000ArduinoSpi(SPIClass &spi);
+
+    bool begin(uint8_t csPin, uint8_t sckPin, uint8_t misoPin, uint8_t mosiPin) override;
+    void setClock(uint32_t hz) override;
+    void wakeup(uint32_t us) override;
+
+    bool fastChipSelect = true; // toggle CS through the GPIO set/clear registers (ESP32), false uses digitalWrite()
+
+protected:
+    void doTransfer(const uint8_t *header, uint8_t headerLen, const uint8_t *tx, uint8_t *rx, uint16_t len) override;
+
+private:
+    SPIClass &spi;
+    SPISettings settings = SPISettings(DW3000_SPI_SLOW_HZ, MSBFIRST, SPI_MODE0);
+    uint8_t csPin = 0;
+
+    void chipSelect(bool level);
+};
+
+DW3000ArduinoSpi::DW3000ArduinoSpi(SPIClass &spi) : spi(spi)
+{
+}
+
+/*
+ Initializes the SPI interface and deselects the chip
+*/
+bool DW3000ArduinoSpi::begin(uint8_t csPin, uint8_t sckPin, uint8_t misoPin, uint8_t mosiPin)
+{
+    this->csPin = csPin;
+
+    pinMode(csPin, OUTPUT);
+    this->spi.begin(sckPin, misoPin, mosiPin, csPin);
+
+    delay(5);
+
+    digitalWrite(csPin, HIGH);
+    delay(5);
+
+    return true;
+}
+
+/*
+ Sets the SPI clock of the following transactions
+ @param hz The clock in Hz
+*/
+void DW3000ArduinoSpi::setClock(uint32_t hz)
+{
+    this->settings = SPISettings(hz, MSBFIRST, SPI_MODE0);
+}
+
+/*
+ Holds CS low without clocking anything, the chip wakes up on the CS level alone
+ @param us Time CS stays low in microseconds
+*/
+void DW3000ArduinoSpi::wakeup(uint32_t us)
+{
+    chipSelect(LOW);
+    delayMicroseconds(us);
+    chipSelect(HIGH);
+}
+
+/*
+ Clocks the header and all data bytes through SPIClass::transferBytes while CS stays asserted
+*/
+void DW3000ArduinoSpi::doTransfer(const uint8_t *header, uint8_t headerLen, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    this->spi.beginTransaction(this->settings);
+    chipSelect(LOW);
+    this->spi.transferBytes(header, NULL, headerLen);
+    if (len > 0)
+    {
+        this->spi.transferBytes(tx, rx, len);
+    }
+    chipSelect(HIGH);
+    this->spi.endTransaction();
+}
+
+/*
+ Drives the CS line. On the ESP32 a single store to the GPIO set/clear register does this,
+ digitalWrite() goes through the pin lookup of the Arduino HAL first.
+ @param level HIGH to deselect, LOW to select the chip
+*/
+void DW3000ArduinoSpi::chipSelect(bool level)
+{
+#ifdef ARDUINO_ARCH_ESP32
+    if (this->fastChipSelect)
+    {
+#if SOC_GPIO_PIN_COUNT > 32
+        if (this->csPin >= 32)
+        {
+            REG_WRITE(level ? GPIO_OUT1_W1TS_REG : GPIO_OUT1_W1TC_REG, 1UL << (this->csPin - 32));
+            return;
+        }
+#endif
+        REG_WRITE(level ? GPIO_OUT_W1TS_REG : GPIO_OUT_W1TC_REG, 1UL << this->csPin);
+        return;
+    }
+#endif
+    digitalWrite(this->csPin, level);
+}
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <Arduino.h>
+#include <driver/spi_master.h>
+#include <esp_attr.h>
+#include "dw3000_transport.h"
+
+#ifndef DW3000_IDF_SPI_HOST
+#define DW3000_IDF_SPI_HOST SPI3_HOST // VSPI
+#endif
+
+#define DW3000_IDF_QUEUE_SLOTS 8      // number of writes that can be in flight at once
+#define DW3000_IDF_SLOT_SIZE 32       // header + payload bytes a queued write can hold
+#define DW3000_IDF_MAX_TRANSFER 1028  // 2 header bytes + the full 1023 byte frame buffer, rounded up to whole words
+
+/*
+ SPI transport for the DW3000 built on the ESP-IDF spi_master driver.
+ All transfers use DMA and the hardware CS line. Writes can be queued so the CPU does not wait for the bus;
+ a blocking transfer always drains the queue first, so reads see the result of every write that came before them.
+*/
+class DW3000IdfSpi : public DW3000Transport
+{
+public:
+    uint32_t rejected = 0; // transactions longer than DW3000_IDF_MAX_TRANSFER, they never went out on the bus
+
+    DW3000IdfSpi(spi_host_device_t host = DW3000_IDF_SPI_HOST, int clockHz = DW3000_SPI_SLOW_HZ);
+
+    bool begin(uint8_t csPin, uint8_t sckPin, uint8_t misoPin, uint8_t mosiPin) override;
+    void setClock(uint32_t hz) override;
+    void flush() override;
+
+protected:
+    void doTransfer(const uint8_t *header, uint8_t headerLen, const uint8_t *tx, uint8_t *rx, uint16_t len) override;
+    void doQueue(const uint8_t *header, uint8_t headerLen, const uint8_t *tx, uint16_t len) override;
+
+private:
+    spi_host_device_t host;
+    int clockHz;
+    uint8_t csPin = 0;
+    spi_device_handle_t device = NULL;
+
+    spi_transaction_t slots[DW3000_IDF_QUEUE_SLOTS];
+    WORD_ALIGNED_ATTR uint8_t slotBuffers[DW3000_IDF_QUEUE_SLOTS][DW3000_IDF_SLOT_SIZE];
+    int nextSlot = 0;
+    int inFlight = 0;
+
+    WORD_ALIGNED_ATTR uint8_t txBuffer[DW3000_IDF_MAX_TRANSFER];
+    WORD_ALIGNED_ATTR uint8_t rxBuffer[DW3000_IDF_MAX_TRANSFER];
+
+    void waitForOldest();
+    bool addDevice();
+};
+
+/*
+ @param host The SPI peripheral to use (SPI2_HOST = HSPI, SPI3_HOST = VSPI)
+ @param clockHz The SPI clock in Hz
+*/
+DW3000IdfSpi::DW3000IdfSpi(spi_host_device_t host, int clockHz) : host(host), clockHz(clockHz)
+{
+}
+
+/*
+ Initializes the SPI bus with DMA and attaches the DW3000 as a device with hardware CS
+ @return True if the bus and device could be set up
+*/
+bool DW3000IdfSpi::begin(uint8_t csPin, uint8_t sckPin, uint8_t misoPin, uint8_t mosiPin)
+{
+    spi_bus_config_t bus = {};
+    bus.mosi_io_num = mosiPin;
+    bus.miso_io_num = misoPin;
+    bus.sclk_io_num = sckPin;
+    bus.quadwp_io_num = -1;
+    bus.quadhd_io_num = -1;
+    bus.max_transfer_sz = DW3000_IDF_MAX_TRANSFER;
+
+    if (spi_bus_initialize(this->host, &bus, SPI_DMA_CH_AUTO) != ESP_OK)
+    {
+        return false;
+    }
+
+    this->csPin = csPin;
+    return addDevice();
+}
+
+/*
+ Sets the SPI clock of the following transactions. The clock of a spi_master device is fixed,
+ so the device gets removed and added again once the queue is empty.
+ @param hz The clock in Hz
+*/
+void DW3000IdfSpi::setClock(uint32_t hz)
+{
+    if ((int)hz == this->clockHz)
+    {
+        return;
+    }
+    this->clockHz = hz;
+
+    if (this->device != NULL)
+    {
+        flush();
+        spi_bus_remove_device(this->device);
+        this->device = NULL;
+        addDevice();
+    }
+}
+
+/*
+ Performs a blocking transaction after all queued writes have finished.
+ A transaction longer than DW3000_IDF_MAX_TRANSFER is not sent at all: splitting it would restart the register address
+ (and the dummy byte of ACC_MEM) with every part. It gets counted in rejected and a read returns zeros.
+ @param header The header bytes
+ @param headerLen The length of the header in bytes
+ @param tx The bytes that should be written after the header, or NULL when reading
+ @param rx The buffer that receives the bytes clocked in after the header, or NULL when writing
+ @param len The number of data bytes after the header
+*/
+void DW3000IdfSpi::doTransfer(const uint8_t *header, uint8_t headerLen, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    flush();
+
+    if (headerLen + len > DW3000_IDF_MAX_TRANSFER)
+    {
+        this->rejected++;
+        Serial.printf("[ERROR] SPI transaction of %u bytes is longer than DW3000_IDF_MAX_TRANSFER, not sent\n", headerLen + len);
+        if (rx != NULL)
+        {
+            memset(rx, 0, len);
+        }
+        return;
+    }
+
+    memcpy(this->txBuffer, header, headerLen);
+    if (tx != NULL)
+    {
+        memcpy(this->txBuffer + headerLen, tx, len);
+    }
+    else
+    {
+        memset(this->txBuffer + headerLen, 0, len);
+    }
+
+    spi_transaction_t t = {};
+    t.length = (headerLen + len) * 8;
+    t.tx_buffer = this->txBuffer;
+    t.rx_buffer = rx != NULL ? this->rxBuffer : NULL;
+
+    spi_device_polling_transmit(this->device, &t);
+
+    if (rx != NULL)
+    {
+        memcpy(rx, this->rxBuffer + headerLen, len);
+    }
+}
+
+/*
+ Queues a write transaction and returns without waiting for it to go out on the bus.
+ Writes that don't fit into a queue slot are sent as a blocking transfer instead.
+ @param header The header bytes
+ @param headerLen The length of the header in bytes
+ @param tx The bytes that should be written after the header
+ @param len The number of data bytes after the header
+*/
+void DW3000IdfSpi::doQueue(const uint8_t *header, uint8_t headerLen, const uint8_t *tx, uint16_t len)
+{
+    if (headerLen + len > DW3000_IDF_SLOT_SIZE)
+    {
+        doTransfer(header, headerLen, tx, NULL, len);
+        return;
+    }
+
+    if (this->inFlight == DW3000_IDF_QUEUE_SLOTS)
+    {
+        waitForOldest(); // results come back in order, so this frees up nextSlot
+    }
+
+    uint8_t *buf = this->slotBuffers[this->nextSlot];
+    memcpy(buf, header, headerLen);
+    if (len > 0)
+    {
+        memcpy(buf + headerLen, tx, len);
+    }
+
+    spi_transaction_t *t = &this->slots[this->nextSlot];
+    memset(t, 0, sizeof(*t));
+    t->length = (headerLen + len) * 8;
+    t->tx_buffer = buf;
+
+    spi_device_queue_trans(this->device, t, portMAX_DELAY);
+
+    this->nextSlot = (this->nextSlot + 1) % DW3000_IDF_QUEUE_SLOTS;
+    this->inFlight++;
+}
+
+/*
+ Waits until every queued transaction has been sent
+*/
+void DW3000IdfSpi::flush()
+{
+    while (this->inFlight > 0)
+    {
+        waitForOldest();
+    }
+}
+
+/*
+ Attaches the DW3000 to the bus with hardware CS at the current clock
+ @return True if the device could be added
+*/
+bool DW3000IdfSpi::addDevice()
+{
+    spi_device_interface_config_t dev = {};
+    dev.mode = 0;
+    dev.clock_speed_hz = this->clockHz;
+    dev.spics_io_num = this->csPin;
+    dev.queue_size = DW3000_IDF_QUEUE_SLOTS;
+
+    return spi_bus_add_device(this->host, &dev, &this->device) == ESP_OK;
+}
+
+void DW3000IdfSpi::waitForOldest()
+{
+    spi_transaction_t *done;
+    spi_device_get_trans_result(this->device, &done, portMAX_DELAY);
+    this->inFlight--;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "dw3000_api.h"
+
+#ifndef DW3000_TEMP_INTERVAL_MS
+#define DW3000_TEMP_INTERVAL_MS 1000 // time between two SAR temperature measurements
+#endif
+
+/*
+ Samples the chip temperature between exchanges without waiting for the SAR, and recalibrates the chip once it drifted
+ DW3000_RECAL_TEMP_DELTA away from the temperature of its last calibration. Each reading also updates the antenna delay
+ compensation of convertToCM() (DWM3000Driver::temperature).
+
+    DW3000TempMonitor temp;
+    if (temp.service(dwm))  // whenever the radio is between exchanges, costs nothing until a measurement is due
+        dwm.standardRX();   // recalibrate() turned the receiver off
+*/
+class DW3000TempMonitor
+{
+public:
+    int recalibrations = 0; // recalibrate() calls since boot
+
+    /*
+     Starts a measurement when one is due, picks it up once the SAR is done
+     @param dwm The radio
+     @return True if the radio was recalibrated, its receiver and transmitter are off then
+    */
+    template <class Driver>
+    bool service(Driver &dwm)
+    {
+        unsigned long now = millis();
+        if (!this->pending)
+        {
+            if (this->calibrated && now - this->lastStart < DW3000_TEMP_INTERVAL_MS) // the first measurement right away
+            {
+                return false;
+            }
+            dwm.startTemperature();
+            this->pending = true;
+            this->lastStart = now;
+            return false;
+        }
+
+        float celsius;
+        if (!dwm.readTemperature(&celsius))
+        {
+            return false;
+        }
+        this->pending = false;
+
+        if (!this->calibrated)
+        {
+            this->calibratedAt = celsius; // the first reading after init(), which calibrated the chip
+            this->calibrated = true;
+            return false;
+        }
+        if (fabsf(celsius - this->calibratedAt) < DW3000_RECAL_TEMP_DELTA)
+        {
+            return false;
+        }
+
+        dwm.recalibrate();
+        this->calibratedAt = celsius;
+        this->recalibrations++;
+        return true;
+    }
+
+private:
+    bool pending = false;
+    bool calibrated = false;
+    float calibratedAt = 0;
+    unsigned long lastStart = 0;
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <Arduino.h>
+
+#ifndef DW3000_TRACE_DEPTH
+#define DW3000_TRACE_DEPTH 0 // Set to the number of SPI transactions the tracer keeps in RAM (e.g. 256), 0 turns it off
+#endif
+
+#ifndef DW3000_TRACE_DATA_LEN
+#define DW3000_TRACE_DATA_LEN 16 // data bytes kept per transaction, longer transactions are cut
+#endif
+
+#define DW3000_TRACE_READ 0x01   // data was clocked in (otherwise written)
+#define DW3000_TRACE_QUEUED 0x02 // write was queued (beginBatch/endBatch), the duration is the time to queue it
+#define DW3000_TRACE_CRC 0x04    // the transport checked the transaction with the SPI CRC (the duration includes the check)
+
+/*
+ One SPI transaction as seen by the driver
+*/
+struct DW3000TraceRecord
+{
+    uint32_t start;  // cycle counter when the transaction started
+    uint32_t cycles; // duration in CPU cycles
+    uint8_t header[2];
+    uint8_t headerLen;
+    uint8_t flags; // DW3000_TRACE_READ, DW3000_TRACE_QUEUED, DW3000_TRACE_CRC
+    uint16_t len;  // data bytes of the transaction, only the first DW3000_TRACE_DATA_LEN are kept
+    uint8_t data[DW3000_TRACE_DATA_LEN];
+};
+
+/*
+ Ring buffer of the last DW3000_TRACE_DEPTH SPI transactions, with cycle counter timestamps.
+ Recording costs two cycle counter reads and a copy of a few bytes, so unlike DEBUG_OUTPUT it leaves the timing alone.
+
+ dump() prints the records as text, host/sim/trace_replay.cpp replays such a dump against a simulated chip:
+    dw3000 trace <records> <cpu MHz>
+    <start> <cycles> <r|w|q> <header hex> <len> <data hex>
+    ...
+    end
+ R, W and Q instead of r, w and q mark transactions the transport checked with the SPI CRC.
+*/
+class DW3000Trace
+{
+public:
+    uint32_t count = 0; // transactions recorded since the last clear(), the oldest ones are gone once it passes DW3000_TRACE_DEPTH
+
+    /*
+     @return The CPU cycle counter the records are timestamped with
+    */
+    static uint32_t now()
+    {
+        return ESP.getCycleCount();
+    }
+
+    /*
+     Records a transaction that just finished
+     @param start now() before the transaction
+     @param header The header bytes
+     @param headerLen The length of the header in bytes
+     @param data The bytes that were written or read
+     @param len The number of data bytes
+     @param flags DW3000_TRACE_READ, DW3000_TRACE_QUEUED, DW3000_TRACE_CRC
+    */
+    void record(uint32_t start, const uint8_t *header, uint8_t headerLen, const uint8_t *data, uint16_t len, uint8_t flags)
+    {
+        if (!DW3000_TRACE_DEPTH)
+        {
+            return;
+        }
+
+        DW3000TraceRecord &rec = this->records[this->count % size];
+        rec.start = start;
+        rec.cycles = now() - start;
+        rec.header[0] = header[0];
+        rec.header[1] = headerLen > 1 ? header[1] : 0;
+        rec.headerLen = headerLen;
+        rec.flags = flags;
+        rec.len = len;
+        if (data != NULL)
+        {
+            memcpy(rec.data, data, len < DW3000_TRACE_DATA_LEN ? len : DW3000_TRACE_DATA_LEN);
+        }
+        this->count++;
+    }
+
+    void clear()
+    {
+        this->count = 0;
+    }
+
+    /*
+     Prints the recorded transactions, oldest first
+     @param out Where the dump goes (Serial, the WiFiClient of the command channel)
+    */
+    void dump(Print &out)
+    {
+        uint32_t n = this->count < DW3000_TRACE_DEPTH ? this->count : DW3000_TRACE_DEPTH;
+        out.printf("dw3000 trace %u %u\n", (unsigned int)n, (unsigned int)ESP.getCpuFreqMHz());
+
+        for (uint32_t i = this->count - n; i != this->count; i++)
+        {
+            const DW3000TraceRecord &rec = this->records[i % size];
+            char line[48 + 2 * DW3000_TRACE_DATA_LEN];
+            char kind = rec.flags & DW3000_TRACE_READ ? 'r' : (rec.flags & DW3000_TRACE_QUEUED ? 'q' : 'w');
+            if (rec.flags & DW3000_TRACE_CRC)
+            {
+                kind += 'A' - 'a';
+            }
+            int pos = snprintf(line, sizeof(line), "%u %u %c %02x", (unsigned int)rec.start, (unsigned int)rec.cycles, kind, rec.header[0]);
+            if (rec.headerLen > 1)
+            {
+                pos += snprintf(line + pos, sizeof(line) - pos, "%02x", rec.header[1]);
+            }
+            pos += snprintf(line + pos, sizeof(line) - pos, " %u ", rec.len);
+            for (int j = 0; j < rec.len && j < DW3000_TRACE_DATA_LEN; j++)
+            {
+                pos += snprintf(line + pos, sizeof(line) - pos, "%02x", rec.data[j]);
+            }
+            out.println(line);
+        }
+        out.println("end");
+    }
+
+private:
+    static constexpr uint32_t size = DW3000_TRACE_DEPTH > 0 ? DW3000_TRACE_DEPTH : 1;
+    DW3000TraceRecord records[size];
+};
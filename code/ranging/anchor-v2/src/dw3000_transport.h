@@ -0,0 +1,327 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "dw3000_regs.h"
+
+#ifndef DW3000_SPI_SLOW_HZ
+#define DW3000_SPI_SLOW_HZ 7000000 // the DW3000 accepts at most 7MHz before its PLL is locked
+#endif
+
+#ifndef DW3000_SPI_FAST_HZ
+#define DW3000_SPI_FAST_HZ 36000000 // up to 38MHz once the PLL is locked; the ESP32 rounds down to a divider of its 80MHz APB clock
+#endif
+
+#define DW3000_SPI_CRC_OFF 0
+#define DW3000_SPI_CRC_WRITE 1      // writes carry a CRC the chip checks (SYS_STATUS SPICRCE), corrupted or lost writes get repeated
+#define DW3000_SPI_CRC_READ_WRITE 2 // reads are also checked against the CRC the chip computed (SPI_RD_CRC) and repeated
+
+#ifndef DW3000_SPI_CRC_RETRIES
+#define DW3000_SPI_CRC_RETRIES 3 // repetitions of a transaction that failed its CRC check before it counts as a failure
+#endif
+
+#ifndef DW3000_SPI_CRC_MAX_LEN
+#define DW3000_SPI_CRC_MAX_LEN 64 // longest write in CRC mode (data + CRC byte), the driver writes at most 12 bytes at once
+#endif
+
+/*
+ Interface between DWM3000Class and the bus the chip is attached to.
+ A transaction is one CS assertion: a 1 or 2 byte header followed by len data bytes that are either written (tx) or read back (rx).
+
+ Implementations:
+    * DW3000ArduinoSpi - SPIClass (dw3000_spi_arduino.h)
+    * DW3000IdfSpi - ESP-IDF spi_master driver with DMA and queued writes (dw3000_spi_idf.h)
+    * SimTransport - simulated DW3000 of the host build (host/sim/dw3000_sim.h)
+
+ Every transaction is counted, so changes to the driver can be compared by their bus usage.
+
+ SPI CRC (crcMode, set by DWM3000Class::enableSpiCrc()): the transport appends the CRC byte to every write and checks
+ SYS_STATUS SPICRCE after it, in DW3000_SPI_CRC_READ_WRITE mode it also compares every read with SPI_RD_CRC.
+ Transactions that fail the check are repeated, so a corrupted config write can not silently misconfigure the chip.
+ A write whose header lost its write bit reaches the chip as a read, which the chip does not flag but answers with a new
+ SPI_RD_CRC: after every write the transport reads SPI_RD_CRC, then SYS_STATUS, then SPI_RD_CRC again to check the SYS_STATUS read.
+ Checked transactions always use the 2 byte header, in a 1 byte one a single flipped bit turns them into a fast command.
+ Fast commands are not checked. Reads cost one extra 1 byte read, writes three. Queued writes are sent and checked right away, so in CRC mode
+ the batches of DWM3000Class::beginBatch()/endBatch() save nothing.
+*/
+class DW3000Transport
+{
+public:
+    uint32_t transactions = 0; // transactions since the last resetCounters()
+    uint32_t bytes = 0;        // header + data bytes since the last resetCounters()
+
+    uint8_t crcMode = DW3000_SPI_CRC_OFF; // has to match SYS_CFG SPI_CRC of the chip, so only the driver changes it
+    uint32_t crcErrors = 0;               // transactions that failed the CRC check, every attempt counts
+    uint32_t crcFailures = 0;             // transactions that still failed after DW3000_SPI_CRC_RETRIES repetitions
+
+    virtual ~DW3000Transport() {}
+
+    /*
+     Sets up the bus
+     @return True if the bus is ready
+    */
+    virtual bool begin(uint8_t csPin, uint8_t sckPin, uint8_t misoPin, uint8_t mosiPin) { return true; }
+
+    /*
+     Sets the SPI clock of the following transactions. Transports start out at DW3000_SPI_SLOW_HZ.
+     @param hz The clock in Hz, the transport may round it down to what the hardware can do
+    */
+    virtual void setClock(uint32_t hz) {}
+
+    /*
+     Performs a blocking transaction
+     @param header The header bytes
+     @param headerLen The length of the header in bytes
+     @param tx The bytes that should be written after the header, or NULL when reading
+     @param rx The buffer that receives the bytes clocked in after the header, or NULL when writing
+     @param len The number of data bytes after the header
+    */
+    void transfer(const uint8_t *header, uint8_t headerLen, const uint8_t *tx, uint8_t *rx, uint16_t len)
+    {
+        count(headerLen, len);
+
+        if (this->crcMode == DW3000_SPI_CRC_OFF || len == 0 || isFastCommand(header))
+        {
+            doTransfer(header, headerLen, tx, rx, len);
+            if (rx != NULL && len > 0)
+            {
+                this->lastReadCrc = crc8(rx, len, crc8(header, headerLen));
+            }
+        }
+        else if (tx != NULL)
+        {
+            uint8_t full[2];
+            crcWrite(fullHeader(header, headerLen, full), 2, tx, len);
+        }
+        else if (this->crcMode == DW3000_SPI_CRC_READ_WRITE)
+        {
+            uint8_t full[2];
+            crcRead(fullHeader(header, headerLen, full), 2, rx, len);
+        }
+        else
+        {
+            doTransfer(header, headerLen, tx, rx, len);
+            this->lastReadCrc = crc8(rx, len, crc8(header, headerLen)); // unchecked, a corrupted read costs one repeated write
+        }
+    }
+
+    /*
+     Queues a write. Transports without a queue perform it right away.
+     A later transfer() always sees the result of every queued write.
+    */
+    void queue(const uint8_t *header, uint8_t headerLen, const uint8_t *tx, uint16_t len)
+    {
+        if (this->crcMode != DW3000_SPI_CRC_OFF)
+        {
+            transfer(header, headerLen, tx, NULL, len); // the CRC check has to see the result before the next write
+            return;
+        }
+
+        count(headerLen, len);
+        doQueue(header, headerLen, tx, len);
+    }
+
+    /*
+     Waits until every queued write has been sent
+    */
+    virtual void flush() {}
+
+    /*
+     Wakes the chip from SLEEP or DEEPSLEEP (AON_CFG WAKE_CSN) by holding CS low. By default that is a read of DEV_ID
+     long enough at DW3000_SPI_SLOW_HZ, without a CRC check: the chip does not answer before it is awake.
+     Transports that drive CS themselves just hold it.
+     @param us Time CS stays low in microseconds
+    */
+    virtual void wakeup(uint32_t us)
+    {
+        static const uint8_t header[1] = {0x00};
+        uint16_t len = (uint64_t)us * DW3000_SPI_SLOW_HZ / 8000000 + 1;
+        count(1, len);
+        doTransfer(header, 1, NULL, NULL, len);
+        this->lastReadCrcKnown = false;
+    }
+
+    void resetCounters()
+    {
+        this->transactions = 0;
+        this->bytes = 0;
+        this->crcErrors = 0;
+        this->crcFailures = 0;
+    }
+
+    /*
+     CRC-8 of the DW3000 SPI (polynomial x^8 + x^2 + x + 1, initial value 0)
+     @param data The bytes
+     @param len The number of bytes
+     @param crc The CRC of the bytes before, to continue it
+    */
+    static uint8_t crc8(const uint8_t *data, uint16_t len, uint8_t crc = 0)
+    {
+        for (uint16_t i = 0; i < len; i++)
+        {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; bit++)
+            {
+                crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+            }
+        }
+        return crc;
+    }
+
+protected:
+    virtual void doTransfer(const uint8_t *header, uint8_t headerLen, const uint8_t *tx, uint8_t *rx, uint16_t len) = 0;
+
+    virtual void doQueue(const uint8_t *header, uint8_t headerLen, const uint8_t *tx, uint16_t len)
+    {
+        doTransfer(header, headerLen, tx, NULL, len);
+    }
+
+private:
+    uint8_t crcBuffer[DW3000_SPI_CRC_MAX_LEN];
+    uint8_t lastReadCrc = 0;      // SPI_RD_CRC as the chip should hold it: the CRC of the last read it answered
+    bool lastReadCrcKnown = false; // false until read from the chip, and after wakeups
+
+    void count(uint8_t headerLen, uint16_t len)
+    {
+        this->transactions++;
+        this->bytes += headerLen + len;
+    }
+
+    static bool isFastCommand(const uint8_t *header)
+    {
+        return !(header[0] & 0x40) && (header[0] & 0x01);
+    }
+
+    /*
+     Turns a 1 byte header into the 2 byte one of the same register (sub address 0). A single flipped bit turns a 1 byte
+     header into a fast command the chip executes, with the transaction lost, in a 2 byte header that takes two.
+     @param full Receives the 2 byte header if header is a 1 byte one
+     @return The 2 byte header
+    */
+    const uint8_t *fullHeader(const uint8_t *header, uint8_t headerLen, uint8_t *full)
+    {
+        if (headerLen == 2)
+        {
+            return header;
+        }
+        full[0] = header[0] | 0x40;
+        full[1] = 0;
+        this->bytes++;
+        return full;
+    }
+
+    /*
+     Writes with the CRC appended until the chip accepts the CRC
+    */
+    void crcWrite(const uint8_t *header, uint8_t headerLen, const uint8_t *tx, uint16_t len)
+    {
+        if (len + 1 > DW3000_SPI_CRC_MAX_LEN)
+        {
+            this->crcFailures++; // can not be protected, the chip is going to flag it
+            doTransfer(header, headerLen, tx, NULL, len);
+            return;
+        }
+
+        memcpy(this->crcBuffer, tx, len);
+        this->crcBuffer[len] = crc8(tx, len, crc8(header, headerLen));
+
+        if (!this->lastReadCrcKnown)
+        {
+            this->lastReadCrc = readRdCrc();
+            this->lastReadCrcKnown = true;
+        }
+
+        for (int attempt = 0;; attempt++)
+        {
+            doTransfer(header, headerLen, this->crcBuffer, NULL, len + 1);
+            this->bytes++;
+            if (!writeLost() && !takeWriteCrcError())
+            {
+                return;
+            }
+            this->crcErrors++;
+            if (attempt == DW3000_SPI_CRC_RETRIES)
+            {
+                this->crcFailures++;
+                return;
+            }
+            count(headerLen, len + 1);
+        }
+    }
+
+    /*
+     Reads SPI_RD_CRC, which a read of SPI_RD_CRC itself leaves as it is
+    */
+    uint8_t readRdCrc()
+    {
+        uint8_t crc = 0;
+        count(regs::SPICRC_CFG.headerLen, 1);
+        doTransfer(regs::SPICRC_CFG.readHeader, regs::SPICRC_CFG.headerLen, NULL, &crc, 1);
+        return crc;
+    }
+
+    /*
+     Checks whether the last write reached the chip as a read (a flipped write bit in its header)
+     @return True if SPI_RD_CRC changed since the last read the transport made
+    */
+    bool writeLost()
+    {
+        uint8_t crc = readRdCrc();
+        if (crc == this->lastReadCrc)
+        {
+            return false;
+        }
+        this->lastReadCrc = crc;
+        return true;
+    }
+
+    /*
+     Checks SYS_STATUS SPICRCE and clears it. The SYS_STATUS read is checked against SPI_RD_CRC, a corrupted one counts as an error.
+     @return True if the chip saw a write with a wrong CRC since the last check, or the check itself was corrupted
+    */
+    bool takeWriteCrcError()
+    {
+        uint8_t status = 0;
+        count(regs::SYS_STATUS.headerLen, 1);
+        doTransfer(regs::SYS_STATUS.readHeader, regs::SYS_STATUS.headerLen, NULL, &status, 1);
+        this->lastReadCrc = readRdCrc();
+        if (this->lastReadCrc == crc8(&status, 1, crc8(regs::SYS_STATUS.readHeader, regs::SYS_STATUS.headerLen)) &&
+            !(status & regs::SYS_STATUS_SPICRCE.mask))
+        {
+            return false;
+        }
+
+        uint8_t clear[2] = {(uint8_t)regs::SYS_STATUS_SPICRCE.mask, 0};
+        clear[1] = crc8(clear, 1, crc8(regs::SYS_STATUS.writeHeader, regs::SYS_STATUS.headerLen));
+        count(regs::SYS_STATUS.headerLen, 2);
+        doTransfer(regs::SYS_STATUS.writeHeader, regs::SYS_STATUS.headerLen, clear, NULL, 2);
+        return true;
+    }
+
+    /*
+     Reads until the CRC of the received bytes matches the one the chip computed while sending them
+    */
+    void crcRead(const uint8_t *header, uint8_t headerLen, uint8_t *rx, uint16_t len)
+    {
+        for (int attempt = 0;; attempt++)
+        {
+            doTransfer(header, headerLen, NULL, rx, len);
+
+            uint8_t chipCrc = readRdCrc();
+            this->lastReadCrc = chipCrc;
+            if (chipCrc == crc8(rx, len, crc8(header, headerLen)))
+            {
+                return;
+            }
+            this->crcErrors++;
+            if (attempt == DW3000_SPI_CRC_RETRIES)
+            {
+                this->crcFailures++;
+                return;
+            }
+            count(headerLen, len);
+        }
+    }
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "dw3000_api.h"
+
+#ifndef DW3000_XTAL_WINDOW
+#define DW3000_XTAL_WINDOW 64 // clock offset measurements averaged per trim decision
+#endif
+
+#ifndef DW3000_XTAL_DEADBAND_PPM
+#define DW3000_XTAL_DEADBAND_PPM 0.5f // averaged offsets below this leave the trim alone (a trim step is ~0.8 ppm)
+#endif
+
+#ifndef DW3000_XTAL_SETTLED_WINDOWS
+#define DW3000_XTAL_SETTLED_WINDOWS 3 // windows in a row inside the deadband until the trim counts as converged
+#endif
+
+/*
+ Closed loop crystal trim: pulls the local crystal towards a reference clock from the carrier offset the receiver measures
+ on its frames (getClockOffset()). The reference is the remote side, so only one end of a link runs the loop (the tag,
+ the anchors stay on their OTP trim). Every DW3000_XTAL_WINDOW measurements the mean offset is turned into a trim step,
+ a proportional one, so a crystal that is off by a few ppm settles after one or two windows.
+
+    DW3000XtalTrimLoop xtal;
+    xtal.begin(dwm.xtalTrim);                              // after init()
+    if (xtal.add(dwm.getClockOffset(raw) * 1000000))       // on every received frame
+        dwm.setXtalTrim(xtal.trim());
+*/
+class DW3000XtalTrimLoop
+{
+public:
+    /*
+     Starts the loop from the trim the radio runs with
+     @param trim DWM3000Driver::xtalTrim after init()
+    */
+    void begin(uint8_t trim)
+    {
+        this->current = trim;
+        this->sum = 0;
+        this->count = 0;
+        this->settled = 0;
+        this->lastOffset = 0;
+    }
+
+    /*
+     Adds a measurement
+     @param offsetPpm Clock offset of the remote clock against the local one in ppm (getClockOffset() * 1e6)
+     @return True if the trim changed, the caller writes trim() to the radio
+    */
+    bool add(float offsetPpm)
+    {
+        this->sum += offsetPpm;
+        if (++this->count < DW3000_XTAL_WINDOW)
+        {
+            return false;
+        }
+
+        this->lastOffset = this->sum / this->count;
+        this->sum = 0;
+        this->count = 0;
+
+        // the local crystal runs fast by -lastOffset, a higher trim slows it down
+        float error = -this->lastOffset;
+        if (fabsf(error) < DW3000_XTAL_DEADBAND_PPM)
+        {
+            if (this->settled < DW3000_XTAL_SETTLED_WINDOWS)
+            {
+                this->settled++;
+            }
+            return false;
+        }
+
+        int step = lroundf(error / DW3000_XTAL_TRIM_PPM_PER_STEP);
+        if (step == 0)
+        {
+            step = error > 0 ? 1 : -1;
+        }
+        int next = (int)this->current + step;
+        next = next < 0 ? 0 : (next > DW3000_XTAL_TRIM_MAX ? DW3000_XTAL_TRIM_MAX : next);
+        this->settled = 0;
+        if (next == this->current)
+        {
+            return false; // at the end of the range
+        }
+        this->current = next;
+        return true;
+    }
+
+    /*
+     @return The trim the loop wants
+    */
+    uint8_t trim() const
+    {
+        return this->current;
+    }
+
+    /*
+     @return True once the offset stayed inside the deadband for DW3000_XTAL_SETTLED_WINDOWS windows, the trim is worth storing
+    */
+    bool converged() const
+    {
+        return this->settled >= DW3000_XTAL_SETTLED_WINDOWS;
+    }
+
+    /*
+     @return Mean clock offset of the last full window in ppm (remote against local)
+    */
+    float offsetPpm() const
+    {
+        return this->lastOffset;
+    }
+
+private:
+    uint8_t current = DW3000_XTAL_TRIM_DEFAULT;
+    float sum = 0;
+    int count = 0;
+    int settled = 0;
+    float lastOffset = 0;
+};
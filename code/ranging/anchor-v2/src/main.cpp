@@ -1,3 +1,4 @@
 // #include "anchor.h"
+// #include "spi_bench.h"
 
 #include "tag.h"
\ No newline at end of file
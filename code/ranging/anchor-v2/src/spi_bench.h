@@ -0,0 +1,108 @@
+#include <Arduino.h>
+#include <SPI.h>
+
+#include "dw3000_registers.h"
+#include "dw3000_api.h"
+#include "dw3000_config.h"
+
+/*
+ SPI microbenchmark: measures what single register accesses and a RX buffer burst cost
+ with the old bus setup (digitalWrite() CS, SPIClass default clock) and with the clock profiles of the driver.
+ Include this instead of tag.h / anchor.h in main.cpp and watch the serial monitor.
+*/
+
+#define HSPI 2 // 2 for S2 and S3, 1 for S1
+#define VSPI 3
+
+#define BENCH_ITERATIONS 1000
+#define BENCH_BURST_LEN 128
+
+SPIClass vspi = SPIClass(VSPI);
+#if DW3000_USE_IDF_SPI
+DW3000IdfSpi vspiTransport(SPI3_HOST);
+#else
+DW3000ArduinoSpi vspiTransport(vspi);
+#endif
+
+DWM3000<DW3000BoardEsp32Wroom, DW3000PhyCh5Short>::Config config = {
+    &vspiTransport, // Use VSPI
+    16350           // Antenna Delay
+};
+
+DWM3000<DW3000BoardEsp32Wroom, DW3000PhyCh5Short> dwm(config);
+
+/*
+ Runs the accesses of one profile and prints the time per access in microseconds
+ @param name Name of the profile
+ @param clockHz The SPI clock
+ @param fastChipSelect True to toggle CS through the GPIO registers (only has an effect with DW3000ArduinoSpi)
+*/
+void benchProfile(const char *name, uint32_t clockHz, bool fastChipSelect)
+{
+    uint8_t burst[BENCH_BURST_LEN];
+
+#if !DW3000_USE_IDF_SPI
+    vspiTransport.fastChipSelect = fastChipSelect;
+#endif
+    vspiTransport.setClock(clockHz);
+
+    unsigned long start = micros();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        dwm.read(regs::DEV_ID); // 1 byte header
+    }
+    float shortRead = (micros() - start) / (float)BENCH_ITERATIONS;
+
+    start = micros();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        dwm.read(regs::SYS_STATUS); // 2 byte header
+    }
+    float fullRead = (micros() - start) / (float)BENCH_ITERATIONS;
+
+    start = micros();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        dwm.write(regs::TX_ANTD, 16350);
+    }
+    float write = (micros() - start) / (float)BENCH_ITERATIONS;
+
+    start = micros();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        dwm.readBytes(regs::RX_BUFFER_0, burst, sizeof(burst));
+    }
+    float burstRead = (micros() - start) / (float)BENCH_ITERATIONS;
+
+    Serial.printf("%-24s %9u Hz  read DEV_ID %6.2f us  read SYS_STATUS %6.2f us  write TX_ANTD %6.2f us  read %d RX bytes %7.2f us\n",
+                  name, clockHz, shortRead, fullRead, write, BENCH_BURST_LEN, burstRead);
+}
+
+void setup()
+{
+    Serial.begin(115200);
+
+    dwm.begin();
+    dwm.hardReset();
+    delay(200);
+
+    if (!dwm.checkSPI())
+    {
+        Serial.println("[ERROR] Could not establish SPI Connection to DWM3000!");
+        while (1)
+            ;
+    }
+
+    dwm.softReset();
+    delay(200);
+    dwm.init(); // leaves the PLL locked, so the fast profile can be used
+
+    Serial.println("[INFO] SPI benchmark, time per access:");
+    benchProfile("before (digitalWrite CS)", 1000000, false);
+    benchProfile("slow profile", DW3000_SPI_SLOW_HZ, true);
+    benchProfile("fast profile", DW3000_SPI_FAST_HZ, true);
+}
+
+void loop()
+{
+}
@@ -3,37 +3,103 @@
 #include <WiFi.h>
 #include <WiFiClient.h>
 
+#ifdef ARDUINO_ARCH_ESP32
+#include <esp_sleep.h>
+#endif
+
+#define DW3000_SHADOW_REGISTERS 1
+#ifndef DW3000_FAST_BOOT
+#define DW3000_FAST_BOOT 1 // poll the chip out of its resets and keep the OTP calibration in NVS
+#endif
+#ifndef DW3000_SPI_CRC
+#define DW3000_SPI_CRC DW3000_SPI_CRC_OFF // DW3000_SPI_CRC_READ_WRITE repeats corrupted and lost transactions, at 3 extra reads per write
+#endif
+#ifndef DW3000_TRACE_DEPTH
+#define DW3000_TRACE_DEPTH 256 // SPI transactions kept for the "trace" command
+#endif
+#ifndef DW3000_TEMP_INTERVAL_MS
+#define DW3000_TEMP_INTERVAL_MS 100 // the tag converts the distances, a temperature step shows up in them until its next sample
+#endif
+
 #include "dw3000_registers.h"
-#include "regids_dw3000_api.h"
+#include "dw3000_api.h"
+#include "dw3000_config.h"
+#include "dw3000_nvs.h"
+#include "dw3000_xtal.h"
+#include "dw3000_temp.h"
 
 #define HSPI 2  // 2 for S2 and S3, 1 for S1
 #define VSPI 3
 
-// replace with the pins you want to use
-
-//ESP32 WROOM
-const int HSPI_MISO = 19;
-const int HSPI_MOSI = 23;
-const int HSPI_SCLK = 18;
-const int HSPI_SS = 4;
-
-const int VSPI_MISO = 19;
-const int VSPI_MOSI = 23;
-const int VSPI_SCLK = 18;
-const int VSPI_SS = 4;
-#define CHIP_SELECT_PIN 4 // ESP32 WROOM
-
-//WT32-ETH01
-// const int HSPI_MISO = 15;
-// const int HSPI_MOSI = 12;
-// const int HSPI_SCLK = 14;
-// const int HSPI_SS = 5;
+#ifndef RANGING_CHANNEL
+#define RANGING_CHANNEL 5 // 5 or 9, the same on the tag and all anchors
+#endif
+#ifndef RANGING_PROFILE
+#define RANGING_PROFILE DW3000PhyLongRange // PHY profile (dw3000_config.h), the same on the tag and all anchors: DW3000PhyLongRange or DW3000PhyFast
+#endif
+#ifndef RANGING_ADAPTIVE_PHY
+#define RANGING_ADAPTIVE_PHY 1 // switch each anchor link between the DW3000PhyProfiles by its first path level, links start on the long range profile
+#endif
+
+// response window (setResponseWindow()): the radio gives up on an answer that did not start within it
+#define RESPONSE_TURNAROUND_MIN_US 20   // an anchor answers no sooner than this after the end of a frame, the receiver turns on then (30 µs polled without SPI CRC)
+#define RESPONSE_TURNAROUND_MAX_US 5000 // nor later: one loop of the anchor board, whose other radio may be sending a long range frame
+#define RESPONSE_MAX_LEN 12             // longest answer: the round trip information of ds_sendRTInfo()
+#define RESPONSE_BACKSTOP_MS 50         // gives up in software if the radio does not (window plus airtime of a long range answer: ~10 ms)
+
+// first path levels (dBm) of the adaptive PHY, per profile index: a link moves up after PHY_UPGRADE_RANGES ranges above the upgrade level
+// of the next profile and falls back at once below the downgrade level of its own. The gap between the two is the hysteresis.
+#define PHY_UPGRADE_LEVELS {0, -92, -86}
+#define PHY_DOWNGRADE_LEVELS {0, -96, -91}
+#define PHY_UPGRADE_RANGES 5
+#define PHY_SWITCH_GUARD_MS 2     // pause after a switch: the anchor board reconfigures the radio and only then listens again with all of its radios
+
+// cell wide switches ("profile" command): the tag announces the new channel and profile to every anchor, all of them switch at the start of an epoch
+#define PROFILE_EPOCH_MS 100        // length of an epoch, counted on the clock of the tag since boot
+#define PROFILE_SWITCH_QUIET_MS 20  // no exchange starts this close before the switch, so none is cut in half
+#define PROFILE_SWITCH_SETTLE_MS 10 // pause after the switch: the anchors got the delay a frame later and lock their PLL on a new channel
+#ifndef RANGING_TX_POWER_CONTROL
+#define RANGING_TX_POWER_CONTROL 1 // lower the TX power of both ends of a strong link, negotiated together with the adaptive PHY
+#endif
+#define TX_POWER_TARGET_LEVEL -76 // first path level (dBm) strong links get lowered to, 10 dB above the upgrade level of the fastest profile
+#define TX_POWER_HYSTERESIS_DB 3  // change the power of a link only for a difference of at least this much
+#ifndef RANGING_XTAL_TRIM
+#define RANGING_XTAL_TRIM 1 // trim the crystal towards the anchors from the clock offset of their frames, the converged trim is kept in NVS
+#endif
+#ifndef RANGING_TEMP_MONITOR
+#define RANGING_TEMP_MONITOR 1 // sample the chip temperature between exchanges: antenna delay compensation in convertToCM(), recalibration on drift
+#endif
+#ifndef RANGING_DUTY_CYCLE_MS
+#define RANGING_DUTY_CYCLE_MS 0 // one round with every anchor per period, the radio in DEEPSLEEP and the ESP32 in light sleep in between; 0 never sleeps
+#endif
+#define SLEEP_MIN_MS 3 // shorter waits for the next slot are spent awake, the wakeup alone takes ~1.5 ms
+#define RADIO_IDLE_RETRIES 3 // startRadio() gives up after this many checks for IDLE a second apart
+
+#ifndef RANGING_IRQ
+#define RANGING_IRQ 0 // Set to 1 when the IRQ pin of the DWM3000 is wired to TagBoard::irqPin: the loop sleeps until the radio has news instead of polling SYS_STATUS
+#endif
+
+#define CIR_COMMAND_MAX_SAMPLES 64 // accumulator samples one "cir" command sends at most (stack buffer of 6 bytes each)
+
+// select the board the DWM3000 is wired to
+#define BOARD_ESP32_WROOM_DEVBOARD
+// #define BOARD_ESP32_WT32_ETH01
+
+#ifdef BOARD_ESP32_WT32_ETH01
+struct TagBoard : DW3000BoardWt32Eth01
+#else
+struct TagBoard : DW3000BoardEsp32Wroom
+#endif
+{
+    static constexpr uint8_t rstPin = 17;
+};
 
-// const int VSPI_MISO = 15;
-// const int VSPI_MOSI = 12;
-// const int VSPI_SCLK = 14;
-// const int VSPI_SS = 5;
-// #define CHIP_SELECT_PIN 5 // WT32-ETH01
+// same PHY as the anchors
+#if RANGING_ADAPTIVE_PHY
+typedef DW3000PhyLongRange<RANGING_CHANNEL == 9 ? CHANNEL_9 : CHANNEL_5> TagPhy;
+#else
+typedef RANGING_PROFILE<RANGING_CHANNEL == 9 ? CHANNEL_9 : CHANNEL_5> TagPhy;
+#endif
 
 // WiFi Configuration
 #include "wificonfig.h"
@@ -43,11 +109,10 @@ const int port = 7007;             // Choose a port number
 WiFiClient client;
 bool wifiConnected = false;
 
-// SPI Setup
-#define RST_PIN 17
-
 // Scalable Anchor Configuration
+#ifndef NUM_ANCHORS
 #define NUM_ANCHORS 1 // Change this to scale the system
+#endif
 #define TAG_ID 10
 #define FIRST_ANCHOR_ID 1 // Starting ID for anchors (1, 2, 3, ...)
 
@@ -136,32 +201,59 @@ int sender = 0x0;
 #define OTP_CFG 0x08
 
 SPIClass vspi = SPIClass(VSPI);
-
-// Initial Radio Configuration
-DWM3000Class::Config config = {
-    vspi,               // Use VSPI
-    CHIP_SELECT_PIN,   // CS Pin
-    RST_PIN,           // RST Pin
-    VSPI_MOSI,         // MOSI Pin
-    VSPI_MISO,         // MISO Pin
-    VSPI_SCLK,         // SCK Pin
-    ANTENNA_DELAY,     // Antenna Delay
-    CHANNEL_5,         // Channel
-    PREAMBLE_4096,     // Preamble Length
-    9,                 // Preamble Code (Same for RX and TX!)
-    PAC16,              // PAC
-    DATARATE_850KB,    // Datarate
-    PHR_MODE_STANDARD, // PHR Mode
-    PHR_RATE_850KB     // PHR Rate
+#if DW3000_USE_IDF_SPI
+DW3000IdfSpi vspiTransport(SPI3_HOST);
+#else
+DW3000ArduinoSpi vspiTransport(vspi);
+#endif
+
+// Initial Radio Configuration, pins are fixed by TagBoard, the radio settings start as TagPhy and follow the anchor links
+DWM3000Switchable<TagBoard, TagPhy>::Config config = {
+    &vspiTransport, // Use VSPI
+    ANTENNA_DELAY   // Antenna Delay
 };
 
-DWM3000Class dwm(config);
+DWM3000Switchable<TagBoard, TagPhy> dwm(config);
+DW3000CalibrationStore calibrationStore("tag");
+DW3000XtalTrimLoop xtal;
+DW3000TempMonitor temperature;
+DW3000Irq irq;
 
 // Global variables
 static int rx_status;
-static int tx_status;
 static int current_anchor_index = 0; // Index into anchors array
 static int curr_stage = 0;
+unsigned long sentmillis = 0;            // millis() the frame the tag waits for an answer to went out
+static unsigned long first_range_ms = 0; // millis() (= time since boot) when the first range was done
+static int phy_level = dw3000PhyProfileIndex<TagPhy>(); // profile index (DW3000PhyProfiles of the cell channel) the radio is set to
+static int phy_switches = 0;             // confirmed PHY switches since boot
+static int tx_backoff = 0;               // fine TX power steps below the maximum the radio is set to
+static int tx_power_changes = 0;         // confirmed TX power changes since boot
+static bool xtal_stored = false;         // the converged crystal trim is in NVS
+static bool irq_events = RANGING_IRQ;    // wait for frames on the IRQ line, set before setup()
+
+// Settings of the cell: the tag and its anchors
+struct CellProfile
+{
+    uint8_t channel; // CHANNEL_5 or CHANNEL_9
+    int profile;     // index into DW3000PhyProfiles, the profile every link starts on and falls back to
+};
+static CellProfile cell = {TagPhy::channel, dw3000PhyProfileIndex<TagPhy>()};
+static CellProfile cell_next = cell;        // settings of a scheduled switch
+static CellProfile cell_prev = cell;        // settings before the last switch, anchors that missed it are told there
+static unsigned long cell_switch_epoch = 0; // epoch of the scheduled switch, 0 if none is
+static int cell_switches = 0;               // cell wide switches since boot
+
+// Duty cycling, keep the period below ANCHOR_PHY_FALLBACK_MS or the links start over on the cell profile every slot
+static unsigned long duty_cycle_ms = RANGING_DUTY_CYCLE_MS; // period of a slot, the "sleep" command changes it
+static unsigned long next_slot_ms = 0;                      // millis() the next slot starts at, 0 before the first one
+static unsigned long wake_start_us = 0;                     // micros() the radio was woken at, 0 once the first frame after it went out
+static unsigned long wake_latency_us = 0;                   // wakeup to first frame of the last slot
+static unsigned long wake_latency_max_us = 0;
+static unsigned long wakeups = 0;  // wakeups of the radio since boot
+static unsigned long slept_ms = 0; // time the radio spent in DEEPSLEEP since boot
+
+#define TAG_STAGES 9 // stages of the state machine in loop(), 0 to 8
 
 // Anchor data structure
 struct AnchorData
@@ -184,6 +276,22 @@ struct AnchorData
     // Signal quality metrics
     float signal_strength = 0;    // RSSI in dBm
     float fp_signal_strength = 0; // First Path RSSI in dBm
+
+    // Adaptive PHY
+    int phy_level = 0;  // profile index (DW3000PhyProfiles of the cell channel) the link uses
+    int phy_wanted = 0; // profile index the link is negotiating
+    int phy_good = 0;   // ranges in a row good enough for the next profile
+
+    // TX power control, the same on both ends of the link
+    int tx_backoff = 0;        // fine TX power steps below the maximum (dw3000TxPowerBackoff())
+    int tx_backoff_wanted = 0; // steps the link is negotiating
+
+    // Cell wide switches
+    bool cell_confirmed = true; // the anchor confirmed the scheduled switch (or the last one, if none is scheduled)
+    bool cell_try_prev = false; // after the switch: the next announcement goes out on the old cell settings, else on the new ones
+
+    // Receive errors
+    DW3000RxStats rx_stats[TAG_STAGES]; // receives per stage the tag waited in for a frame from the anchor (1, 3, 6, 8), the "rxerr" command
 };
 
 // Dynamic array of anchor data
@@ -195,6 +303,8 @@ void initializeAnchors()
     for (int i = 0; i < NUM_ANCHORS; i++)
     {
         anchors[i].anchor_id = FIRST_ANCHOR_ID + i;
+        anchors[i].phy_level = cell.profile;
+        anchors[i].phy_wanted = cell.profile;
         // Initialize all other fields to zero (default constructor handles this)
     }
 }
@@ -214,6 +324,315 @@ void switchToNextAnchor()
     current_anchor_index = (current_anchor_index + 1) % NUM_ANCHORS;
 }
 
+/*
+ @return First path level of the last range with an anchor as it would have been at full TX power (dBm),
+         so the choice of the PHY does not follow the power control
+*/
+float fullPowerLevel(const AnchorData &data)
+{
+    return data.fp_signal_strength + data.tx_backoff * DW3000_TX_POWER_FINE_STEP_DB;
+}
+
+/*
+ Picks the profile for the next exchange with an anchor from the first path level of the last one
+ @return The wanted profile index, the current one if the link should stay
+*/
+int selectPhyLevel(AnchorData &data)
+{
+    static const float upgrade[DW3000_PHY_PROFILE_COUNT] = PHY_UPGRADE_LEVELS;
+    static const float downgrade[DW3000_PHY_PROFILE_COUNT] = PHY_DOWNGRADE_LEVELS;
+
+    if (!RANGING_ADAPTIVE_PHY)
+    {
+        return data.phy_level;
+    }
+
+    float level = fullPowerLevel(data);
+
+    if (data.phy_level > 0 && level < downgrade[data.phy_level])
+    {
+        data.phy_good = 0;
+        return data.phy_level - 1;
+    }
+
+    if (data.phy_level + 1 < DW3000_PHY_PROFILE_COUNT && level >= upgrade[data.phy_level + 1])
+    {
+        if (++data.phy_good >= PHY_UPGRADE_RANGES)
+        {
+            data.phy_good = 0;
+            return data.phy_level + 1;
+        }
+    }
+    else
+    {
+        data.phy_good = 0;
+    }
+    return data.phy_level;
+}
+
+/*
+ Picks the TX power of a link: as far below the maximum as keeps the first path level at TX_POWER_TARGET_LEVEL.
+ The link is reciprocal, so the anchor's frames tell how strong the tag's arrive at the same power.
+ @return The wanted backoff in fine steps, the current one if the link should stay
+*/
+int selectTxBackoff(const AnchorData &data)
+{
+    if (!RANGING_ADAPTIVE_PHY || !RANGING_TX_POWER_CONTROL)
+    {
+        return data.tx_backoff;
+    }
+
+    float excess = fullPowerLevel(data) - TX_POWER_TARGET_LEVEL;
+    int steps = excess > 0 ? (int)(excess / DW3000_TX_POWER_FINE_STEP_DB) : 0;
+    if (steps > 63)
+    {
+        steps = 63;
+    }
+
+    if (abs(steps - data.tx_backoff) * DW3000_TX_POWER_FINE_STEP_DB < TX_POWER_HYSTERESIS_DB)
+    {
+        return data.tx_backoff;
+    }
+    return steps;
+}
+
+/*
+ Sets the radio to the profile and TX power of a link, if it is not set already
+*/
+void applyLink(const AnchorData &data)
+{
+    if (data.phy_level != phy_level)
+    {
+        dwm.setPhy(dw3000PhyProfile(cell.channel, data.phy_level));
+        phy_level = data.phy_level;
+    }
+    if (data.tx_backoff != tx_backoff)
+    {
+        dwm.setTXPower(dw3000TxPowerBackoff(data.tx_backoff));
+        tx_backoff = data.tx_backoff;
+    }
+}
+
+/*
+ @return Name of the PHY profile the link to an anchor uses
+*/
+const char *phyName(const AnchorData &data)
+{
+    return dw3000PhyProfile(cell.channel, data.phy_level).name;
+}
+
+/*
+ @return Epochs since boot (PROFILE_EPOCH_MS each), the time base of cell wide switches
+*/
+unsigned long currentEpoch()
+{
+    return millis() / PROFILE_EPOCH_MS;
+}
+
+/*
+ Schedules a cell wide switch: every anchor gets told before the epoch starts, then the whole cell switches at once
+ @param channel 5 or 9
+ @param profile Index into DW3000PhyProfiles
+ @param epoch Epoch to switch at, in the future but at most 65 s ahead (the delay in the announcement is 16 bit ms)
+ @return False if the settings or the epoch are out of range
+*/
+bool scheduleCellProfile(int channel, int profile, unsigned long epoch)
+{
+    unsigned long now = millis();
+    if ((channel != 5 && channel != 9) || profile < 0 || profile >= DW3000_PHY_PROFILE_COUNT ||
+        epoch * PROFILE_EPOCH_MS <= now + PROFILE_SWITCH_QUIET_MS || epoch * PROFILE_EPOCH_MS - now > 0xFFFF)
+    {
+        return false;
+    }
+
+    cell_next = {(uint8_t)(channel == 9 ? CHANNEL_9 : CHANNEL_5), profile};
+    cell_switch_epoch = epoch;
+    for (int i = 0; i < NUM_ANCHORS; i++)
+    {
+        anchors[i].cell_confirmed = false;
+        anchors[i].cell_try_prev = false; // the likelier miss is a lost confirmation, the anchor then switched with the cell
+    }
+    return true;
+}
+
+/*
+ Moves the tag to the scheduled cell settings: every link starts over on the profile of the cell at full TX power, like the anchors do
+*/
+void switchCell()
+{
+    cell_prev = cell;
+    cell = cell_next;
+    cell_switch_epoch = 0;
+    cell_switches++;
+
+    for (int i = 0; i < NUM_ANCHORS; i++)
+    {
+        anchors[i].phy_level = cell.profile;
+        anchors[i].phy_wanted = cell.profile;
+        anchors[i].phy_good = 0;
+        anchors[i].tx_backoff = 0;
+        anchors[i].tx_backoff_wanted = 0;
+    }
+    phy_level = -1; // the next applyLink() sets the radio
+    tx_backoff = -1;
+
+    Serial.print(millis());
+    Serial.print(": ");
+    Serial.print("[INFO] Cell switched to channel ");
+    Serial.print(cell.channel == CHANNEL_9 ? 9 : 5);
+    Serial.print(", PHY profile ");
+    Serial.println(dw3000PhyProfile(cell.channel, cell.profile).name);
+}
+
+/*
+ Sleeps the ESP32: light sleep keeps the RAM and the pins, a timer wakes it up. With WiFi in use (or off the ESP32) it only waits,
+ light sleep would drop the connection.
+*/
+void lightSleep(unsigned long ms)
+{
+#ifdef ARDUINO_ARCH_ESP32
+    if (!USEWIFI)
+    {
+        Serial.flush(); // the UART stops in light sleep
+        esp_sleep_enable_timer_wakeup((uint64_t)ms * 1000);
+        esp_light_sleep_start();
+        return;
+    }
+#endif
+    delay(ms);
+}
+
+/*
+ Resets the radio and sets it up for ranging: hard and soft reset, init() with the calibration in dwm.calibration,
+ interrupts, antenna delay, response window and TX configuration. Used by setup() and after a wakeup that lost the configuration.
+ @return False if the radio does not answer on SPI or does not reach IDLE after the hard or the soft reset
+*/
+bool startRadio()
+{
+    dwm.hardReset();
+    dwm.waitForIDLE(200);
+
+    if (!dwm.checkSPI())
+    {
+        Serial.println("[ERROR] Could not establish SPI Connection to DWM3000!");
+        return false;
+    }
+
+    for (int tries = 1; !dwm.checkForIDLE(); tries++)
+    {
+        Serial.println("[ERROR] IDLE1 FAILED\r");
+        if (tries >= RADIO_IDLE_RETRIES)
+        {
+            return false;
+        }
+        delay(1000);
+    }
+
+    dwm.softReset();
+
+    if (!dwm.waitForIDLE(200))
+    {
+        Serial.println("[ERROR] IDLE2 FAILED\r");
+        return false;
+    }
+
+    dwm.init();
+    dwm.setupGPIO();
+    if (irq_events)
+    {
+        dwm.enableInterrupts(&irq); // init() keeps it enabled from now on
+    }
+    dwm.setTXAntennaDelay(16350);
+    dwm.setResponseWindow(RESPONSE_TURNAROUND_MIN_US, RESPONSE_TURNAROUND_MAX_US, RESPONSE_MAX_LEN);
+    dwm.configureAsTX();
+    dwm.clearSystemStatus();
+    return true;
+}
+
+/*
+ Duty cycling: waits for the start of the next slot with the radio in DEEPSLEEP, its configuration kept in the AON memory,
+ and the ESP32 in light sleep, then wakes the radio. A round that ran past the end of its slot starts the next one right away.
+*/
+void sleepUntilNextSlot()
+{
+    unsigned long now = millis();
+    long remaining = (long)(next_slot_ms - now);
+    if (next_slot_ms == 0 || remaining <= 0)
+    {
+        next_slot_ms = now + duty_cycle_ms;
+        return;
+    }
+    next_slot_ms += duty_cycle_ms;
+
+    if (remaining < SLEEP_MIN_MS)
+    {
+        delay(remaining);
+        return;
+    }
+
+    dwm.deepSleep();
+    lightSleep(remaining);
+    slept_ms += remaining;
+
+    wake_start_us = micros();
+    wakeups++;
+    if (!dwm.wakeup() && !startRadio())
+    {
+        Serial.println("[ERROR] Radio restart failed, trying again after the next slot");
+    }
+}
+
+/*
+ Checks for the frame the tag waits for. With irq_events the loop sleeps until the IRQ line rises or the wait is over,
+ and only then reads SYS_STATUS.
+ @param timeoutMs Backstop for the whole wait, counted from sentmillis: the receive timeouts of the radio end it long before
+ @return Like receivedFrameSucc(): 1 if a frame was received; 2 on a receiver error; 3 on a receive timeout, or when the
+         backstop ran out; 0 if nothing happened yet
+*/
+int awaitFrame(unsigned long timeoutMs)
+{
+    int status = 0;
+    if (!irq_events)
+    {
+        status = dwm.receivedFrameSucc();
+    }
+    else
+    {
+        unsigned long waited = millis() - sentmillis;
+        if (irq.wait(waited <= timeoutMs ? timeoutMs - waited + 1 : 0))
+        {
+            status = dw3000FrameStatus(dwm.readEvents());
+        }
+    }
+    if (status == 0 && millis() - sentmillis > timeoutMs)
+    {
+        getCurrentAnchor()->rx_stats[curr_stage].add(3, 0); // the radio never ended the wait
+        return 3;
+    }
+    if (status != 0)
+    {
+        getCurrentAnchor()->rx_stats[curr_stage].add(status, dwm.rxErrors);
+    }
+    return status;
+}
+
+/*
+ Takes the time from the last wakeup to the first frame after it, called once a frame went out
+*/
+void frameSent()
+{
+    if (wake_start_us == 0)
+    {
+        return;
+    }
+    wake_latency_us = micros() - wake_start_us;
+    if (wake_latency_us > wake_latency_max_us)
+    {
+        wake_latency_max_us = wake_latency_us;
+    }
+    wake_start_us = 0;
+}
+
 bool allAnchorsHaveValidData()
 {
     for (int i = 0; i < NUM_ANCHORS; i++)
@@ -287,7 +706,9 @@ void sendData()
         data += "\"fp_rssi\":" + String(anchors[i].fp_signal_strength, 2) + ",";
         data += "\"round_time\":" + String(anchors[i].t_roundA) + ",";
         data += "\"reply_time\":" + String(anchors[i].t_replyA) + ",";
-        data += "\"clock_offset\":" + String((double)dwm.getClockOffset(anchors[i].clock_offset), 6);
+        data += "\"clock_offset\":" + String((double)dwm.getClockOffset(anchors[i].clock_offset), 6) + ",";
+        data += "\"phy\":\"" + String(phyName(anchors[i])) + "\",";
+        data += "\"tx_power\":" + String(-anchors[i].tx_backoff * DW3000_TX_POWER_FINE_STEP_DB, 2);
         data += "}";
 
         // Add comma if not the last anchor
@@ -389,8 +810,9 @@ void printDebugInfo(int anchor, long long rx, long long tx, int t_round, int t_r
     Serial.print("Clock offset: ");
     Serial.println(clock_offset);
 
-    int ranging_time = dwm.ds_processRTInfo(t_round, t_reply,
-                                                dwm.read(0x12, 0x04), dwm.read(0x12, 0x08), clock_offset);
+    int t_roundB, t_replyB;
+    dwm.ds_readRTInfo(&t_roundB, &t_replyB);
+    int ranging_time = dwm.ds_processRTInfo(t_round, t_reply, t_roundB, t_replyB, clock_offset);
     Serial.print("Calculated distance: ");
     Serial.println(dwm.convertToCM(ranging_time));
 }
@@ -453,44 +875,30 @@ void setup()
 
     // Initialize UWB
     dwm.begin();
-    dwm.hardReset();
-    delay(200);
-
-    if (!dwm.checkSPI())
+    if (irq_events)
     {
-        Serial.println("[ERROR] Could not establish SPI Connection to DWM3000!");
-        while (1)
-            ;
-    }
-
-    while (!dwm.checkForIDLE())
-    {
-        Serial.println("[ERROR] IDLE1 FAILED\r");
-        delay(1000);
+        irq.begin(TagBoard::irqPin);
     }
-
-    dwm.softReset();
-    delay(200);
-
-    if (!dwm.checkForIDLE())
+    calibrationStore.load(dwm.calibration);
+    if (RANGING_XTAL_TRIM)
+        dwm.xtalTrim = calibrationStore.loadXtalTrim(); // 0 if there is none, init() then uses the OTP trim
+    if (!startRadio())
     {
-        Serial.println("[ERROR] IDLE2 FAILED\r");
         while (1)
             ;
     }
-
-    dwm.init();
-    dwm.setupGPIO();
-    dwm.setTXAntennaDelay(16350);
+    calibrationStore.store(dwm.calibration, dwm.calibrationFromCache);
+    xtal.begin(dwm.xtalTrim);
 
     Serial.println("> TAG - Three Anchor Ranging System <");
     Serial.println("> With WiFi Communication <\n");
     Serial.println("[INFO] Setup is finished.");
     Serial.print("Antenna delay set to: ");
     Serial.println(dwm.getTXAntennaDelay());
-
-    dwm.configureAsTX();
-    dwm.clearSystemStatus();
+    Serial.print("PHY profile: ");
+    Serial.print(RANGING_ADAPTIVE_PHY ? "adaptive" : TagPhy::name);
+    Serial.print(", channel ");
+    Serial.println(RANGING_CHANNEL);
 
     // diagnostic();
 }
@@ -548,13 +956,106 @@ void handleCommand(const String& cmd) {
         Serial.printf("stage: %d\n", curr_stage);
         client.write((uint8_t*)&value, sizeof(value));
     }
+    else if(action == "phy"){
+        // profile and TX power of every anchor link, the switches and power changes since boot
+        for (int i = 0; i < NUM_ANCHORS; i++) {
+            client.print("A" + String(anchors[i].anchor_id) + " " + phyName(anchors[i]) + " " +
+                         String(-anchors[i].tx_backoff * DW3000_TX_POWER_FINE_STEP_DB, 2) + "dB ");
+        }
+        client.println("switches " + String(phy_switches) + " power " + String(tx_power_changes));
+    }
+    else if(action == "profile"){
+        // "profile <channel> <profile> <epoch>" switches the cell at an epoch, "profile" shows the settings and the current epoch
+        if (firstSpace >= 0) {
+            if (secondSpace < 0 || thirdSpace < 0) {
+                client.println("ERR Invalid format. Use: profile <channel> <profile> <epoch>");
+                return;
+            }
+            String name = cmd.substring(secondSpace + 1, thirdSpace);
+            int profile = name.toInt();
+            for (int i = 0; i < DW3000_PHY_PROFILE_COUNT; i++) {
+                if (name == DW3000PhyProfiles<>::all[i].name) {
+                    profile = i;
+                }
+            }
+            if (!scheduleCellProfile(cmd.substring(firstSpace + 1, secondSpace).toInt(), profile, cmd.substring(thirdSpace + 1).toInt())) {
+                client.println("ERR channel 5 or 9, profile 0 to " + String(DW3000_PHY_PROFILE_COUNT - 1) +
+                               ", epoch after " + String(currentEpoch()) + " and at most 65 s ahead");
+                return;
+            }
+        }
+        client.println("channel " + String(cell.channel == CHANNEL_9 ? 9 : 5) + " " + dw3000PhyProfile(cell.channel, cell.profile).name +
+                       " epoch " + String(currentEpoch()) + (cell_switch_epoch ? " switch at " + String(cell_switch_epoch) : String("")));
+    }
+    else if(action == "sleep"){
+        // "sleep <ms>" duty cycles with that period (0 stays awake), "sleep" shows the period and the wakeup to first frame latency
+        if (firstSpace >= 0) {
+            long period = cmd.substring(firstSpace + 1).toInt();
+            duty_cycle_ms = period > 0 ? period : 0;
+            next_slot_ms = 0;
+        }
+        client.println("period " + String(duty_cycle_ms) + "ms wakeups " + String(wakeups) + " wake to frame " + String(wake_latency_us) +
+                       "us max " + String(wake_latency_max_us) + "us asleep " + String(slept_ms) + "ms");
+    }
+    else if(action == "temp"){
+        // chip temperature of the last sample and the recalibrations it caused
+        client.println(String(dwm.temperature, 1) + "C recalibrations " + String(temperature.recalibrations));
+    }
+    else if(action == "xtal"){
+        // crystal trim, mean clock offset against the anchors of the last window, converged or not
+        client.println("trim " + String(dwm.xtalTrim) + " offset " + String(xtal.offsetPpm(), 2) + "ppm " +
+                       (xtal.converged() ? "converged" : "tuning"));
+    }
+    else if(action == "rxerr"){
+        // "rxerr" sends the outcome of the receives per anchor and stage, why they failed (dw3000_rxerr.h), "rxerr clear" starts over
+        bool clear = firstSpace >= 0 && cmd.substring(firstSpace + 1) == "clear";
+        for (int i = 0; i < NUM_ANCHORS; i++) {
+            for (int stage = 0; stage < TAG_STAGES; stage++) {
+                DW3000RxStats &stats = anchors[i].rx_stats[stage];
+                if (clear) {
+                    stats.clear();
+                } else if (stats.receives) {
+                    client.print("A" + String(anchors[i].anchor_id) + " stage " + String(stage) + " ");
+                    stats.print(client);
+                }
+            }
+        }
+        if (clear) {
+            client.println("rxerr OK");
+        }
+    }
+    else if(action == "trace"){
+        // "trace" sends the last SPI transactions (replay them with host/sim/trace_replay.cpp), "trace clear" starts over
+        if (firstSpace >= 0 && cmd.substring(firstSpace + 1) == "clear") {
+            dwm.trace.clear();
+            client.println("trace OK");
+        } else {
+            dwm.trace.dump(client);
+        }
+    }
+    else if(action == "cir"){
+        // "cir <first sample> <samples>" sends the raw accumulator samples of the last frame, 6 bytes each (18 bit real, 18 bit imaginary)
+        if (firstSpace < 0 || secondSpace < 0) {
+            client.println("ERR Invalid format. Use: cir <first sample> <samples>");
+            return;
+        }
+
+        int first   = cmd.substring(firstSpace + 1, secondSpace).toInt();
+        int samples = cmd.substring(secondSpace + 1).toInt();
+        if (first < 0 || samples <= 0 || samples > CIR_COMMAND_MAX_SAMPLES) {
+            client.println("ERR samples must be 1 to " + String(CIR_COMMAND_MAX_SAMPLES));
+            return;
+        }
+
+        uint8_t cir[1 + CIR_COMMAND_MAX_SAMPLES * DW3000_CIR_SAMPLE_LEN];
+        dwm.readAccumulator(first, samples, cir);
+        client.write(cir + 1, samples * DW3000_CIR_SAMPLE_LEN); // cir[0] is the dummy byte of the accumulator
+    }
     else {
         client.println("ERR Unknown command");
     }
 }
 
-unsigned long sentmillis = 0;
-
 void loop()
 {
     AnchorData *currentAnchor = getCurrentAnchor();
@@ -581,18 +1082,51 @@ void loop()
     switch (curr_stage)
     {
     case 0: // Start ranging with current target
+        if (duty_cycle_ms != 0 && current_anchor_index == 0)
+        {
+            sleepUntilNextSlot(); // one round with every anchor per slot
+        }
+        if (cell_switch_epoch != 0)
+        {
+            long remaining = (long)(cell_switch_epoch * PROFILE_EPOCH_MS - millis());
+            if (remaining < PROFILE_SWITCH_QUIET_MS)
+            {
+                // no exchange may straddle the switch, wait for it
+                if (remaining > 0)
+                    delay(remaining);
+                switchCell();
+                delay(PROFILE_SWITCH_SETTLE_MS);
+            }
+        }
+        if (!currentAnchor->cell_confirmed)
+        {
+            curr_stage = 7;
+            break;
+        }
+
         // Reset timing measurements for current anchor
         currentAnchor->t_roundA = 0;
         currentAnchor->t_replyA = 0;
+        if (RANGING_TEMP_MONITOR && temperature.service(dwm)) // between two exchanges, the frame below turns the transmitter on again
+        {
+            Serial.print(millis());
+            Serial.print(": ");
+            Serial.print("[INFO] Recalibrated at ");
+            Serial.print(dwm.temperature);
+            Serial.println(" C");
+            dwm.clearSystemStatus();
+        }
+        applyLink(*currentAnchor);
 
         dwm.ds_sendFrame(1, TAG_ID, currentAnchorId);
+        frameSent();
         currentAnchor->tx = dwm.readTXTimestamp();
         curr_stage = 1;
         sentmillis = millis();
         break;
 
     case 1: // Await first response
-        if (rx_status = dwm.receivedFrameSucc())
+        if (rx_status = awaitFrame(RESPONSE_BACKSTOP_MS))
         {
             dwm.clearSystemStatus();
             if (rx_status == 1)
@@ -622,6 +1156,18 @@ void loop()
                     curr_stage = 2;
                 }
             }
+            else if (rx_status == 3)
+            {
+                curr_stage = 0;
+                Serial.println("RX timeout");
+                if (currentAnchor->phy_level != cell.profile || currentAnchor->tx_backoff > 0)
+                {
+                    // the anchor lost the link (or the switch) and went back to the profile of the cell at full power after ANCHOR_PHY_FALLBACK_MS
+                    currentAnchor->phy_level = cell.profile;
+                    currentAnchor->phy_good = 0;
+                    currentAnchor->tx_backoff = 0;
+                }
+            }
             else
             {
                 Serial.print(millis());
@@ -631,12 +1177,6 @@ void loop()
                 dwm.clearSystemStatus();
                 curr_stage = 0;
             }
-        }else{
-            if(millis() - sentmillis > 500){
-                dwm.clearSystemStatus();
-                curr_stage = 0;
-                Serial.println("RX timeout");
-            }
         }
         break;
 
@@ -653,7 +1193,7 @@ void loop()
         break;
 
     case 3: // Await second response
-        if (rx_status = dwm.receivedFrameSucc())
+        if (rx_status = awaitFrame(RESPONSE_BACKSTOP_MS))
         {
             dwm.clearSystemStatus();
             if (rx_status == 1)
@@ -670,6 +1210,13 @@ void loop()
                     curr_stage = 4;
                 }
             }
+            else if (rx_status == 3)
+            {
+                curr_stage = 0;
+                Serial.print(millis());
+                Serial.print(": ");
+                Serial.println("RX timeout");
+            }
             else
             {
                 Serial.print(millis());
@@ -679,30 +1226,43 @@ void loop()
                 dwm.clearSystemStatus();
                 curr_stage = 0;
             }
-        }else{
-            if(millis() - sentmillis > 100){
-                dwm.clearSystemStatus();
-                curr_stage = 0;
-                Serial.print(millis());
-                Serial.print(": ");
-                Serial.println("RX timeout");
-            }
         }
         break;
 
     case 4: // Response received. Calculating results
     {
+        int t_roundB, t_replyB;
+        dwm.ds_readRTInfo(&t_roundB, &t_replyB); // reading receive buffer
+
         int ranging_time = dwm.ds_processRTInfo(
             currentAnchor->t_roundA,
             currentAnchor->t_replyA,
-            dwm.read(0x12, 0x04), // reading receive buffer
-            dwm.read(0x12, 0x08),
+            t_roundB,
+            t_replyB,
             currentAnchor->clock_offset); // time of flight in clock pulses
 
         currentAnchor->distance = dwm.convertToCM(ranging_time);
         currentAnchor->signal_strength = dwm.getSignalStrength();
         currentAnchor->fp_signal_strength = dwm.getFirstPathSignalStrength();
         updateFilteredDistance(*currentAnchor);
+
+        if (first_range_ms == 0)
+        {
+            first_range_ms = millis();
+            Serial.print("[INFO] Boot to first range: ");
+            Serial.print(first_range_ms);
+            Serial.println(" ms");
+        }
+
+        if (RANGING_XTAL_TRIM && xtal.add(dwm.getClockOffset(currentAnchor->clock_offset) * 1000000))
+        {
+            dwm.setXtalTrim(xtal.trim());
+        }
+        if (RANGING_XTAL_TRIM && !xtal_stored && xtal.converged())
+        {
+            calibrationStore.storeXtalTrim(xtal.trim());
+            xtal_stored = true;
+        }
     }
 
         // Print current distances
@@ -714,11 +1274,115 @@ void loop()
             sendData();
         }
 
+        currentAnchor->phy_wanted = selectPhyLevel(*currentAnchor);
+        currentAnchor->tx_backoff_wanted = selectTxBackoff(*currentAnchor);
+        if (currentAnchor->phy_wanted != currentAnchor->phy_level || currentAnchor->tx_backoff_wanted != currentAnchor->tx_backoff)
+        {
+            curr_stage = 5;
+            break;
+        }
+
         // Switch to next anchor
         switchToNextAnchor();
         curr_stage = 0;
         break;
 
+    case 5: // Ask the anchor to switch the link to another profile or TX power
+        dwm.ds_sendPhyFrame(5, currentAnchor->phy_wanted, currentAnchor->tx_backoff_wanted, TAG_ID, currentAnchorId);
+        sentmillis = millis();
+        curr_stage = 6;
+        break;
+
+    case 6: // Await the confirmation, the anchor switches after sending it
+        if (rx_status = awaitFrame(RESPONSE_BACKSTOP_MS))
+        {
+            dwm.clearSystemStatus();
+            bool confirmed = false;
+            if (rx_status == 1 && dwm.ds_getStage() == 6)
+            {
+                int profile, backoff;
+                dwm.ds_readPhyFrame(&profile, &backoff);
+                confirmed = profile == currentAnchor->phy_wanted && backoff == currentAnchor->tx_backoff_wanted;
+            }
+            if (confirmed)
+            {
+                phy_switches += currentAnchor->phy_wanted != currentAnchor->phy_level;
+                tx_power_changes += currentAnchor->tx_backoff_wanted != currentAnchor->tx_backoff;
+                currentAnchor->phy_level = currentAnchor->phy_wanted;
+                currentAnchor->tx_backoff = currentAnchor->tx_backoff_wanted;
+                Serial.print(millis());
+                Serial.print(": ");
+                Serial.print("[INFO] Anchor ");
+                Serial.print(currentAnchorId);
+                Serial.print(" switched to PHY profile ");
+                Serial.print(phyName(*currentAnchor));
+                Serial.print(", TX power ");
+                Serial.print(-currentAnchor->tx_backoff * DW3000_TX_POWER_FINE_STEP_DB);
+                Serial.println(" dB");
+                delay(PHY_SWITCH_GUARD_MS);
+            }
+            // without a confirmation the link stays on the current profile and gets asked again after the next range
+            switchToNextAnchor();
+            curr_stage = 0;
+        }
+        break;
+
+    case 7: // Announce the scheduled cell settings to the anchor, or the ones it missed (then it switches right away)
+    {
+        bool scheduled = cell_switch_epoch != 0;
+        if (scheduled || !currentAnchor->cell_try_prev)
+        {
+            // before the switch the anchor listens on the settings of the link; after it, the anchor may have switched
+            // with the cell and only its confirmation got lost, then it answers here on the cell profile
+            applyLink(*currentAnchor);
+        }
+        else
+        {
+            // or it missed the announcement and fell back to the profile of the old cell settings at full power
+            dwm.setPhy(dw3000PhyProfile(cell_prev.channel, cell_prev.profile));
+            dwm.setTXPower(DW3000_TX_POWER_MAX);
+            phy_level = -1;
+            tx_backoff = -1;
+        }
+        if (!scheduled)
+        {
+            currentAnchor->cell_try_prev = !currentAnchor->cell_try_prev; // the two settings take turns until it answers
+        }
+        const CellProfile &target = scheduled ? cell_next : cell;
+        long delayMs = scheduled ? (long)(cell_switch_epoch * PROFILE_EPOCH_MS - millis()) : 0;
+        dwm.ds_sendProfileFrame(7, target.channel, target.profile, delayMs > 0 ? delayMs : 0, TAG_ID, currentAnchorId);
+        frameSent();
+        sentmillis = millis();
+        curr_stage = 8;
+        break;
+    }
+
+    case 8: // Await the confirmation of the cell settings
+        if (rx_status = awaitFrame(RESPONSE_BACKSTOP_MS))
+        {
+            dwm.clearSystemStatus();
+            const CellProfile &target = cell_switch_epoch != 0 ? cell_next : cell;
+            if (rx_status == 1 && dwm.ds_getStage() == 7)
+            {
+                int channel, profile, delayMs;
+                dwm.ds_readProfileFrame(&channel, &profile, &delayMs);
+                currentAnchor->cell_confirmed = channel == target.channel && profile == target.profile;
+            }
+            if (currentAnchor->cell_confirmed)
+            {
+                Serial.print(millis());
+                Serial.print(": ");
+                Serial.print("[INFO] Anchor ");
+                Serial.print(currentAnchorId);
+                Serial.println(cell_switch_epoch != 0 ? " confirmed the cell switch" : " caught up with the cell switch");
+                delay(PHY_SWITCH_GUARD_MS);
+            }
+            // an anchor that did not confirm gets asked again on its next turn
+            switchToNextAnchor();
+            curr_stage = 0;
+        }
+        break;
+
     default:
         Serial.print("Entered stage (");
         Serial.print(curr_stage);